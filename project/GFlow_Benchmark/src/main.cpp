@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "context.hpp"
+#include "obj_benchmark.hpp"
+#include "parser_benchmark.hpp"
+#include "recording_benchmark.hpp"
+#include "utils/logger.hpp"
+
+// Usage: GFlow_Benchmark <project file> [frames] [max threads]
+//        GFlow_Benchmark <model.obj> [iterations] [max threads]
+//        GFlow_Benchmark --parser [resources] [iterations] [results.json] [baseline.json]
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        Logger::print(Logger::ERR, "Usage: GFlow_Benchmark <project file> [frames] [max threads]");
+        Logger::print(Logger::ERR, "       GFlow_Benchmark <model.obj> [iterations] [max threads]");
+        Logger::print(Logger::ERR, "       GFlow_Benchmark --parser [resources] [iterations] [results.json] [baseline.json]");
+        return 1;
+    }
+
+    const std::string path = argv[1];
+
+    // Synthetic workspace, no Vulkan needed either. Fails if an operation regressed against the baseline
+    if (path == "--parser")
+    {
+        ParserBenchmark::Workspace workspace{};
+        if (argc > 2) workspace.resources = static_cast<uint32_t>(std::stoul(argv[2]));
+        const uint32_t iterations = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 5;
+
+        std::vector<ParserBenchmark::Result> results = ParserBenchmark::run(workspace, iterations);
+        const bool passed = argc <= 5 || ParserBenchmark::compare(results, argv[5], workspace, 0.1);
+        ParserBenchmark::print(results);
+        if (argc > 4)
+            ParserBenchmark::writeJson(argv[4], workspace, iterations, results);
+        return passed ? 0 : 1;
+    }
+
+    const uint32_t maxThreads = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : std::max(std::thread::hardware_concurrency(), 1U);
+
+    // Models only exercise the parser, no Vulkan needed
+    if (std::filesystem::path(path).extension() == ".obj")
+    {
+        const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 5;
+        ObjBenchmark::print(ObjBenchmark::run(path, iterations, maxThreads));
+        return 0;
+    }
+
+    const uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 200;
+
+    std::vector<const char*> instanceExtensions{};
+    gflow::Context::initVulkan(instanceExtensions);
+
+    const std::vector<RecordingBenchmark::Result> results = RecordingBenchmark::run(path, { 1920, 1080 }, frames, maxThreads);
+    RecordingBenchmark::print(results);
+
+    gflow::Context::destroy();
+    return 0;
+}
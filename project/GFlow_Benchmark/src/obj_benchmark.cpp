@@ -0,0 +1,71 @@
+#include "obj_benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <limits>
+
+#include "mesh_cooker.hpp"
+#include "obj_parser.hpp"
+#include "utils/logger.hpp"
+
+static ObjBenchmark::Result measure(const std::string& loader, const uint32_t threads, const uint32_t iterations, const double megabytes,
+    const std::function<gflow::parser::MeshCooker::Geometry()>& load, gflow::parser::MeshCooker::Geometry& geometry)
+{
+    ObjBenchmark::Result result{ loader, threads };
+    result.minMs = std::numeric_limits<double>::max();
+
+    double totalMs = 0.0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        geometry = load();
+        const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        totalMs += elapsedMs;
+        result.minMs = std::min(result.minMs, elapsedMs);
+    }
+    result.averageMs = iterations > 0 ? totalMs / iterations : 0.0;
+    result.megabytesPerSecond = result.averageMs > 0.0 ? megabytes / (result.averageMs / 1000.0) : 0.0;
+    return result;
+}
+
+std::vector<ObjBenchmark::Result> ObjBenchmark::run(const std::string& modelPath, const uint32_t iterations, const uint32_t maxThreads)
+{
+    const double megabytes = static_cast<double>(std::filesystem::file_size(modelPath)) / (1024.0 * 1024.0);
+
+    // One untimed load so that neither loader pays for the file coming from disk
+    (void)gflow::parser::ObjParser::parse(modelPath);
+
+    std::vector<Result> results{};
+    gflow::parser::MeshCooker::Geometry reference{};
+    results.push_back(measure("tinyobjloader", 0, iterations, megabytes, [&]() { return gflow::parser::MeshCooker::loadObj(modelPath); }, reference));
+
+    std::vector<uint32_t> threadCounts{};
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(std::max(maxThreads, 1U));
+
+    for (const uint32_t threads : threadCounts)
+    {
+        gflow::parser::MeshCooker::Geometry geometry{};
+        Result& result = results.emplace_back(measure("ObjParser", threads, iterations, megabytes, [&]() { return gflow::parser::ObjParser::parse(modelPath, threads); }, geometry));
+        result.speedup = result.averageMs > 0.0 ? results.front().averageMs / result.averageMs : 1.0;
+
+        // Polygons may be triangulated differently, the attribute lists have to match exactly
+        if (geometry.positions.size() != reference.positions.size() || geometry.normals.size() != reference.normals.size()
+            || geometry.texcoords.size() != reference.texcoords.size())
+            Logger::print(Logger::ERR, "ObjParser with ", threads, " threads read different attributes than tinyobjloader");
+        if (geometry.corners.size() != reference.corners.size())
+            Logger::print(Logger::WARN, "ObjParser with ", threads, " threads produced ", geometry.corners.size() / 3, " triangles, tinyobjloader ", reference.corners.size() / 3);
+    }
+    return results;
+}
+
+void ObjBenchmark::print(const std::vector<Result>& results)
+{
+    std::printf("%14s %8s %12s %12s %10s %10s\n", "loader", "threads", "avg (ms)", "min (ms)", "MB/s", "speedup");
+    for (const Result& result : results)
+        std::printf("%14s %8u %12.2f %12.2f %10.1f %9.2fx\n", result.loader.c_str(), result.threads, result.averageMs, result.minMs, result.megabytesPerSecond, result.speedup);
+}
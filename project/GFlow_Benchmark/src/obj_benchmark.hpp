@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class ObjBenchmark
+{
+public:
+    struct Result
+    {
+        std::string loader{};
+        // 0 for the single threaded tinyobjloader path
+        uint32_t threads = 0;
+        double averageMs = 0.0;
+        double minMs = 0.0;
+        double megabytesPerSecond = 0.0;
+        // Against tinyobjloader
+        double speedup = 1.0;
+    };
+
+    // Loads the model with tinyobjloader, then with ObjParser on 1, 2, 4... up to maxThreads threads. Every run has
+    // to produce the same amount of geometry, a mismatch is reported as an error
+    static std::vector<Result> run(const std::string& modelPath, uint32_t iterations, uint32_t maxThreads);
+    static void print(const std::vector<Result>& results);
+};
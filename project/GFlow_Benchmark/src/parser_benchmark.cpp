@@ -0,0 +1,404 @@
+#include "parser_benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+
+#include "resource_manager.hpp"
+#include "resources/connection_list.hpp"
+#include "resources/list.hpp"
+#include "resources/pair.hpp"
+#include "resources/pipeline.hpp"
+#include "resources/renderpass.hpp"
+#include "utils/logger.hpp"
+
+// Level of the nested tree under a data resource, each one holds a few pairs and the next level
+class BenchmarkNest final : public gflow::parser::Resource
+{
+    EXPORT(std::string, name);
+    EXPORT_RESOURCE_LIST(gflow::parser::StringPair, properties);
+    EXPORT_RESOURCE_LIST(BenchmarkNest, children);
+
+public:
+    void fill(const uint32_t depth, const uint32_t seed)
+    {
+        *name = "level_" + std::to_string(depth);
+        for (uint32_t i = 0; i < 3; ++i)
+            (*(*properties).emplace_back())->setValues("key_" + std::to_string(i), std::to_string(seed + i));
+        if (depth > 1)
+            (*(*children).emplace_back())->fill(depth - 1, seed + 1);
+    }
+
+    DECLARE_PRIVATE_RESOURCE(BenchmarkNest)
+
+    template <typename T>
+    friend class gflow::parser::List;
+};
+
+class BenchmarkData final : public gflow::parser::Resource
+{
+    EXPORT(std::string, label);
+    EXPORT_LIST(gflow::parser::Mat4, transforms);
+    EXPORT_RESOURCE(BenchmarkNest, root, true, false);
+
+public:
+    void fill(const uint32_t index, const uint32_t matrices, const uint32_t depth)
+    {
+        *label = "data_" + std::to_string(index);
+        for (uint32_t i = 0; i < matrices; ++i)
+        {
+            gflow::parser::Mat4 matrix{};
+            for (uint32_t j = 0; j < 16; ++j)
+                matrix.data[j] = static_cast<float>(index + i + j) * 0.25f;
+            (*transforms).push_back(matrix);
+        }
+        (*root)->fill(depth, index);
+    }
+
+    DECLARE_PUBLIC_RESOURCE(BenchmarkData)
+};
+
+// Stand-in for the editor's NodeResource, which can't be linked here since its nodes need ImNodeFlow. The connections
+// are the editor's own, GraphResource keeps them in the same list and edits them through the same index
+class BenchmarkNode final : public gflow::parser::Resource
+{
+    EXPORT(size_t, nodeID);
+    EXPORT(gflow::parser::Vec2, position);
+
+public:
+    [[nodiscard]] size_t getNodeID() const { return *nodeID; }
+    void setNodeID(const size_t id) { *nodeID = id; }
+
+    DECLARE_PRIVATE_RESOURCE(BenchmarkNode)
+
+    template <typename T>
+    friend class gflow::parser::List;
+};
+
+class BenchmarkGraph final : public gflow::parser::Resource
+{
+    EXPORT_RESOURCE_LIST(BenchmarkNode, nodes);
+    EXPORT_RESOURCE_LIST(gflow::parser::Connection, connections);
+
+public:
+    void addNode(const size_t id, const gflow::parser::Vec2& position)
+    {
+        BenchmarkNode* node = *(*nodes).emplace_back();
+        node->setNodeID(id);
+        node->set("position", position.toString());
+    }
+
+    void removeNode(const size_t id)
+    {
+        for (int i = 0; i < (*nodes).size(); i++)
+        {
+            if ((*nodes)[i]->getNodeID() == id)
+            {
+                (*nodes).remove(i);
+                break;
+            }
+        }
+        m_connectionIndex.removeNode(*connections, id);
+    }
+
+    void addConnection(const size_t left_uid, const size_t left_pin, const size_t right_uid, const size_t right_pin)
+    {
+        m_connectionIndex.add(*connections, { left_uid, left_pin, right_uid, right_pin });
+    }
+
+    DECLARE_PUBLIC_RESOURCE(BenchmarkGraph)
+
+private:
+    gflow::parser::ConnectionIndex m_connectionIndex{};
+};
+
+// Differences below this are timer noise on the small operations, they never count as a regression
+static constexpr double c_noiseMs = 0.1;
+
+static const std::vector<std::string> c_resourceTypes{ "RenderPass", "Pipeline", "BenchmarkGraph", "BenchmarkData" };
+
+// 16 resources per folder and 8 folders per group, so the file tree gets both wide and deep
+static std::string getResourcePath(const uint32_t index, const std::string& type)
+{
+    return "group_" + std::to_string(index / 128) + "/folder_" + std::to_string(index / 16 % 8) + "/" + type + "_" + std::to_string(index) + ".res";
+}
+
+static void fillGraph(BenchmarkGraph* graph, const uint32_t nodes)
+{
+    for (uint32_t i = 0; i < nodes; ++i)
+        graph->addNode(i, { static_cast<float>(i % 16) * 200.0f, static_cast<float>(i / 16) * 150.0f });
+    for (uint32_t i = 1; i < nodes; ++i)
+        graph->addConnection(i - 1, 0, i, 1);
+}
+
+static ParserBenchmark::Result measure(const std::string& operation, const uint32_t iterations, const uint64_t items,
+    const std::function<void()>& prepare, const std::function<void()>& run)
+{
+    ParserBenchmark::Result result{ operation, iterations, items };
+    result.minMs = std::numeric_limits<double>::max();
+
+    double totalMs = 0.0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        if (prepare) prepare();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        run();
+        const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        totalMs += elapsedMs;
+        result.minMs = std::min(result.minMs, elapsedMs);
+    }
+    result.averageMs = iterations > 0 ? totalMs / iterations : 0.0;
+    if (iterations == 0) result.minMs = 0.0;
+    return result;
+}
+
+void ParserBenchmark::generate(const std::string& directory, const Workspace& workspace)
+{
+    using namespace gflow::parser;
+
+    std::filesystem::create_directories(directory);
+    ResourceManager::resetWorkingDir(directory);
+
+    std::vector<Pipeline*> pipelines{};
+    for (uint32_t i = 0; i < workspace.resources; ++i)
+    {
+        const uint32_t kind = i % 10;
+        const std::string& type = c_resourceTypes[kind == 0 ? 0 : kind <= 2 ? 1 : kind == 3 ? 2 : 3];
+        const std::string path = getResourcePath(i, type);
+        std::filesystem::create_directories(std::filesystem::path(ResourceManager::makePathAbsolute(path)).parent_path());
+
+        if (kind == 0)
+        {
+            RenderPass* renderpass = ResourceManager::createResource<RenderPass>(path);
+            List<ImageAttachment*>* attachments = renderpass->getValue<List<ImageAttachment*>*>("attachments");
+            for (uint32_t subpassIndex = 0; subpassIndex < 4; ++subpassIndex)
+            {
+                const std::string imageID = "color_" + std::to_string(subpassIndex);
+                (*attachments->emplace_back())->set("imageID", imageID);
+
+                RenderPassSubpass* subpass = renderpass->addSubpass();
+                subpass->addAttachment(imageID, SubpassAttachment::COLOR);
+                // References go to pipelines written before, loading a render pass pulls them in
+                for (uint32_t pipeline = 0; pipeline < 4 && pipeline < pipelines.size(); ++pipeline)
+                    subpass->addPipeline()->setPipeline(pipelines[pipelines.size() - 1 - (subpassIndex * 4 + pipeline) % pipelines.size()]);
+            }
+        }
+        else if (kind <= 2)
+        {
+            // Shader paths stay empty, compiling them would dominate every load
+            Pipeline* pipeline = ResourceManager::createResource<Pipeline>(path);
+            List<PipelineColorBlendAttachment*>* attachments = pipeline->getValue<PipelineColorBlendState*>("colorBlendState")
+                ->getValue<List<PipelineColorBlendAttachment*>*>("colorBlendAttachments");
+            for (uint32_t attachment = 0; attachment < 2; ++attachment)
+                (*attachments->emplace_back())->set("blendEnable", std::to_string(attachment % 2));
+            pipelines.push_back(pipeline);
+        }
+        else if (kind == 3)
+            fillGraph(ResourceManager::createResource<BenchmarkGraph>(path), workspace.graphNodes);
+        else
+            ResourceManager::createResource<BenchmarkData>(path)->fill(i, i % 64 == 4 ? workspace.largeMatrices : workspace.matrices, workspace.nestingDepth);
+    }
+    ResourceManager::saveAll();
+}
+
+std::vector<ParserBenchmark::Result> ParserBenchmark::run(const Workspace& workspace, const uint32_t iterations)
+{
+    using namespace gflow::parser;
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "gflow_parser_benchmark";
+    const std::string directory = (root / "workspace").generic_string();
+    const std::string hidden = (root / "hidden").generic_string();
+    std::filesystem::remove_all(root);
+
+    std::vector<Result> results{};
+    results.push_back(measure("generate", 1, workspace.resources, {}, [&]() { generate(directory, workspace); }));
+
+    std::vector<std::string> paths{};
+    std::set<std::string> directories{};
+    for (const std::string& path : ResourceManager::getTree().getOrderedPaths())
+    {
+        if (path.back() == '/')
+            directories.insert(path);
+        else if (ResourceManager::hasResource(path))
+            paths.push_back(path);
+    }
+    if (paths.size() != workspace.resources)
+        Logger::print(Logger::ERR, "Generated ", paths.size(), " resources out of ", workspace.resources);
+
+    results.push_back(measure("resetWorkingDir", iterations, paths.size(), {}, [&]() { ResourceManager::resetWorkingDir(directory); }));
+    uint64_t loaded = 0;
+    for (const std::string& path : paths)
+        loaded += ResourceManager::hasResource(path) ? 1 : 0;
+    if (loaded != paths.size())
+        Logger::print(Logger::ERR, "resetWorkingDir loaded ", loaded, " resources out of ", paths.size());
+
+    // The files are moved out while resetting so nothing is loaded, then every resource is loaded by hand
+    results.push_back(measure("loadResource", iterations, paths.size(), [&]()
+        {
+            std::filesystem::rename(directory, hidden);
+            std::filesystem::create_directory(directory);
+            ResourceManager::resetWorkingDir(directory);
+            std::filesystem::remove(directory);
+            std::filesystem::rename(hidden, directory);
+        }, [&]()
+        {
+            for (const std::string& path : paths)
+                ResourceManager::loadResource(path);
+        }));
+
+    results.push_back(measure("saveAll", iterations, paths.size(), {}, []() { ResourceManager::saveAll(); }));
+
+    uint64_t found = 0;
+    results.push_back(measure("getResourcePaths", iterations, c_resourceTypes.size(), [&]() { found = 0; }, [&]()
+        {
+            for (const std::string& type : c_resourceTypes)
+                found += ResourceManager::getResourcePaths(type).size();
+        }));
+    if (found != paths.size())
+        Logger::print(Logger::ERR, "getResourcePaths found ", found, " resources out of ", paths.size());
+
+    FileTree tree{ "root" };
+    const std::function<void()> fillTree = [&]()
+        {
+            tree.reset();
+            for (const std::string& path : paths)
+                tree.addPath(path);
+        };
+    results.push_back(measure("FileTree::addPath", iterations, paths.size(), [&]() { tree.reset(); }, [&]()
+        {
+            for (const std::string& path : paths)
+                tree.addPath(path);
+        }));
+    std::vector<std::string> ordered{};
+    results.push_back(measure("FileTree::getOrderedPaths", iterations, paths.size(), {}, [&]() { ordered = tree.getOrderedPaths(); }));
+    // Every directory is renamed and then given its name back
+    results.push_back(measure("FileTree::renamePath", iterations, directories.size() * 2, {}, [&]()
+        {
+            for (const std::string& path : directories)
+            {
+                const size_t nameStart = path.rfind('/', path.size() - 2) + 1;
+                const std::string name = path.substr(nameStart, path.size() - nameStart - 1);
+                tree.renamePath(path, name + "_renamed");
+                tree.renamePath(path.substr(0, nameStart) + name + "_renamed/", name);
+            }
+        }));
+    results.push_back(measure("FileTree::removePath", iterations, paths.size(), fillTree, [&]()
+        {
+            for (const std::string& path : paths)
+                tree.removePath(path);
+        }));
+
+    // Nodes are added, chained, the chain is connected again to hit the duplicate check and half the nodes removed
+    const uint32_t nodes = std::max(workspace.graphNodes, 2U);
+    BenchmarkGraph* graph = nullptr;
+    results.push_back(measure("GraphResource edits", iterations, nodes + (nodes - 1) * 2 + nodes / 2, [&]()
+        {
+            if (graph != nullptr) ResourceManager::deleteResource(graph);
+            graph = ResourceManager::createResource<BenchmarkGraph>("");
+        }, [&]()
+        {
+            fillGraph(graph, nodes);
+            for (uint32_t i = 1; i < nodes; ++i)
+                graph->addConnection(i - 1, 0, i, 1);
+            for (uint32_t i = 0; i < nodes; i += 2)
+                graph->removeNode(i);
+        }));
+    if (graph != nullptr) ResourceManager::deleteResource(graph);
+
+    // Frees every resource before the files go away
+    std::filesystem::create_directory(root / "empty");
+    ResourceManager::resetWorkingDir((root / "empty").generic_string());
+    std::filesystem::remove_all(root);
+    return results;
+}
+
+void ParserBenchmark::print(const std::vector<Result>& results)
+{
+    std::printf("%26s %10s %12s %12s %12s %9s\n", "operation", "items", "avg (ms)", "min (ms)", "base (ms)", "vs base");
+    for (const Result& result : results)
+    {
+        if (result.baselineMs > 0.0)
+            std::printf("%26s %10llu %12.2f %12.2f %12.2f %8.2fx\n", result.operation.c_str(), static_cast<unsigned long long>(result.items), result.averageMs,
+                result.minMs, result.baselineMs, result.averageMs / result.baselineMs);
+        else
+            std::printf("%26s %10llu %12.2f %12.2f %12s %9s\n", result.operation.c_str(), static_cast<unsigned long long>(result.items), result.averageMs,
+                result.minMs, "-", "-");
+    }
+}
+
+bool ParserBenchmark::writeJson(const std::string& path, const Workspace& workspace, const uint32_t iterations, const std::vector<Result>& results)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+    {
+        Logger::print(Logger::ERR, "Could not write benchmark results to ", path);
+        return false;
+    }
+
+    file << "{\n  \"workspace\": { \"resources\": " << workspace.resources << ", \"nestingDepth\": " << workspace.nestingDepth
+        << ", \"matrices\": " << workspace.matrices << ", \"largeMatrices\": " << workspace.largeMatrices << ", \"graphNodes\": " << workspace.graphNodes
+        << " },\n  \"iterations\": " << iterations << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        file << "    { \"operation\": \"" << result.operation << "\", \"items\": " << result.items << ", \"averageMs\": " << result.averageMs
+            << ", \"minMs\": " << result.minMs << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return true;
+}
+
+// Value of a key in a line written by writeJson, empty if the line doesn't have it
+static std::string readJsonValue(const std::string& line, const std::string& key)
+{
+    const size_t keyStart = line.find("\"" + key + "\":");
+    if (keyStart == std::string::npos) return "";
+    size_t start = line.find_first_not_of(' ', keyStart + key.size() + 3);
+    if (start == std::string::npos) return "";
+    if (line[start] == '"')
+        return line.substr(start + 1, line.find('"', start + 1) - start - 1);
+    return line.substr(start, line.find_first_of(",} ", start) - start);
+}
+
+bool ParserBenchmark::compare(std::vector<Result>& results, const std::string& baselinePath, const Workspace& workspace, const double tolerance)
+{
+    std::ifstream file(baselinePath);
+    if (!file.is_open())
+    {
+        Logger::print(Logger::ERR, "Could not open benchmark baseline ", baselinePath);
+        return false;
+    }
+
+    std::map<std::string, double> baseline{};
+    for (std::string line; std::getline(file, line);)
+    {
+        const std::string resources = readJsonValue(line, "resources");
+        if (!resources.empty() && std::stoul(resources) != workspace.resources)
+            Logger::print(Logger::WARN, "Baseline was measured on ", resources, " resources, this run used ", workspace.resources);
+
+        const std::string operation = readJsonValue(line, "operation");
+        const std::string averageMs = readJsonValue(line, "averageMs");
+        if (!operation.empty() && !averageMs.empty())
+            baseline[operation] = std::stod(averageMs);
+    }
+
+    bool passed = true;
+    for (Result& result : results)
+    {
+        const auto it = baseline.find(result.operation);
+        if (it == baseline.end()) continue;
+        result.baselineMs = it->second;
+        if (result.averageMs > result.baselineMs * (1.0 + tolerance) && result.averageMs - result.baselineMs > c_noiseMs)
+        {
+            Logger::print(Logger::WARN, result.operation, " regressed: ", result.averageMs, " ms against ", result.baselineMs, " ms in the baseline");
+            passed = false;
+        }
+    }
+    return passed;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class ParserBenchmark
+{
+public:
+    // Shape of the synthetic workspace. A tenth of the resources are render passes, a fifth pipelines, a tenth
+    // graphs and the rest data resources holding a Mat4 list and a nested List/Pair tree
+    struct Workspace
+    {
+        uint32_t resources = 1000;
+        // Levels of nested lists under every data resource
+        uint32_t nestingDepth = 8;
+        uint32_t matrices = 16;
+        // One data resource in 64 gets this many matrices instead
+        uint32_t largeMatrices = 1024;
+        uint32_t graphNodes = 128;
+    };
+
+    struct Result
+    {
+        std::string operation{};
+        uint32_t iterations = 0;
+        // Resources, paths or edits a single iteration goes through
+        uint64_t items = 0;
+        double averageMs = 0.0;
+        double minMs = 0.0;
+        // Average of the same operation in the baseline, 0 if the baseline doesn't have it
+        double baselineMs = 0.0;
+    };
+
+    // Writes the workspace into an empty directory through the ResourceManager, which is left pointing at it
+    static void generate(const std::string& directory, const Workspace& workspace);
+
+    // Generates the workspace in the temporary directory and times every parser operation on it. The directory is
+    // removed afterwards
+    static std::vector<Result> run(const Workspace& workspace, uint32_t iterations);
+    static void print(const std::vector<Result>& results);
+
+    static bool writeJson(const std::string& path, const Workspace& workspace, uint32_t iterations, const std::vector<Result>& results);
+    // Fills baselineMs from a file written by writeJson. Returns false if an operation got slower than the baseline
+    // by more than the tolerance, 0.1 being 10%, and by more than 0.1 ms
+    static bool compare(std::vector<Result>& results, const std::string& baselinePath, const Workspace& workspace, double tolerance);
+};
@@ -0,0 +1,62 @@
+#include "recording_benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#include "context.hpp"
+
+std::vector<RecordingBenchmark::Result> RecordingBenchmark::run(const std::string& projectPath, const VkExtent2D extent, const uint32_t frames, const uint32_t maxThreads)
+{
+    const uint32_t environmentID = gflow::Context::createEnvironment();
+    gflow::Environment& environment = gflow::Context::getEnvironment(environmentID);
+    const uint32_t project = environment.loadProject(projectPath);
+    environment.build();
+    environment.setRenderExtent(extent);
+
+    std::vector<uint32_t> threadCounts{};
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(std::max(maxThreads, 1U));
+
+    std::vector<Result> results{};
+    for (const uint32_t threads : threadCounts)
+    {
+        environment.setRecordingThreads(threads);
+
+        Result& result = results.emplace_back();
+        result.threads = threads;
+        result.minMs = std::numeric_limits<double>::max();
+
+        double totalMs = 0.0;
+        for (uint32_t frame = 0; frame < c_warmupFrames + frames; ++frame)
+        {
+            environment.beginRecording();
+            // Stats are published for the previous frame
+            if (frame > 0)
+                result.secondaryBuffers = environment.getRecordingStats().secondaryBuffers;
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            environment.recordProject(project);
+            const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            environment.endRecording();
+
+            if (frame < c_warmupFrames) continue;
+            totalMs += elapsedMs;
+            result.minMs = std::min(result.minMs, elapsedMs);
+        }
+        result.averageMs = frames > 0 ? totalMs / frames : 0.0;
+        result.speedup = result.averageMs > 0.0 ? results.front().averageMs / result.averageMs : 1.0;
+    }
+
+    gflow::Context::destroyEnvironment(environmentID);
+    return results;
+}
+
+void RecordingBenchmark::print(const std::vector<Result>& results)
+{
+    std::printf("%8s %12s %12s %12s %10s\n", "threads", "secondaries", "avg (ms)", "min (ms)", "speedup");
+    for (const Result& result : results)
+        std::printf("%8u %12u %12.4f %12.4f %9.2fx\n", result.threads, result.secondaryBuffers, result.averageMs, result.minMs, result.speedup);
+}
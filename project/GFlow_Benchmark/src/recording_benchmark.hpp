@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <Volk/volk.h>
+
+class RecordingBenchmark
+{
+public:
+    struct Result
+    {
+        uint32_t threads = 1;
+        uint32_t secondaryBuffers = 0;
+        double averageMs = 0.0;
+        double minMs = 0.0;
+        // Against the single threaded run
+        double speedup = 1.0;
+    };
+
+    // Renders the project headless and times the recording of its render graph with 1, 2, 4... up to maxThreads
+    // recording threads. Every run records the exact same command stream, only the thread count changes
+    static std::vector<Result> run(const std::string& projectPath, VkExtent2D extent, uint32_t frames, uint32_t maxThreads);
+    static void print(const std::vector<Result>& results);
+
+private:
+    static constexpr uint32_t c_warmupFrames = 10;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <Volk/volk.h>
+
+class VulkanCommandBuffer;
+
+namespace gflow
+{
+	// Tracks the last access of every image and buffer it is told about and turns the accesses that are about to
+	// happen into the narrowest pipeline barrier that makes them safe. Requests are accumulated and resolved in one
+	// batch, so every pass boundary costs at most one vkCmdPipelineBarrier. State persists between frames.
+	class BarrierSolver
+	{
+	public:
+		struct Batch
+		{
+			VkPipelineStageFlags srcStages = 0;
+			VkPipelineStageFlags dstStages = 0;
+			std::vector<VkImageMemoryBarrier> images{};
+			std::vector<VkBufferMemoryBarrier> buffers{};
+
+			[[nodiscard]] bool empty() const { return images.empty() && buffers.empty(); }
+		};
+
+		struct FrameStats
+		{
+			uint32_t batches = 0;
+			uint32_t imageBarriers = 0;
+			uint32_t bufferBarriers = 0;
+			uint32_t layoutTransitions = 0;
+		};
+
+		void useImage(VkImage image, VkImageAspectFlags aspect, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout, bool discard = false);
+		void useBuffer(VkBuffer buffer, VkPipelineStageFlags stages, VkAccessFlags access);
+
+		// For accesses that are synchronized by something else, like the layout transitions and dependencies of a render pass
+		void markImage(VkImage image, VkImageAspectFlags aspect, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout);
+		void markBuffer(VkBuffer buffer, VkPipelineStageFlags stages, VkAccessFlags access);
+
+		// The next image reuses the memory of the previous one, so its first use has to wait for every access to the previous one
+		void aliasImage(VkImage previous, VkImage next);
+
+		void forget(VkImage image);
+		void forget(VkBuffer buffer);
+
+		[[nodiscard]] Batch resolve();
+		void flush(const VulkanCommandBuffer& commandBuffer);
+
+		void beginFrame();
+		[[nodiscard]] const FrameStats& getFrameStats() const { return m_currentFrame; }
+		[[nodiscard]] const FrameStats& getLastFrameStats() const { return m_lastFrame; }
+
+		[[nodiscard]] VkImageLayout getLayout(VkImage image) const;
+
+	private:
+		struct State
+		{
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageAspectFlags aspect = 0;
+			VkPipelineStageFlags writeStages = 0;
+			VkAccessFlags writeAccess = 0;
+			// Stages that read the resource since the last write, a later write has to wait for them
+			VkPipelineStageFlags readStages = 0;
+			// What the last write has already been made visible to
+			VkPipelineStageFlags visibleStages = 0;
+			VkAccessFlags visibleAccess = 0;
+		};
+
+		struct Request
+		{
+			VkPipelineStageFlags stages = 0;
+			VkAccessFlags access = 0;
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			bool discard = false;
+		};
+
+		struct Hazard
+		{
+			bool needed = false;
+			VkPipelineStageFlags srcStages = 0;
+			VkAccessFlags srcAccess = 0;
+			VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		};
+
+		static void addRequest(std::unordered_map<uint64_t, Request>& pending, uint64_t handle, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout, bool discard);
+		static Hazard solve(State& state, const Request& request, bool isImage);
+		static void mark(State& state, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout);
+
+		std::unordered_map<uint64_t, State> m_images{};
+		std::unordered_map<uint64_t, State> m_buffers{};
+		std::unordered_map<uint64_t, Request> m_pendingImages{};
+		std::unordered_map<uint64_t, Request> m_pendingBuffers{};
+
+		FrameStats m_currentFrame{};
+		FrameStats m_lastFrame{};
+	};
+} // namespace gflow
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "environment.hpp"
+#include "gpu_capabilities.hpp"
 
 namespace gflow
 {
@@ -18,9 +19,15 @@ namespace gflow
         static Project& loadProject(const std::string& path, uint32_t gpuOverride = UINT32_MAX);
 	    static VkInstance getVulkanInstance();
 
+        // Capabilities of the GPUs are queried once and shared by every environment. With a path set they are also
+        // kept across runs, until the driver of a GPU changes
+        static void setGPUCachePath(const std::string& path);
+        static GPUCapabilityCache& getGPUCache() { return m_gpuCache; }
+
         static void destroy();
 
     private:
         inline static std::vector<Environment> m_environments{};
+        inline static GPUCapabilityCache m_gpuCache{};
     };
 } // namespace gflow
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
+#include <iosfwd>
 #include <string>
 #include <unordered_set>
+#include <vector>
 #include <Volk/volk.h>
 
 #include "utils/identifiable.hpp"
@@ -20,6 +22,70 @@ namespace gflow
 			void operator+=(const Requirements& other);
 		};
 
+		struct Image
+		{
+			enum Source : uint8_t { FLAT_COLOR, FILE };
+
+			std::string id;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			Source source = FLAT_COLOR;
+			bool matchScreen = true;
+			VkExtent2D size{};
+			float color[4]{};
+			std::string path;
+		};
+
+		struct Pipeline
+		{
+			std::string vertexPath;
+			std::string fragmentPath;
+			VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+			VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+			VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			bool depthTestEnable = false;
+			VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+			std::vector<VkPipelineColorBlendAttachmentState> blendAttachments{};
+			std::vector<VkPushConstantRange> pushConstantRanges{};
+		};
+
+		struct Attachment
+		{
+			uint32_t image = UINT32_MAX;
+			bool clear = false;
+		};
+
+		struct AttachmentReference
+		{
+			enum Type : uint8_t { DEPTH, COLOR, INPUT };
+
+			uint32_t attachment = UINT32_MAX;
+			Type type = COLOR;
+		};
+
+		struct DrawCall
+		{
+			uint32_t pipeline = UINT32_MAX;
+			uint32_t vertexCount = 0;
+		};
+
+		struct Subpass
+		{
+			std::vector<AttachmentReference> attachments{};
+			std::vector<DrawCall> drawCalls{};
+		};
+
+		struct Renderpass
+		{
+			std::vector<Attachment> attachments{};
+			std::vector<Subpass> subpasses{};
+		};
+
+		[[nodiscard]] const std::vector<Image>& getImages() const { return m_images; }
+		[[nodiscard]] const std::vector<Pipeline>& getPipelines() const { return m_pipelines; }
+		[[nodiscard]] const std::vector<Renderpass>& getRenderpasses() const { return m_renderpasses; }
+		[[nodiscard]] std::string getDirectory() const;
+
 	private:
 		struct FileStructure;
 
@@ -27,9 +93,16 @@ namespace gflow
 
 		[[nodiscard]] Requirements getRequirements() const;
 
+		void loadResources(std::ifstream& file);
+		void loadRenderpasses(std::ifstream& file);
+
 		std::string m_path;
 		uint32_t m_environment;
 
+		std::vector<Image> m_images{};
+		std::vector<Pipeline> m_pipelines{};
+		std::vector<Renderpass> m_renderpasses{};
+
 		friend class Environment;
 
 		struct FileStructure
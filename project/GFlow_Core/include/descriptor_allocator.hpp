@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include <Volk/volk.h>
+
+namespace gflow
+{
+	// Owns every descriptor set layout and set of an environment. Layouts are cached by their binding signature, sets
+	// come from chains of pools that grow on demand. Pools are sized after the descriptors handed out so far rather
+	// than a fixed guess, and transient sets live in a chain that is reset wholesale at the start of every frame
+	class DescriptorAllocator
+	{
+	public:
+		static constexpr uint32_t c_typeCount = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1;
+		static constexpr uint32_t c_initialSetsPerPool = 64;
+		static constexpr uint32_t c_maxSetsPerPool = 4096;
+
+		enum class Lifetime : uint8_t
+		{
+			PERSISTENT,	// Until the allocator is destroyed
+			FRAME		// Until the next beginFrame
+		};
+
+		// One binding as reflected from a shader stage
+		struct Binding
+		{
+			uint32_t binding = 0;
+			VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			uint32_t count = 1;
+			VkShaderStageFlags stages = 0;
+
+			bool operator==(const Binding& other) const = default;
+		};
+
+		struct Stats
+		{
+			uint32_t layouts = 0;
+			uint64_t layoutCacheHits = 0;
+			uint32_t persistentPools = 0;
+			uint32_t framePools = 0;
+			uint64_t persistentSets = 0;
+			uint32_t frameSets = 0;
+			uint32_t peakFrameSets = 0;
+			// New pools created because every pool of a chain was full
+			uint32_t poolGrowths = 0;
+			// Allocations that failed on a full or fragmented pool and were retried on another one
+			uint32_t allocationFailures = 0;
+			// Descriptors handed out per type, indexed by VkDescriptorType
+			std::array<uint64_t, c_typeCount> descriptors{};
+		};
+
+		DescriptorAllocator() = default;
+		explicit DescriptorAllocator(uint32_t device);
+
+		// Merges the bindings of several stages, bindings declared by more than one stage get the union of the stages
+		[[nodiscard]] static std::vector<Binding> mergeStages(const std::vector<std::vector<Binding>>& stages);
+		// Descriptors per type for a pool of setsPerPool sets. Every type gets room for as many descriptors per set as
+		// the sets handed out so far needed on average, and at least enough for the set that is waiting on the pool
+		[[nodiscard]] static std::vector<VkDescriptorPoolSize> getPoolSizes(const std::array<uint64_t, c_typeCount>& descriptors, uint64_t sets, const std::array<uint32_t, c_typeCount>& requested, uint32_t setsPerPool);
+
+		[[nodiscard]] VkDescriptorSetLayout getLayout(std::vector<Binding> bindings);
+		[[nodiscard]] VkDescriptorSet allocate(VkDescriptorSetLayout layout, Lifetime lifetime = Lifetime::FRAME);
+
+		// Must only be called once the GPU is done with the sets of the previous frame
+		void beginFrame();
+		void destroy();
+
+		[[nodiscard]] const Stats& getStats() const { return m_stats; }
+
+	private:
+		struct LayoutInfo
+		{
+			// Descriptors per type for one set of the layout
+			std::array<uint32_t, c_typeCount> descriptors{};
+		};
+
+		struct Chain
+		{
+			std::vector<VkDescriptorPool> pools{};
+			size_t current = 0;
+			uint32_t setsPerPool = c_initialSetsPerPool;
+		};
+
+		struct SignatureHash
+		{
+			size_t operator()(const std::vector<Binding>& bindings) const;
+		};
+
+		void createPool(Chain& chain, const LayoutInfo& requested);
+
+		uint32_t m_device = UINT32_MAX;
+		std::unordered_map<std::vector<Binding>, VkDescriptorSetLayout, SignatureHash> m_layouts{};
+		std::unordered_map<VkDescriptorSetLayout, LayoutInfo> m_layoutInfos{};
+		Chain m_persistent{};
+		Chain m_frame{};
+		Stats m_stats{};
+	};
+} // namespace gflow
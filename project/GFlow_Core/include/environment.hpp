@@ -1,9 +1,20 @@
 #pragma once
+#include <chrono>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "utils/identifiable.hpp"
 #include "core_project.hpp"
+#include "descriptor_allocator.hpp"
+#include "gpu_capabilities.hpp"
+#include "gpu_profiler.hpp"
+#include "image_pool.hpp"
+#include "parallel_recorder.hpp"
+#include "readback.hpp"
+#include "render_graph.hpp"
+#include "upload_queue.hpp"
 #include "vulkan_gpu.hpp"
 #include "vulkan_queues.hpp"
 #include "vulkan_shader.hpp"
@@ -13,8 +24,43 @@ namespace gflow
     class Environment : public Identifiable
     {
     public:
+        enum class PresentPolicy
+        {
+            VSYNC,          // FIFO, always available
+            LATENCY,        // MAILBOX, then IMMEDIATE
+            THROUGHPUT,     // IMMEDIATE, then MAILBOX
+            POWER_SAVING    // FIFO_RELAXED
+        };
+
+        struct PresentStats
+        {
+            VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            uint64_t frames = 0;
+            // CPU time between acquiring a swapchain image and presenting it
+            double lastLatencyMs = 0.0;
+            double averageLatencyMs = 0.0;
+            double maxLatencyMs = 0.0;
+        };
+
+        struct RecordingStats
+        {
+            uint32_t threads = 1;
+            uint32_t secondaryBuffers = 0;
+            // CPU time spent recording the projects of the frame
+            double recordMs = 0.0;
+        };
+
+        struct ThroughputStats
+        {
+            uint64_t frames = 0;
+            double lastFrameMs = 0.0;
+            double averageFrameMs = 0.0;
+            double fps = 0.0;
+        };
 
         uint32_t loadProject(const std::string& path);
+        // Waits for the GPU if the project has been recorded, its render graph is destroyed with it
+        void unloadProject(uint32_t project);
         void addSurface(VkSurfaceKHR surface);
 
         void build(uint32_t gpuOverride = UINT32_MAX);
@@ -23,15 +69,57 @@ namespace gflow
         [[nodiscard]] const Project& getProject(uint32_t id) const;
 
         void beginRecording(const std::vector<VkSurfaceKHR>& surfacesToPrepare = {});
-        void recordProject(uint32_t project) const;
-        void setRecordingBarrier() const;
+        void recordProject(uint32_t project);
+        void setRecordingBarrier();
         void endRecording();
 
+        // 0 and 1 record every project inline on the calling thread. Must not be called while recording
+        void setRecordingThreads(uint32_t threads);
+        [[nodiscard]] uint32_t getRecordingThreads() const { return m_recordingThreads; }
+        [[nodiscard]] const RecordingStats& getRecordingStats() const { return m_lastRecordingStats; }
+
+        // Size of the screen matching images. Set automatically by the present targets, headless environments set it directly
+        void setRenderExtent(VkExtent2D extent);
+        [[nodiscard]] VkExtent2D getRenderExtent() const { return m_renderExtent; }
+        [[nodiscard]] bool isHeadless() const { return m_swapchains.empty(); }
+
+        // Must be called after recordProject in the same frame. Callbacks run from beginRecording or flushReadbacks
+        // once the frame is finished on the GPU
+        void requestReadback(uint32_t project, uint32_t image, ReadbackQueue::Callback callback);
+        void requestReadback(uint32_t project, uint32_t image, const std::string& path);
+        // Images read after the frame keep their own memory. Marking an image of a project that was already recorded
+        // rebuilds its render graph on the next record, so it must not be called while recording
+        void markReadable(uint32_t project, uint32_t image);
+        void flushReadbacks();
+
+        [[nodiscard]] const ThroughputStats& getThroughputStats() const { return m_throughput; }
+
+        // Uploads go through the transfer queue if the projects asked for one, and are visible to the frame that
+        // begins recording after them
+        [[nodiscard]] UploadQueue& getUploadQueue() { return m_uploads; }
+        // Shared 1x1 images behind the flat color images of every project that are never rendered to
+        [[nodiscard]] const ImagePool& getImagePool() const { return m_imagePool; }
+        // Frame lifetime sets are reset by beginRecording, once the previous frame is done with them
+        [[nodiscard]] DescriptorAllocator& getDescriptorAllocator() { return m_descriptors; }
+
         void configurePresentTarget(VkSurfaceKHR surface, VkExtent2D windowSize);
         void configurePresentTarget(VkSurfaceKHR surface, VkExtent2D windowSize, VkSurfaceFormatKHR format);
         void reconfigurePresentTarget(VkSurfaceKHR surface, VkExtent2D windowSize);
         bool present(VkSurfaceKHR surface);
+
+        // Takes effect the next time a present target is configured or reconfigured. The CPU never records more than
+        // one frame ahead of the GPU, how many frames wait on the display is up to the present mode and the swapchain
+        void setPresentPolicy(PresentPolicy policy);
+        [[nodiscard]] PresentPolicy getPresentPolicy() const { return m_presentPolicy; }
+        [[nodiscard]] PresentStats getPresentStats(VkSurfaceKHR surface) const;
 		    
+        [[nodiscard]] const BarrierSolver::FrameStats& getBarrierStats() const { return m_barrierSolver.getLastFrameStats(); }
+
+        // GPU time and pipeline statistics of the render passes, subpasses and draw calls of every recorded project,
+        // collected by beginRecording a frame or more after they were recorded. Off by default
+        void setGPUProfiling(bool enabled) { m_gpuProfiler.setEnabled(enabled); }
+        [[nodiscard]] const GPUProfiler& getGPUProfiler() const { return m_gpuProfiler; }
+
         [[nodiscard]] uint32_t man_getCommandBuffer() const;
         [[nodiscard]] uint32_t man_getDevice() const;
         [[nodiscard]] QueueSelection man_getQueuePos(QueueFamilyTypeBits type) const;
@@ -46,6 +134,9 @@ namespace gflow
         void destroy();
 
         [[nodiscard]] Project::Requirements getRequirements() const;
+        [[nodiscard]] VkPresentModeKHR selectPresentMode(VkSurfaceKHR surface) const;
+        void destroyRenderGraph(RenderGraph& graph);
+        void invalidateRenderGraphs();
         //bool blitImage(VkSurfaceKHR surface, uint32_t deviceImage);
 
         uint32_t m_device = UINT32_MAX;
@@ -55,7 +146,12 @@ namespace gflow
             uint32_t id = UINT32_MAX;
             QueueSelection presentQueue{};
             bool mustBeAwaited = false;
+
+            std::chrono::steady_clock::time_point acquireTime{};
+            PresentStats stats{};
         };
+
+        PresentPolicy m_presentPolicy = PresentPolicy::VSYNC;
         VkSurfaceKHR m_surfaceToPresent = VK_NULL_HANDLE;
 		    
         uint32_t m_inFlightFence = UINT32_MAX;
@@ -64,14 +160,35 @@ namespace gflow
 
         std::unordered_map<VkSurfaceKHR, Swapchain> m_swapchains{};
         std::vector<Project> m_projects{};
+
+        // Built lazily on the first record of each project, and thrown away whenever the render extent changes
+        VkExtent2D m_renderExtent{};
+        std::unordered_map<uint32_t, RenderGraph> m_renderGraphs{};
+        std::unordered_map<uint32_t, std::unordered_set<uint32_t>> m_readableImages{};
+        BarrierSolver m_barrierSolver{};
+        // Created on the next beginRecording after the thread count changes
+        uint32_t m_recordingThreads = 1;
+        std::unique_ptr<ParallelRecorder> m_recorder{};
+        RecordingStats m_recordingStats{};
+        RecordingStats m_lastRecordingStats{};
+        ReadbackQueue m_readbacks{};
+        UploadQueue m_uploads{};
+        ImagePool m_imagePool{};
+        DescriptorAllocator m_descriptors{};
+        GPUProfiler m_gpuProfiler{};
+
+        uint64_t m_submittedFrames = 0;
+        uint64_t m_completedFrames = 0;
+        std::chrono::steady_clock::time_point m_lastSubmitTime{};
+        ThroughputStats m_throughput{};
 		    
         uint32_t m_commandBuffer = UINT32_MAX;
         uint32_t m_transferBuffer = UINT32_MAX;
         QueueSelection m_mainQueue{};
         QueueSelection m_transferQueue{};
 
-        bool isGPUSuitable(VulkanGPU gpu, const Project::Requirements& requirements);
-        VulkanGPU selectGPU(const Project::Requirements& requirements);
+        bool isGPUSuitable(VulkanGPU gpu, const GPUCapabilities::Mask& requirements);
+        VulkanGPU selectGPU(const GPUCapabilities::Mask& requirements);
 
         friend class Context;
     };
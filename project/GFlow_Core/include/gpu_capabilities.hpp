@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <compare>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core_project.hpp"
+#include "vulkan_gpu.hpp"
+
+namespace gflow
+{
+	// Everything GPU selection needs to know about a device, queried once and reduced to masks so checking it against
+	// a set of requirements is a handful of bitwise operations. Extensions are kept as sorted name hashes
+	struct GPUCapabilities
+	{
+		// Low queue flags (graphics, compute, transfer, sparse binding, protected) tracked per combination
+		static constexpr VkQueueFlags c_queueFlagMask = 0x1F;
+		static constexpr uint32_t c_featureCount = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
+		static_assert(c_featureCount <= 64, "VkPhysicalDeviceFeatures no longer fits the feature mask");
+
+		enum class Mismatch : uint8_t { NONE, FEATURES, QUEUE_FLAGS, EXTENSIONS };
+
+		// Requirements reduced to the same masks, compiled once per selection
+		struct Mask
+		{
+			uint64_t features = 0;
+			VkQueueFlags queueFlags = 0;
+			// Flags a single family has to support together
+			VkQueueFlags familyFlags = 0;
+			uint64_t extensionFilter = 0;
+			std::vector<uint64_t> extensions{};
+			// Not part of check, see isPresentSupported
+			bool present = false;
+		};
+
+		uint32_t vendorID = 0;
+		uint32_t deviceID = 0;
+		uint32_t driverVersion = 0;
+		std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID{};
+		std::array<char, VK_MAX_PHYSICAL_DEVICE_NAME_SIZE> deviceName{};
+		VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+
+		uint64_t features = 0;
+		// Union of the flags of every family
+		VkQueueFlags queueFlags = 0;
+		// Bit n is set if some family supports every flag of n, for n up to c_queueFlagMask
+		uint32_t queueFlagCombinations = 0;
+		uint32_t queueFamilyCount = 0;
+		VkDeviceSize deviceLocalMemory = 0;
+		// One bit per extension hash, rules out most missing extensions before searching the list
+		uint64_t extensionFilter = 0;
+		std::vector<uint64_t> extensions{};
+
+		[[nodiscard]] static GPUCapabilities query(VulkanGPU gpu);
+		[[nodiscard]] static Mask compile(const Project::Requirements& requirements);
+		[[nodiscard]] static uint64_t toFeatureMask(const VkPhysicalDeviceFeatures& features);
+		[[nodiscard]] static uint64_t hashExtension(const char* name);
+
+		[[nodiscard]] Mismatch check(const Mask& mask) const;
+		// Needs a live device, surfaces aren't cached
+		[[nodiscard]] bool isPresentSupported(VulkanGPU gpu, VkSurfaceKHR surface) const;
+	};
+
+	// Capabilities of every GPU seen so far, optionally persisted to a file. Entries are keyed by vendor, device, driver
+	// version and pipeline cache UUID, so two identical cards on different drivers get their own entry. Saving drops
+	// the entries of a device model whose key no device of this run reported, which is how an old driver goes away
+	class GPUCapabilityCache
+	{
+	public:
+		struct Stats
+		{
+			uint32_t hits = 0;
+			uint32_t queries = 0;
+		};
+
+		// Loads the file if it exists. An empty path keeps the cache in memory only
+		void setPath(const std::string& path);
+		// Writes the file if anything was queried since it was loaded
+		void save();
+
+		[[nodiscard]] const GPUCapabilities& get(VulkanGPU gpu);
+		[[nodiscard]] const Stats& getStats() const { return m_stats; }
+
+	private:
+		static constexpr uint32_t c_fileMagic = 0x43474647; // GFGC
+		static constexpr uint32_t c_fileVersion = 2;
+		static constexpr uint32_t c_maxExtensions = 4096;
+
+		struct Key
+		{
+			uint32_t vendorID = 0;
+			uint32_t deviceID = 0;
+			uint32_t driverVersion = 0;
+			std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID{};
+
+			auto operator<=>(const Key&) const = default;
+		};
+
+		void load();
+
+		std::string m_path{};
+		std::map<Key, GPUCapabilities> m_entries{};
+		// Keys of the devices seen in this run, so their properties are only read once
+		std::unordered_map<VkPhysicalDevice, Key> m_devices{};
+		bool m_dirty = false;
+		Stats m_stats{};
+	};
+} // namespace gflow
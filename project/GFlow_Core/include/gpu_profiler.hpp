@@ -0,0 +1,118 @@
+#pragma once
+#include <map>
+#include <tuple>
+#include <vector>
+#include <Volk/volk.h>
+
+#include "vulkan_gpu.hpp"
+
+namespace gflow
+{
+	// Timestamp and pipeline statistics queries around the render passes, subpasses and draw calls of the recorded
+	// projects. Every frame writes into its own slot of query pools, which is read once the frame is known to be
+	// finished, so results arrive a frame or more late but reading them never waits on the GPU
+	class GPUProfiler
+	{
+	public:
+		static constexpr uint32_t c_frameSlots = 4;
+		static constexpr uint32_t c_maxScopes = 2048;
+		static constexpr uint32_t c_maxStatisticScopes = 1024;
+		static constexpr uint32_t c_none = UINT32_MAX;
+
+		// Indices into the project, a scope around a whole subpass leaves drawCall as c_none and one around a render
+		// pass leaves both
+		struct Key
+		{
+			uint32_t project = c_none;
+			uint32_t renderpass = c_none;
+			uint32_t subpass = c_none;
+			uint32_t drawCall = c_none;
+
+			bool operator<(const Key& other) const { return std::tie(project, renderpass, subpass, drawCall) < std::tie(other.project, other.renderpass, other.subpass, other.drawCall); }
+		};
+
+		struct PipelineStatistics
+		{
+			uint64_t inputAssemblyVertices = 0;
+			uint64_t inputAssemblyPrimitives = 0;
+			uint64_t vertexShaderInvocations = 0;
+			uint64_t clippingInvocations = 0;
+			uint64_t clippingPrimitives = 0;
+			uint64_t fragmentShaderInvocations = 0;
+
+			void operator+=(const PipelineStatistics& other);
+		};
+
+		struct Sample
+		{
+			Key key{};
+			// Between the top of pipe timestamp before the scope and the bottom of pipe one after it. Scopes overlap
+			// on the GPU, the times of the draws of a subpass don't add up to the time of the subpass
+			double gpuMs = 0.0;
+			// Only queried around draw calls, subpasses and render passes get the sum of their draws
+			bool hasStatistics = false;
+			PipelineStatistics statistics{};
+		};
+
+		struct Frame
+		{
+			uint64_t frame = 0;
+			std::vector<Sample> samples{};
+			// Scopes beyond the capacity of the query pools, they got no queries
+			uint32_t droppedScopes = 0;
+		};
+
+		GPUProfiler() = default;
+		// Pipeline statistics need the pipelineStatisticsQuery feature enabled on the device
+		GPUProfiler(uint32_t device, VulkanGPU gpu, uint32_t queueFamily, bool pipelineStatistics);
+
+		// Disabled by default. Takes effect on the next frame
+		void setEnabled(bool enabled) { m_enabled = enabled && isSupported(); }
+		[[nodiscard]] bool isEnabled() const { return m_enabled; }
+		[[nodiscard]] bool isSupported() const { return m_timestampPeriod > 0.0f; }
+		[[nodiscard]] bool hasPipelineStatistics() const { return m_statisticsSupported; }
+
+		// Must be recorded outside of any render pass, before the first scope of the frame
+		void beginFrame(VkCommandBuffer cmd, uint64_t frame);
+		// Returns c_none if the profiler isn't recording this frame or the pools are full. Statistics scopes can't nest
+		[[nodiscard]] uint32_t beginScope(VkCommandBuffer cmd, const Key& key, bool statistics);
+		void endScope(VkCommandBuffer cmd, uint32_t scope);
+		void collect(uint64_t completedFrame);
+		void destroy();
+
+		// Results of the most recent frame that has been collected
+		[[nodiscard]] const Frame& getLastFrame() const { return m_lastFrame; }
+		[[nodiscard]] const Sample* find(const Key& key) const;
+
+	private:
+		struct Scope
+		{
+			Key key{};
+			uint32_t statistics = c_none;
+		};
+
+		struct Slot
+		{
+			VkQueryPool timestamps = VK_NULL_HANDLE;
+			VkQueryPool statistics = VK_NULL_HANDLE;
+			uint64_t frame = 0;
+			bool pending = false;
+			std::vector<Scope> scopes{};
+			uint32_t statisticCount = 0;
+			uint32_t droppedScopes = 0;
+		};
+
+		uint32_t m_device = UINT32_MAX;
+		float m_timestampPeriod = 0.0f;
+		uint64_t m_timestampMask = 0;
+		bool m_statisticsSupported = false;
+		bool m_enabled = false;
+
+		std::vector<Slot> m_slots{};
+		// Slot of the frame being recorded, c_none when the profiler was disabled as it began
+		uint32_t m_current = c_none;
+
+		Frame m_lastFrame{};
+		std::map<Key, uint32_t> m_lastIndex{};
+	};
+} // namespace gflow
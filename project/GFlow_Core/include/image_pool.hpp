@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <map>
+#include <utility>
+#include <vector>
+#include <Volk/volk.h>
+
+namespace gflow
+{
+	class UploadQueue;
+
+	// Backs the flat color images that are only ever sampled. Every distinct format and color gets a single 1x1 image
+	// that all the render graphs asking for it share, packed with the others into a few memory pages and read through
+	// one nearest, repeating sampler, so the texel comes back the same for any coordinate. Images live until the pool is
+	// destroyed, a render graph rebuilt after a resize finds its images again without uploading anything
+	class ImagePool
+	{
+	public:
+		struct Entry
+		{
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			// Transfer ticket of the upload, see UploadQueue::isComplete
+			uint64_t ticket = 0;
+		};
+
+		struct Stats
+		{
+			uint32_t requests = 0;
+			uint32_t images = 0;
+			VkDeviceSize memory = 0;
+		};
+
+		static constexpr VkDeviceSize c_pageSize = 256ULL * 1024;
+
+		ImagePool() = default;
+		explicit ImagePool(uint32_t device);
+
+		// Formats a color can't be written in, or that can't be sampled, fall back to RGBA8. New images are uploaded
+		// through the queue and usable from the next frame that begins recording
+		[[nodiscard]] const Entry& acquire(VkFormat format, const float color[4], UploadQueue& uploads);
+		void destroy();
+
+		[[nodiscard]] VkSampler getSampler() const { return m_sampler; }
+		[[nodiscard]] const Stats& getStats() const { return m_stats; }
+
+		// Writes the color as one texel of the format, returns the texel size or 0 if the format isn't supported
+		static uint32_t encodeTexel(VkFormat format, const float color[4], std::array<uint8_t, 16>& texel);
+
+	private:
+		struct Page
+		{
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			uint32_t memoryType = UINT32_MAX;
+			VkDeviceSize used = 0;
+		};
+
+		[[nodiscard]] std::pair<VkDeviceMemory, VkDeviceSize> allocate(const VkMemoryRequirements& requirements);
+
+		uint32_t m_device = UINT32_MAX;
+		VkSampler m_sampler = VK_NULL_HANDLE;
+		std::vector<Page> m_pages{};
+		// Keyed by the encoded texel, so colors that only differ below the precision of the format are shared too
+		std::map<std::pair<VkFormat, std::array<uint8_t, 16>>, Entry> m_entries{};
+		Stats m_stats{};
+	};
+} // namespace gflow
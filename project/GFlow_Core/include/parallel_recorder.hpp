@@ -0,0 +1,52 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Volk/volk.h>
+
+#include "worker_pool.hpp"
+
+namespace gflow
+{
+	// Records secondary command buffers on a worker pool. Every worker owns its own command pool, so recording never
+	// takes a lock, and the buffers come back in job order so the primary executes them in the same order no matter
+	// how many threads recorded them
+	class ParallelRecorder
+	{
+	public:
+		// A slice of a subpass, recorded into one secondary command buffer that continues the render pass
+		struct Job
+		{
+			VkRenderPass renderPass = VK_NULL_HANDLE;
+			uint32_t subpass = 0;
+			VkFramebuffer framebuffer = VK_NULL_HANDLE;
+			std::function<void(VkCommandBuffer)> record{};
+		};
+
+		ParallelRecorder(uint32_t device, uint32_t queueFamily, uint32_t threadCount);
+
+		// Recycles every buffer handed out in the previous frame, which must be finished on the GPU
+		void beginFrame();
+		[[nodiscard]] std::vector<VkCommandBuffer> record(const std::vector<Job>& jobs);
+		void destroy();
+
+		[[nodiscard]] uint32_t getThreadCount() const { return m_workers->getWorkerCount(); }
+		// Secondary command buffers recorded since the last beginFrame
+		[[nodiscard]] uint32_t getRecordedCount() const;
+
+	private:
+		// Padded so two workers never write to the same cache line
+		struct alignas(64) ThreadPool
+		{
+			VkCommandPool pool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> buffers{};
+			uint32_t used = 0;
+		};
+
+		[[nodiscard]] static VkCommandBuffer acquire(VkDevice device, ThreadPool& threadPool);
+
+		uint32_t m_device = UINT32_MAX;
+		std::unique_ptr<WorkerPool> m_workers;
+		std::vector<ThreadPool> m_pools{};
+	};
+} // namespace gflow
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "utils/logger.hpp"
+
+// Profiling is on in debug builds. Release builds can turn it on by defining GFLOW_PROFILING=1, otherwise every zone
+// compiles away and the context functions only forward to the Logger
+#ifndef GFLOW_PROFILING
+#ifdef _DEBUG
+#define GFLOW_PROFILING 1
+#else
+#define GFLOW_PROFILING 0
+#endif
+#endif
+
+namespace gflow
+{
+	// Timestamps the Logger contexts and any scoped zone into per-thread event buffers. Only the owning thread writes
+	// to a buffer, events are published with a release store of its count so exporting never blocks the threads being
+	// profiled. Names must outlive the profiler, string literals in practice
+	class Profiler
+	{
+	public:
+		// Same as the Logger functions, plus a zone spanning the context
+		static void pushContext(const char* name);
+		static void popContext();
+		// Root contexts follow each other, setting one ends the zone of the previous one
+		static void setRootContext(const char* name);
+
+#if GFLOW_PROFILING
+		static void beginZone(const char* name);
+		static void endZone();
+
+		static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+		[[nodiscard]] static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+		// Chrome trace event format, loads in chrome://tracing and Perfetto. Zones still open are left out
+		static bool exportChromeTrace(const std::string& path);
+		// Drops every recorded event. Must not race with threads inside a zone
+		static void clear();
+		[[nodiscard]] static uint64_t getEventCount();
+
+	private:
+		inline static std::atomic<bool> s_enabled{ true };
+#else
+		static void beginZone(const char*) {}
+		static void endZone() {}
+
+		static void setEnabled(bool) {}
+		[[nodiscard]] static bool isEnabled() { return false; }
+
+		static bool exportChromeTrace(const std::string&) { return false; }
+		static void clear() {}
+		[[nodiscard]] static uint64_t getEventCount() { return 0; }
+#endif
+	};
+
+#if GFLOW_PROFILING
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) { Profiler::beginZone(name); }
+		~ProfileZone() { Profiler::endZone(); }
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+	};
+#endif
+
+#if !GFLOW_PROFILING
+	inline void Profiler::pushContext(const char* name) { Logger::pushContext(name); }
+	inline void Profiler::popContext() { Logger::popContext(); }
+	inline void Profiler::setRootContext(const char* name) { Logger::setRootContext(name); }
+#endif
+} // namespace gflow
+
+#define GFLOW_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GFLOW_PROFILE_CONCAT(a, b) GFLOW_PROFILE_CONCAT_IMPL(a, b)
+#if GFLOW_PROFILING
+#define GFLOW_PROFILE_ZONE(name) const gflow::ProfileZone GFLOW_PROFILE_CONCAT(profileZone, __COUNTER__){ name }
+#else
+#define GFLOW_PROFILE_ZONE(name) ((void)0)
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include <Volk/volk.h>
+
+#include "barrier_solver.hpp"
+#include "render_graph.hpp"
+
+class VulkanCommandBuffer;
+
+namespace gflow
+{
+	// Copies render graph images into host visible staging buffers as part of a frame and hands the data back once
+	// the frame that recorded the copy is known to be finished, without ever stalling the queue
+	class ReadbackQueue
+	{
+	public:
+		struct Readback
+		{
+			uint32_t project = UINT32_MAX;
+			uint32_t image = UINT32_MAX;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkExtent2D extent{};
+			std::vector<uint8_t> data{};
+
+			// 8 bit RGBA and BGRA images are written as binary PPM, anything else is dumped as raw texels
+			bool save(const std::string& path) const;
+		};
+
+		using Callback = std::function<void(const Readback&)>;
+
+		explicit ReadbackQueue(uint32_t device = UINT32_MAX);
+
+		void record(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers, const RenderGraph::Image& image, uint32_t project, uint32_t imageIndex, uint64_t frame, Callback callback);
+		void collect(uint64_t completedFrame);
+		void destroy();
+
+		[[nodiscard]] size_t getPendingCount() const { return m_pending.size(); }
+
+		[[nodiscard]] static uint32_t getTexelSize(VkFormat format);
+
+	private:
+		// Persistently mapped host visible buffer. Buffers go back to the pool once the frame that copied into them is
+		// finished and get reused by any readback that fits
+		struct Staging
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize capacity = 0;
+			void* mapped = nullptr;
+			bool coherent = true;
+		};
+
+		struct Pending
+		{
+			Readback result{};
+			Callback callback{};
+			uint64_t frame = 0;
+			Staging staging{};
+			VkDeviceSize size = 0;
+		};
+
+		Staging acquireStaging(VkDeviceSize size);
+		void releaseStaging(const Staging& staging);
+		void destroyStaging(const Staging& staging) const;
+
+		// Free buffers kept around at most, the largest ones are kept when the pool overflows
+		static constexpr size_t c_maxFreeStaging = 4;
+
+		uint32_t m_device = UINT32_MAX;
+		std::vector<Pending> m_pending{};
+		std::vector<Staging> m_freeStaging{};
+	};
+} // namespace gflow
@@ -0,0 +1,151 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <Volk/volk.h>
+
+#include "barrier_solver.hpp"
+#include "core_project.hpp"
+#include "gpu_profiler.hpp"
+#include "image_pool.hpp"
+#include "parallel_recorder.hpp"
+
+class VulkanCommandBuffer;
+
+namespace gflow
+{
+	class RenderGraph
+	{
+	public:
+		// What a pass does to one of the project images as seen from outside of the pass. Every image attached to
+		// a render pass gets exactly one usage, aggregated over all the subpasses that reference it, and it is what
+		// the barrier solver is fed before and after the pass
+		struct ImageUsage
+		{
+			uint32_t image = UINT32_MAX;
+			VkPipelineStageFlags stages = 0;
+			VkAccessFlags access = 0;
+			VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			bool read = false;
+			bool write = false;
+			bool discard = false;
+		};
+
+		struct Draw
+		{
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			uint32_t vertexCount = 0;
+		};
+
+		struct Pass
+		{
+			uint32_t renderpass = UINT32_MAX;
+			VkRenderPass handle = VK_NULL_HANDLE;
+			VkFramebuffer framebuffer = VK_NULL_HANDLE;
+			VkExtent2D extent{};
+			std::vector<VkClearValue> clearValues{};
+			std::vector<std::vector<Draw>> draws{};
+			std::vector<ImageUsage> usages{};
+			// Images that take over the memory of another one at the start of this pass, as (previous, next)
+			std::vector<std::pair<uint32_t, uint32_t>> handoffs{};
+		};
+
+		struct Image
+		{
+			VkImage image = VK_NULL_HANDLE;
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkExtent2D extent{};
+			VkImageAspectFlags aspect = 0;
+			VkImageUsageFlags usage = 0;
+			VkDeviceSize size = 0;
+
+			// Live range in graph passes
+			uint32_t firstPass = UINT32_MAX;
+			uint32_t lastPass = UINT32_MAX;
+			bool discarded = false;
+			// Its last use only reads it, nothing after the graph depends on its contents
+			bool consumed = false;
+			// Read after the frame, by a readback or by whatever is recorded after the projects. Never shares memory
+			bool external = false;
+			// Never leaves tile memory, can't be sampled
+			bool transient = false;
+			// Shares memory with an image used later in the frame, so its contents don't survive the frame
+			bool aliased = false;
+			// Flat color image that is never attached, backed by a 1x1 image of the pool that other graphs may share
+			bool pooled = false;
+
+			[[nodiscard]] bool isReadable() const { return image != VK_NULL_HANDLE && !transient && !aliased && !pooled; }
+		};
+
+		struct MemoryStats
+		{
+			VkDeviceSize unaliased = 0;
+			VkDeviceSize aliased = 0;
+			VkDeviceSize transient = 0;
+			bool lazilyAllocated = false;
+			uint32_t pooledImages = 0;
+		};
+
+		RenderGraph(uint32_t device, VkExtent2D screenExtent);
+
+		// Flat color images that are never attached are taken from the pool, their texels go up through the uploads
+		void build(const Project& project, const std::unordered_set<uint32_t>& externalImages, ImagePool& pool, UploadQueue& uploads);
+		// Records the subpasses into secondary command buffers on the recorder threads if one is given, inline otherwise.
+		// The profiler gets a scope around every render pass, and around every subpass and draw call when recording
+		// inline, since secondary command buffers can't take part in queries of the primary
+		void record(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers, ParallelRecorder* recorder = nullptr, GPUProfiler* profiler = nullptr, uint32_t project = GPUProfiler::c_none) const;
+		void destroy();
+
+		[[nodiscard]] bool isBuilt() const { return m_built; }
+		[[nodiscard]] VkExtent2D getScreenExtent() const { return m_screenExtent; }
+		[[nodiscard]] const std::vector<Pass>& getPasses() const { return m_passes; }
+		[[nodiscard]] const std::vector<Image>& getImages() const { return m_images; }
+		[[nodiscard]] const MemoryStats& getMemoryStats() const { return m_memoryStats; }
+
+		[[nodiscard]] static bool isDepthFormat(VkFormat format);
+		[[nodiscard]] static bool isStencilFormat(VkFormat format);
+		// Formats with a depth aspect, a stencil aspect or both, their attachments use the depth/stencil layouts
+		[[nodiscard]] static bool isDepthStencilFormat(VkFormat format);
+		// Every aspect a format holds, depth and stencil together for the combined formats
+		[[nodiscard]] static VkImageAspectFlags getFormatAspect(VkFormat format);
+
+	private:
+		struct PipelineObjects
+		{
+			VkShaderModule vertex = VK_NULL_HANDLE;
+			VkShaderModule fragment = VK_NULL_HANDLE;
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+		};
+
+		void declareUsages(const Project& project);
+		void analyzeLifetimes(const Project& project);
+		void createImages(const Project& project);
+		void allocateMemory();
+		void acquirePooledImages(const Project& project, ImagePool& pool, UploadQueue& uploads);
+		void createPipelineObjects(const Project& project);
+		void createPass(const Project& project, uint32_t passIndex);
+		[[nodiscard]] VkPipeline createPipeline(const Project& project, uint32_t pipelineIndex, const Pass& pass, uint32_t subpassIndex);
+		[[nodiscard]] VkShaderModule loadShaderModule(const std::string& path) const;
+		[[nodiscard]] uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+
+		static void setViewport(VkCommandBuffer cmd, VkExtent2D extent);
+		static void recordDraws(VkCommandBuffer cmd, const std::vector<Draw>& draws, size_t first, size_t last);
+
+		uint32_t m_device = UINT32_MAX;
+		std::string m_directory;
+		VkExtent2D m_screenExtent{};
+		bool m_built = false;
+
+		std::vector<Image> m_images{};
+		std::vector<VkDeviceMemory> m_memoryBlocks{};
+		MemoryStats m_memoryStats{};
+		std::vector<PipelineObjects> m_pipelineObjects{};
+		std::vector<Pass> m_passes{};
+		std::unordered_map<uint64_t, VkPipeline> m_pipelineCache{};
+	};
+} // namespace gflow
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <Volk/volk.h>
+
+#include "barrier_solver.hpp"
+#include "vulkan_queues.hpp"
+
+class VulkanCommandBuffer;
+
+namespace gflow
+{
+	// Streams data into device local buffers and images through a persistently mapped staging ring on the transfer
+	// queue. Uploads are copied into the ring right away and submitted in one batch at the start of the next frame,
+	// whose graphics submission waits on the batch semaphore. The CPU never waits for an upload: once the ring is full
+	// the data goes into a dedicated staging buffer instead
+	class UploadQueue
+	{
+	public:
+		static constexpr VkDeviceSize c_defaultCapacity = 32ULL * 1024 * 1024;
+
+		UploadQueue() = default;
+		UploadQueue(uint32_t device, QueueSelection queue, uint32_t graphicsFamily, VkDeviceSize capacity = c_defaultCapacity);
+
+		// Both return a ticket that can be checked with isComplete. The destination becomes usable by the given stages
+		// from the first frame that begins recording after the call
+		uint64_t uploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+		uint64_t uploadImage(VkImage image, VkImageAspectFlags aspect, VkExtent2D extent, const void* data, VkDeviceSize size, VkImageLayout finalLayout, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+
+		// Submits everything uploaded so far to the transfer queue, to be consumed by the given frame
+		void submit(uint64_t frame);
+		// Records the queue family acquire of the last submission into the graphics command buffer and lets the barrier
+		// solver know about the new contents
+		void acquire(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers);
+		// What the graphics submission of the frame has to wait on, UINT32_MAX if there is nothing
+		[[nodiscard]] uint32_t getWaitSemaphore() const;
+		[[nodiscard]] VkPipelineStageFlags getWaitStages() const;
+
+		void collect(uint64_t completedFrame);
+		void destroy();
+
+		[[nodiscard]] bool isComplete(uint64_t ticket) const { return ticket <= m_completedTicket; }
+		[[nodiscard]] bool hasOwnershipTransfer() const { return m_queue.familyIndex != m_graphicsFamily; }
+		[[nodiscard]] VkDeviceSize getCapacity() const { return m_capacity; }
+		[[nodiscard]] VkDeviceSize getUsedBytes() const { return m_used; }
+
+	private:
+		struct Copy
+		{
+			VkBuffer source = VK_NULL_HANDLE;
+			VkDeviceSize sourceOffset = 0;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			VkImage image = VK_NULL_HANDLE;
+			VkImageAspectFlags aspect = 0;
+			VkExtent2D extent{};
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkDeviceSize size = 0;
+			VkPipelineStageFlags dstStages = 0;
+			VkAccessFlags dstAccess = 0;
+		};
+
+		struct Staging
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+		};
+
+		struct Batch
+		{
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+			uint32_t semaphore = UINT32_MAX;
+			uint64_t ticket = 0;
+			uint64_t frame = 0;
+			VkDeviceSize ringBytes = 0;
+			std::vector<Copy> copies{};
+			std::vector<Staging> dedicated{};
+			bool inFlight = false;
+			bool transferDone = false;
+		};
+
+		// Returns the offset of the reserved range in the ring, or UINT64_MAX if it doesn't fit
+		[[nodiscard]] VkDeviceSize allocate(VkDeviceSize size);
+		void stage(Copy& copy, const void* data);
+		[[nodiscard]] Staging createStaging(VkDeviceSize size, void** mapped, bool* coherent) const;
+		[[nodiscard]] uint32_t getFreeBatch();
+		void recordTransfer(const Batch& batch) const;
+
+		uint32_t m_device = UINT32_MAX;
+		QueueSelection m_queue{};
+		uint32_t m_graphicsFamily = UINT32_MAX;
+		VkCommandPool m_commandPool = VK_NULL_HANDLE;
+
+		Staging m_ring{};
+		uint8_t* m_mapped = nullptr;
+		bool m_coherent = true;
+		VkDeviceSize m_capacity = 0;
+		VkDeviceSize m_head = 0;
+		VkDeviceSize m_used = 0;
+
+		std::vector<Copy> m_pending{};
+		std::vector<Staging> m_pendingDedicated{};
+		VkDeviceSize m_pendingBytes = 0;
+
+		std::vector<Batch> m_batches{};
+		uint32_t m_currentBatch = UINT32_MAX;
+		uint64_t m_nextTicket = 1;
+		uint64_t m_completedTicket = 0;
+	};
+} // namespace gflow
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gflow
+{
+	// Fixed set of threads that run indexed jobs in bulk. The thread calling parallelFor works as worker 0, so a pool
+	// of N workers only spawns N - 1 threads
+	class WorkerPool
+	{
+	public:
+		using Job = std::function<void(uint32_t index, uint32_t worker)>;
+
+		explicit WorkerPool(uint32_t workerCount);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		// Runs job for every index in [0, count) and returns once all of them are done. Jobs are picked in index order
+		// but which worker runs each one is not deterministic. The first exception thrown by a job is rethrown here
+		void parallelFor(uint32_t count, const Job& job);
+
+		[[nodiscard]] uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_threads.size()) + 1; }
+
+	private:
+		void workerLoop(uint32_t worker);
+		void runJobs(uint32_t worker);
+
+		std::vector<std::thread> m_threads{};
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+
+		const Job* m_job = nullptr;
+		uint32_t m_count = 0;
+		std::atomic<uint32_t> m_next{ 0 };
+		uint64_t m_generation = 0;
+		uint32_t m_busy = 0;
+		bool m_stop = false;
+		std::exception_ptr m_error{};
+	};
+} // namespace gflow
@@ -0,0 +1,240 @@
+#include "barrier_solver.hpp"
+
+#include <stdexcept>
+
+#include "vulkan_command_buffer.hpp"
+
+namespace gflow
+{
+	static constexpr VkAccessFlags c_writeAccess = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+		| VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	// Handles are stored as integers so the same maps work on 32 bit builds, where non dispatchable handles are not pointers
+	template <typename T>
+	static uint64_t toKey(const T handle)
+	{
+		return (uint64_t)handle;
+	}
+
+	void BarrierSolver::useImage(const VkImage image, const VkImageAspectFlags aspect, const VkPipelineStageFlags stages, const VkAccessFlags access, const VkImageLayout layout, const bool discard)
+	{
+		State& state = m_images[toKey(image)];
+		state.aspect |= aspect;
+		addRequest(m_pendingImages, toKey(image), stages, access, layout, discard);
+	}
+
+	void BarrierSolver::useBuffer(const VkBuffer buffer, const VkPipelineStageFlags stages, const VkAccessFlags access)
+	{
+		m_buffers.try_emplace(toKey(buffer));
+		addRequest(m_pendingBuffers, toKey(buffer), stages, access, VK_IMAGE_LAYOUT_UNDEFINED, false);
+	}
+
+	void BarrierSolver::markImage(const VkImage image, const VkImageAspectFlags aspect, const VkPipelineStageFlags stages, const VkAccessFlags access, const VkImageLayout layout)
+	{
+		State& state = m_images[toKey(image)];
+		state.aspect |= aspect;
+		mark(state, stages, access, layout);
+	}
+
+	void BarrierSolver::markBuffer(const VkBuffer buffer, const VkPipelineStageFlags stages, const VkAccessFlags access)
+	{
+		mark(m_buffers[toKey(buffer)], stages, access, VK_IMAGE_LAYOUT_UNDEFINED);
+	}
+
+	void BarrierSolver::aliasImage(const VkImage previous, const VkImage next)
+	{
+		const auto it = m_images.find(toKey(previous));
+		if (it == m_images.end()) return;
+
+		const State& previousState = it->second;
+		State& state = m_images[toKey(next)];
+		state.writeStages = previousState.writeStages;
+		state.writeAccess = previousState.writeAccess;
+		state.readStages = previousState.readStages;
+		state.visibleStages = 0;
+		state.visibleAccess = 0;
+	}
+
+	void BarrierSolver::forget(const VkImage image)
+	{
+		m_images.erase(toKey(image));
+		m_pendingImages.erase(toKey(image));
+	}
+
+	void BarrierSolver::forget(const VkBuffer buffer)
+	{
+		m_buffers.erase(toKey(buffer));
+		m_pendingBuffers.erase(toKey(buffer));
+	}
+
+	VkImageLayout BarrierSolver::getLayout(const VkImage image) const
+	{
+		const auto it = m_images.find(toKey(image));
+		return it != m_images.end() ? it->second.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+	}
+
+	void BarrierSolver::addRequest(std::unordered_map<uint64_t, Request>& pending, const uint64_t handle, const VkPipelineStageFlags stages, const VkAccessFlags access, const VkImageLayout layout, const bool discard)
+	{
+		const auto [it, inserted] = pending.try_emplace(handle, Request{ stages, access, layout, discard });
+		if (inserted) return;
+
+		// Two uses of the same resource in one batch happen at the same time, so they must agree on the layout
+		Request& request = it->second;
+		if (request.layout != layout)
+			throw std::runtime_error("Conflicting layouts requested for the same image in one barrier batch");
+		request.stages |= stages;
+		request.access |= access;
+		request.discard &= discard;
+	}
+
+	BarrierSolver::Hazard BarrierSolver::solve(State& state, const Request& request, const bool isImage)
+	{
+		Hazard hazard{};
+		hazard.oldLayout = request.discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+
+		const bool transition = isImage && request.layout != state.layout;
+		const bool writes = (request.access & c_writeAccess) != 0;
+
+		if (transition || writes)
+		{
+			// Reads since the last write were already ordered after it, so waiting on them chains with the write and
+			// only needs an execution dependency. Otherwise this is a write after write
+			if (state.readStages != 0)
+			{
+				hazard.srcStages = state.readStages;
+				hazard.srcAccess = 0;
+			}
+			else
+			{
+				hazard.srcStages = state.writeStages;
+				hazard.srcAccess = state.writeAccess;
+			}
+			hazard.needed = transition || hazard.srcStages != 0;
+
+			state.layout = request.layout;
+			if (writes)
+			{
+				state.writeStages = request.stages;
+				state.writeAccess = request.access & c_writeAccess;
+				state.readStages = 0;
+				state.visibleStages = 0;
+				state.visibleAccess = 0;
+			}
+			else
+			{
+				// The transition itself is a write that is complete and visible for the stages that waited on it
+				state.writeStages = request.stages;
+				state.writeAccess = 0;
+				state.readStages = request.stages;
+				state.visibleStages = request.stages;
+				state.visibleAccess = request.access;
+			}
+			return hazard;
+		}
+
+		// Read after write, only if the write has not been made visible to these stages yet
+		const bool visible = (request.stages & ~state.visibleStages) == 0 && (request.access & ~state.visibleAccess) == 0;
+		if (state.writeStages != 0 && !visible)
+		{
+			hazard.needed = true;
+			hazard.srcStages = state.writeStages;
+			hazard.srcAccess = state.writeAccess;
+			state.visibleStages |= request.stages;
+			state.visibleAccess |= request.access;
+		}
+		state.readStages |= request.stages;
+		return hazard;
+	}
+
+	void BarrierSolver::mark(State& state, const VkPipelineStageFlags stages, const VkAccessFlags access, const VkImageLayout layout)
+	{
+		state.layout = layout;
+		if (access & c_writeAccess)
+		{
+			state.writeStages = stages;
+			state.writeAccess = access & c_writeAccess;
+			state.readStages = 0;
+			state.visibleStages = 0;
+			state.visibleAccess = 0;
+		}
+		else
+		{
+			state.readStages |= stages;
+		}
+	}
+
+	BarrierSolver::Batch BarrierSolver::resolve()
+	{
+		Batch batch{};
+		for (const auto& [handle, request] : m_pendingImages)
+		{
+			State& state = m_images[handle];
+			const Hazard hazard = solve(state, request, true);
+			if (!hazard.needed) continue;
+
+			VkImageMemoryBarrier& barrier = batch.images.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = hazard.srcAccess;
+			barrier.dstAccessMask = request.access;
+			barrier.oldLayout = hazard.oldLayout;
+			barrier.newLayout = request.layout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = (VkImage)handle;
+			barrier.subresourceRange = { state.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+
+			batch.srcStages |= hazard.srcStages;
+			batch.dstStages |= request.stages;
+			if (barrier.oldLayout != barrier.newLayout)
+				m_currentFrame.layoutTransitions++;
+		}
+		for (const auto& [handle, request] : m_pendingBuffers)
+		{
+			const Hazard hazard = solve(m_buffers[handle], request, false);
+			if (!hazard.needed) continue;
+
+			VkBufferMemoryBarrier& barrier = batch.buffers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = hazard.srcAccess;
+			barrier.dstAccessMask = request.access;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.buffer = (VkBuffer)handle;
+			barrier.offset = 0;
+			barrier.size = VK_WHOLE_SIZE;
+
+			batch.srcStages |= hazard.srcStages;
+			batch.dstStages |= request.stages;
+		}
+		m_pendingImages.clear();
+		m_pendingBuffers.clear();
+
+		if (batch.empty()) return batch;
+
+		// A first use with a layout transition has nothing to wait on, but the stage mask can't be empty
+		if (batch.srcStages == 0)
+			batch.srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+		m_currentFrame.batches++;
+		m_currentFrame.imageBarriers += static_cast<uint32_t>(batch.images.size());
+		m_currentFrame.bufferBarriers += static_cast<uint32_t>(batch.buffers.size());
+		return batch;
+	}
+
+	void BarrierSolver::flush(const VulkanCommandBuffer& commandBuffer)
+	{
+		const Batch batch = resolve();
+		if (batch.empty()) return;
+
+		vkCmdPipelineBarrier(*commandBuffer, batch.srcStages, batch.dstStages, 0,
+			0, nullptr,
+			static_cast<uint32_t>(batch.buffers.size()), batch.buffers.data(),
+			static_cast<uint32_t>(batch.images.size()), batch.images.data());
+	}
+
+	void BarrierSolver::beginFrame()
+	{
+		m_lastFrame = m_currentFrame;
+		m_currentFrame = {};
+	}
+} // namespace gflow
@@ -65,6 +65,11 @@ namespace gflow
 		return VulkanContext::getHandle();
 	}
 
+	void Context::setGPUCachePath(const std::string& path)
+	{
+		m_gpuCache.setPath(path);
+	}
+
 	void Context::destroy()
 	{
 		VulkanContext::free();
@@ -1,10 +1,27 @@
 #include "core_project.hpp"
 
 #include <fstream>
+#include <stdexcept>
 
 
 namespace gflow
 {
+	template <typename T>
+	static T readValue(std::ifstream& file)
+	{
+		T value{};
+		file.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return value;
+	}
+
+	static std::string readString(std::ifstream& file)
+	{
+		const uint16_t size = readValue<uint16_t>(file);
+		std::string str(size, '\0');
+		file.read(str.data(), size);
+		return str;
+	}
+
 	Project::Project(const std::string& path, const uint32_t environment)
 			: m_path(path), m_environment(environment)
 	{
@@ -16,9 +33,20 @@ namespace gflow
 		file.read(reinterpret_cast<char*>(&m_fileStructure.requirementsPos), sizeof(size_t));
 		file.read(reinterpret_cast<char*>(&m_fileStructure.renderPassPos), sizeof(size_t));
 		file.read(reinterpret_cast<char*>(&m_fileStructure.resourcesPos), sizeof(size_t));
+
+		loadResources(file);
+		loadRenderpasses(file);
 		file.close();
 	}
 
+	std::string Project::getDirectory() const
+	{
+		const size_t pos = m_path.find_last_of("/\\");
+		if (pos == std::string::npos)
+			return "";
+		return m_path.substr(0, pos + 1);
+	}
+
 	Project::Requirements Project::getRequirements() const
 	{
 		Requirements requirements{};
@@ -41,6 +69,103 @@ namespace gflow
 		return requirements;
 	}
 
+	// The editor writes this file with ProjectExporter (GFlow_Editor/src/project_exporter.cpp), keep both sides in sync
+	// Resources section layout:
+	//   uint16 imageCount, then per image:
+	//     string id, uint32 format, uint8 source, bool matchScreen, uint32 width, uint32 height, float[4] color, string path
+	//   uint16 pipelineCount, then per pipeline:
+	//     string vertex, string fragment, uint32 topology, uint32 polygonMode, uint32 cullMode, uint32 frontFace,
+	//     bool depthTestEnable, uint32 depthCompareOp,
+	//     uint16 blendAttachmentCount + VkPipelineColorBlendAttachmentState[], uint16 pushConstantCount + VkPushConstantRange[]
+	// Strings are stored as uint16 size followed by the characters, same as the requirements section
+	void Project::loadResources(std::ifstream& file)
+	{
+		if (m_fileStructure.resourcesPos == 0) return;
+		file.seekg(m_fileStructure.resourcesPos);
+
+		const uint16_t imageCount = readValue<uint16_t>(file);
+		m_images.resize(imageCount);
+		for (Image& image : m_images)
+		{
+			image.id = readString(file);
+			image.format = static_cast<VkFormat>(readValue<uint32_t>(file));
+			image.source = static_cast<Image::Source>(readValue<uint8_t>(file));
+			image.matchScreen = readValue<bool>(file);
+			image.size.width = readValue<uint32_t>(file);
+			image.size.height = readValue<uint32_t>(file);
+			file.read(reinterpret_cast<char*>(image.color), sizeof(image.color));
+			image.path = readString(file);
+		}
+
+		const uint16_t pipelineCount = readValue<uint16_t>(file);
+		m_pipelines.resize(pipelineCount);
+		for (Pipeline& pipeline : m_pipelines)
+		{
+			pipeline.vertexPath = readString(file);
+			pipeline.fragmentPath = readString(file);
+			pipeline.topology = static_cast<VkPrimitiveTopology>(readValue<uint32_t>(file));
+			pipeline.polygonMode = static_cast<VkPolygonMode>(readValue<uint32_t>(file));
+			pipeline.cullMode = readValue<uint32_t>(file);
+			pipeline.frontFace = static_cast<VkFrontFace>(readValue<uint32_t>(file));
+			pipeline.depthTestEnable = readValue<bool>(file);
+			pipeline.depthCompareOp = static_cast<VkCompareOp>(readValue<uint32_t>(file));
+
+			pipeline.blendAttachments.resize(readValue<uint16_t>(file));
+			file.read(reinterpret_cast<char*>(pipeline.blendAttachments.data()), static_cast<std::streamsize>(pipeline.blendAttachments.size() * sizeof(VkPipelineColorBlendAttachmentState)));
+
+			pipeline.pushConstantRanges.resize(readValue<uint16_t>(file));
+			file.read(reinterpret_cast<char*>(pipeline.pushConstantRanges.data()), static_cast<std::streamsize>(pipeline.pushConstantRanges.size() * sizeof(VkPushConstantRange)));
+		}
+	}
+
+	// Render pass section layout, stored in execution order:
+	//   uint16 renderpassCount, then per renderpass:
+	//     uint16 attachmentCount, then per attachment: uint16 image, bool clear
+	//     uint16 subpassCount, then per subpass:
+	//       uint16 referenceCount, then per reference: uint16 attachment, uint8 type
+	//       uint16 drawCallCount, then per draw call: uint16 pipeline, uint32 vertexCount
+	void Project::loadRenderpasses(std::ifstream& file)
+	{
+		if (m_fileStructure.renderPassPos == 0) return;
+		file.seekg(m_fileStructure.renderPassPos);
+
+		const uint16_t renderpassCount = readValue<uint16_t>(file);
+		m_renderpasses.resize(renderpassCount);
+		for (Renderpass& renderpass : m_renderpasses)
+		{
+			renderpass.attachments.resize(readValue<uint16_t>(file));
+			for (Attachment& attachment : renderpass.attachments)
+			{
+				attachment.image = readValue<uint16_t>(file);
+				attachment.clear = readValue<bool>(file);
+				if (attachment.image >= m_images.size())
+					throw std::runtime_error("Render pass attachment references unknown image in project file: " + m_path);
+			}
+
+			renderpass.subpasses.resize(readValue<uint16_t>(file));
+			for (Subpass& subpass : renderpass.subpasses)
+			{
+				subpass.attachments.resize(readValue<uint16_t>(file));
+				for (AttachmentReference& reference : subpass.attachments)
+				{
+					reference.attachment = readValue<uint16_t>(file);
+					reference.type = static_cast<AttachmentReference::Type>(readValue<uint8_t>(file));
+					if (reference.attachment >= renderpass.attachments.size())
+						throw std::runtime_error("Subpass references unknown attachment in project file: " + m_path);
+				}
+
+				subpass.drawCalls.resize(readValue<uint16_t>(file));
+				for (DrawCall& drawCall : subpass.drawCalls)
+				{
+					drawCall.pipeline = readValue<uint16_t>(file);
+					drawCall.vertexCount = readValue<uint32_t>(file);
+					if (drawCall.pipeline >= m_pipelines.size())
+						throw std::runtime_error("Draw call references unknown pipeline in project file: " + m_path);
+				}
+			}
+		}
+	}
+
 	void Project::Requirements::operator+=(const Requirements& other)
 	{
 		uint8_t* featurePtr = reinterpret_cast<uint8_t*>(&features);
@@ -59,4 +184,4 @@ namespace gflow
 			extensions.insert(extension);
 		}
 	}
-} // namespace gflow
\ No newline at end of file
+} // namespace gflow
@@ -0,0 +1,213 @@
+#include "descriptor_allocator.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	DescriptorAllocator::DescriptorAllocator(const uint32_t device)
+		: m_device(device)
+	{
+
+	}
+
+	size_t DescriptorAllocator::SignatureHash::operator()(const std::vector<Binding>& bindings) const
+	{
+		size_t hash = bindings.size();
+		for (const Binding& binding : bindings)
+		{
+			for (const size_t value : { size_t{ binding.binding }, static_cast<size_t>(binding.type), size_t{ binding.count }, size_t{ binding.stages } })
+				hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+
+	std::vector<DescriptorAllocator::Binding> DescriptorAllocator::mergeStages(const std::vector<std::vector<Binding>>& stages)
+	{
+		std::vector<Binding> merged{};
+		for (const std::vector<Binding>& stage : stages)
+		{
+			for (const Binding& binding : stage)
+			{
+				const auto it = std::ranges::find(merged, binding.binding, &Binding::binding);
+				if (it == merged.end())
+				{
+					merged.push_back(binding);
+					continue;
+				}
+				if (it->type != binding.type || it->count != binding.count)
+					throw std::runtime_error("Shader stages disagree on descriptor binding " + std::to_string(binding.binding));
+				it->stages |= binding.stages;
+			}
+		}
+		return merged;
+	}
+
+	VkDescriptorSetLayout DescriptorAllocator::getLayout(std::vector<Binding> bindings)
+	{
+		std::ranges::sort(bindings, {}, &Binding::binding);
+		if (const auto it = m_layouts.find(bindings); it != m_layouts.end())
+		{
+			m_stats.layoutCacheHits++;
+			return it->second;
+		}
+
+		LayoutInfo info{};
+		std::vector<VkDescriptorSetLayoutBinding> vkBindings{};
+		vkBindings.reserve(bindings.size());
+		for (const Binding& binding : bindings)
+		{
+			if (binding.type >= c_typeCount)
+				throw std::runtime_error("Unsupported descriptor type " + std::to_string(binding.type) + " at binding " + std::to_string(binding.binding));
+			vkBindings.push_back({ binding.binding, binding.type, binding.count, binding.stages, nullptr });
+			info.descriptors[binding.type] += binding.count;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(vkBindings.size());
+		layoutInfo.pBindings = vkBindings.data();
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(*VulkanContext::getDevice(m_device), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create descriptor set layout");
+
+		m_layouts.emplace(std::move(bindings), layout);
+		m_layoutInfos.emplace(layout, info);
+		m_stats.layouts++;
+		return layout;
+	}
+
+	std::vector<VkDescriptorPoolSize> DescriptorAllocator::getPoolSizes(const std::array<uint64_t, c_typeCount>& descriptors, const uint64_t sets, const std::array<uint32_t, c_typeCount>& requested, const uint32_t setsPerPool)
+	{
+		// With nothing handed out yet the requested set is the average
+		std::vector<VkDescriptorPoolSize> sizes{};
+		for (uint32_t type = 0; type < c_typeCount; ++type)
+		{
+			const uint64_t average = sets == 0 ? static_cast<uint64_t>(requested[type]) * setsPerPool
+				: (descriptors[type] * setsPerPool + sets - 1) / sets;
+			const uint64_t count = std::max<uint64_t>(average, requested[type]);
+			if (count > 0)
+				sizes.push_back({ static_cast<VkDescriptorType>(type), static_cast<uint32_t>(std::min<uint64_t>(count, UINT32_MAX)) });
+		}
+		// Pools need at least one size even if every set of them is empty
+		if (sizes.empty())
+			sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 });
+		return sizes;
+	}
+
+	void DescriptorAllocator::createPool(Chain& chain, const LayoutInfo& requested)
+	{
+		if (!chain.pools.empty())
+		{
+			chain.setsPerPool = std::min(chain.setsPerPool * 2, c_maxSetsPerPool);
+			m_stats.poolGrowths++;
+		}
+
+		const std::vector<VkDescriptorPoolSize> sizes = getPoolSizes(m_stats.descriptors, m_stats.persistentSets + m_stats.frameSets, requested.descriptors, chain.setsPerPool);
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = chain.setsPerPool;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(sizes.size());
+		poolInfo.pPoolSizes = sizes.data();
+		VkDescriptorPool pool;
+		if (vkCreateDescriptorPool(*VulkanContext::getDevice(m_device), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create descriptor pool");
+
+		chain.pools.push_back(pool);
+		chain.current = chain.pools.size() - 1;
+		if (&chain == &m_persistent)
+			m_stats.persistentPools++;
+		else
+			m_stats.framePools++;
+	}
+
+	VkDescriptorSet DescriptorAllocator::allocate(const VkDescriptorSetLayout layout, const Lifetime lifetime)
+	{
+		const auto info = m_layoutInfos.find(layout);
+		if (info == m_layoutInfos.end())
+			throw std::runtime_error("Descriptor set layout was not created by this allocator");
+
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		Chain& chain = lifetime == Lifetime::PERSISTENT ? m_persistent : m_frame;
+		bool freshPool = false;
+		while (true)
+		{
+			if (chain.current >= chain.pools.size())
+			{
+				createPool(chain, info->second);
+				freshPool = true;
+			}
+
+			VkDescriptorSetAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfo.descriptorPool = chain.pools[chain.current];
+			allocInfo.descriptorSetCount = 1;
+			allocInfo.pSetLayouts = &layout;
+			VkDescriptorSet set;
+			const VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &set);
+			if (result == VK_SUCCESS)
+			{
+				for (uint32_t type = 0; type < c_typeCount; ++type)
+					m_stats.descriptors[type] += info->second.descriptors[type];
+				if (lifetime == Lifetime::PERSISTENT)
+				{
+					m_stats.persistentSets++;
+				}
+				else
+				{
+					m_stats.frameSets++;
+					m_stats.peakFrameSets = std::max(m_stats.peakFrameSets, m_stats.frameSets);
+				}
+				return set;
+			}
+
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+				throw std::runtime_error("Failed to allocate descriptor set");
+			// A pool made for this very set can't be full, something else is wrong
+			if (freshPool)
+				throw std::runtime_error("Failed to allocate descriptor set from a new pool");
+
+			m_stats.allocationFailures++;
+			chain.current++;
+		}
+	}
+
+	void DescriptorAllocator::beginFrame()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		// Sets of a reset pool are freed all at once, there is no per set bookkeeping
+		for (const VkDescriptorPool pool : m_frame.pools)
+			vkResetDescriptorPool(device, pool, 0);
+		m_frame.current = 0;
+		m_stats.frameSets = 0;
+	}
+
+	void DescriptorAllocator::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		if (m_stats.poolGrowths > 0 || m_stats.allocationFailures > 0)
+			Logger::print(Logger::DEBUG, "Descriptor pools grew ", m_stats.poolGrowths, " times after ", m_stats.allocationFailures, " failed allocations, peak of ", m_stats.peakFrameSets, " sets in a frame");
+
+		for (Chain* chain : { &m_persistent, &m_frame })
+		{
+			for (const VkDescriptorPool pool : chain->pools)
+				vkDestroyDescriptorPool(device, pool, nullptr);
+			*chain = {};
+		}
+		for (const VkDescriptorSetLayout layout : m_layouts | std::views::values)
+			vkDestroyDescriptorSetLayout(device, layout, nullptr);
+		m_layouts.clear();
+		m_layoutInfos.clear();
+		m_stats = {};
+	}
+} // namespace gflow
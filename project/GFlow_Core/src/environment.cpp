@@ -1,9 +1,12 @@
 #include "environment.hpp"
 
+#include <algorithm>
 #include <ranges>
 #include <stdexcept>
 #include <thread>
 
+#include "context.hpp"
+#include "profiler.hpp"
 #include "vulkan_context.hpp"
 #include "vulkan_device.hpp"
 #include "ext/vulkan_swapchain.hpp"
@@ -17,6 +20,19 @@ namespace gflow
 		return m_projects.back().getID();
 	}
 
+	void Environment::unloadProject(const uint32_t project)
+	{
+		const auto graph = m_renderGraphs.find(project);
+		if (graph != m_renderGraphs.end())
+		{
+			VulkanContext::getDevice(m_device).waitIdle();
+			destroyRenderGraph(graph->second);
+			m_renderGraphs.erase(graph);
+		}
+		m_readableImages.erase(project);
+		std::erase_if(m_projects, [project](const Project& loaded) { return loaded.getID() == project; });
+	}
+
 	void Environment::addSurface(const VkSurfaceKHR surface)
 	{
 		m_swapchains.emplace(surface, Swapchain());
@@ -24,7 +40,8 @@ namespace gflow
 
 	void Environment::man_manualBuild(const Project::Requirements& requirements, const uint32_t gpuOverride)
 	{
-		Logger::pushContext("Environment creation");
+		Profiler::pushContext("Environment creation");
+		const GPUCapabilities::Mask requirementMask = GPUCapabilities::compile(requirements);
 		VulkanGPU selectedGPU;
 		if (gpuOverride < VulkanContext::getGPUCount())
 		{
@@ -32,16 +49,17 @@ namespace gflow
 			std::array<VulkanGPU, 10> gpus;
 		    VulkanContext::getGPUs(gpus.data());
 			selectedGPU = gpus[gpuOverride];
-			if (!isGPUSuitable(selectedGPU, requirements))
+			if (!isGPUSuitable(selectedGPU, requirementMask))
 			{
 				Logger::print(Logger::WARN, "Invalid GPU: manually selected GPU is not suitable, searching alternative...");
-				selectedGPU = selectGPU(requirements);
+				selectedGPU = selectGPU(requirementMask);
 			}
+			Context::getGPUCache().save();
 		}
 		else
 		{
 			Logger::print(Logger::INFO, "Automatically selecting GPU");
-			selectedGPU = selectGPU(requirements);
+			selectedGPU = selectGPU(requirementMask);
 		}
 
 		const GPUQueueStructure queueStructure = selectedGPU.getQueueFamilies();
@@ -73,11 +91,23 @@ namespace gflow
 			}
 		}
 
+        // Headless environments don't need the swapchain extension, which software implementations may not expose
         VulkanDeviceExtensionManager extensions{};
-        extensions.addExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, new VulkanSwapchainExtension(m_device));
+        if (!m_swapchains.empty())
+            extensions.addExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, new VulkanSwapchainExtension(m_device));
 
-		m_device = VulkanContext::createDevice(selectedGPU, selector, &extensions, requirements.features);
+		// Pipeline statistics are only ever used by the GPU profiler, they are enabled whenever the GPU has them
+		VkPhysicalDeviceFeatures features = requirements.features;
+		features.pipelineStatisticsQuery |= selectedGPU.getFeatures().pipelineStatisticsQuery;
+		m_device = VulkanContext::createDevice(selectedGPU, selector, &extensions, features);
         VulkanDevice& device = VulkanContext::getDevice(m_device);
+		m_readbacks = ReadbackQueue{ m_device };
+		// Without a transfer queue uploads still run asynchronously to the CPU, just on the main queue
+		const QueueSelection uploadQueue = requirements.queueFlags & VK_QUEUE_TRANSFER_BIT ? m_transferQueue : m_mainQueue;
+		m_uploads = UploadQueue{ m_device, uploadQueue, m_mainQueue.familyIndex };
+		m_imagePool = ImagePool{ m_device };
+		m_descriptors = DescriptorAllocator{ m_device };
+		m_gpuProfiler = GPUProfiler{ m_device, selectedGPU, m_mainQueue.familyIndex, features.pipelineStatisticsQuery == VK_TRUE };
 
 		QueueFamily queueFamily = queueStructure.getQueueFamily(m_mainQueue.familyIndex);
         device.initializeCommandPool(queueFamily, 0, true);
@@ -90,7 +120,7 @@ namespace gflow
 		m_renderFinishedSemaphoreID = device.createSemaphore();
 		m_readyToPresentSemaphoerID = device.createSemaphore();
 
-		Logger::popContext();
+		Profiler::popContext();
 	}
 
 	uint32_t Environment::man_acquireSwapchainImage(const VkSurfaceKHR surface)
@@ -100,7 +130,9 @@ namespace gflow
 
         VulkanSwapchainExtension* swapchainExtension = VulkanSwapchainExtension::get(VulkanContext::getDevice(m_device));
 		VulkanSwapchain& swapchain = swapchainExtension->getSwapchain(m_swapchains[surface].id);
-		return swapchain.acquireNextImage();
+		const uint32_t image = swapchain.acquireNextImage();
+		m_swapchains[surface].acquireTime = std::chrono::steady_clock::now();
+		return image;
 	}
 
     uint32_t Environment::man_getSwapchainImage(const VkSurfaceKHR surface)
@@ -153,6 +185,11 @@ namespace gflow
 
 		device.getFence(m_inFlightFence).wait();
 		device.getFence(m_inFlightFence).reset();
+		m_completedFrames = m_submittedFrames;
+		m_readbacks.collect(m_completedFrames);
+		m_uploads.collect(m_completedFrames);
+		m_descriptors.beginFrame();
+		m_gpuProfiler.collect(m_completedFrames);
 
 		for (const VkSurfaceKHR surface : surfacesToPrepare)
 		{
@@ -164,19 +201,66 @@ namespace gflow
 		VulkanCommandBuffer& commandBuffer = device.getCommandBuffer(m_commandBuffer, 0);
 		commandBuffer.reset();
 		commandBuffer.beginRecording();
+		m_barrierSolver.beginFrame();
+		m_gpuProfiler.beginFrame(*commandBuffer, m_submittedFrames + 1);
+		m_uploads.submit(m_submittedFrames + 1);
+		m_uploads.acquire(commandBuffer, m_barrierSolver);
+
+		if (m_recordingThreads > 1 && m_recorder == nullptr)
+			m_recorder = std::make_unique<ParallelRecorder>(m_device, m_mainQueue.familyIndex, m_recordingThreads);
+		if (m_recorder != nullptr)
+			m_recorder->beginFrame();
+		m_lastRecordingStats = m_recordingStats;
+		m_recordingStats = { m_recorder != nullptr ? m_recorder->getThreadCount() : 1 };
 	}
 
-	void Environment::recordProject(uint32_t project) const
+	void Environment::recordProject(const uint32_t project)
     {
-		throw std::runtime_error("Not implemented");
+		if (m_renderExtent.width == 0 || m_renderExtent.height == 0)
+			throw std::runtime_error("Project (ID: " + std::to_string(project) + ") recorded before configuring a present target");
+
+		auto it = m_renderGraphs.find(project);
+		if (it == m_renderGraphs.end())
+			it = m_renderGraphs.emplace(project, RenderGraph{ m_device, m_renderExtent }).first;
+
+		RenderGraph& graph = it->second;
+		if (!graph.isBuilt())
+			graph.build(getProject(project), m_readableImages[project], m_imagePool, m_uploads);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		graph.record(VulkanContext::getDevice(m_device).getCommandBuffer(m_commandBuffer, 0), m_barrierSolver, m_recorder.get(),
+			m_gpuProfiler.isEnabled() ? &m_gpuProfiler : nullptr, project);
+		m_recordingStats.recordMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (m_recorder != nullptr)
+			m_recordingStats.secondaryBuffers = m_recorder->getRecordedCount();
+	}
+
+	void Environment::setRecordingThreads(const uint32_t threads)
+	{
+		m_recordingThreads = std::max(threads, 1U);
+		if (m_recorder == nullptr || m_recorder->getThreadCount() == m_recordingThreads) return;
+
+		// The buffers of the last frame may still be executing
+		VulkanContext::getDevice(m_device).waitIdle();
+		m_recorder->destroy();
+		m_recorder.reset();
 	}
 
-	void Environment::setRecordingBarrier() const
+	void Environment::setRecordingBarrier()
 	{
-        VulkanMemoryBarrierBuilder barrierBuilder{m_device, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0};
-        barrierBuilder.addAbsoluteMemoryBarrier();
+		// Whatever is recorded after the projects can only consume their images by sampling them, so only the images
+		// that aren't ready for that yet get a barrier
+		for (const RenderGraph& graph : m_renderGraphs | std::views::values)
+		{
+			for (const RenderGraph::Image& image : graph.getImages())
+			{
+				if (!image.isReadable()) continue;
+				const VkImageLayout layout = RenderGraph::isDepthStencilFormat(image.format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				m_barrierSolver.useImage(image.image, image.aspect, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, layout);
+			}
+		}
 
-		VulkanContext::getDevice(m_device).getCommandBuffer(m_commandBuffer, 0).cmdPipelineBarrier(barrierBuilder);
+		m_barrierSolver.flush(VulkanContext::getDevice(m_device).getCommandBuffer(m_commandBuffer, 0));
 	}
 
 	void Environment::endRecording()
@@ -198,8 +282,28 @@ namespace gflow
 			}
 		}
 
-		const uint32_t fence = !semaphores.empty() ? m_inFlightFence : UINT32_MAX;
-		commandBuffer.submit(graphicsQueue, semaphores, {{ m_renderFinishedSemaphoreID }}, fence);
+		const bool presenting = !semaphores.empty();
+		if (m_uploads.getWaitSemaphore() != UINT32_MAX)
+			semaphores.emplace_back(m_uploads.getWaitSemaphore(), m_uploads.getWaitStages());
+
+		// The fence is always signaled since beginRecording waits on it. The render finished semaphore is only signaled
+		// if something is going to be presented, nothing else would ever wait on it
+		if (presenting)
+			commandBuffer.submit(graphicsQueue, semaphores, {{ m_renderFinishedSemaphoreID }}, m_inFlightFence);
+		else
+			commandBuffer.submit(graphicsQueue, semaphores, {}, m_inFlightFence);
+		m_submittedFrames++;
+
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (m_lastSubmitTime != std::chrono::steady_clock::time_point{})
+		{
+			const double frameTime = std::chrono::duration<double, std::milli>(now - m_lastSubmitTime).count();
+			m_throughput.frames++;
+			m_throughput.lastFrameMs = frameTime;
+			m_throughput.averageFrameMs += (frameTime - m_throughput.averageFrameMs) / static_cast<double>(std::min<uint64_t>(m_throughput.frames, 120));
+			m_throughput.fps = m_throughput.averageFrameMs > 0.0 ? 1000.0 / m_throughput.averageFrameMs : 0.0;
+		}
+		m_lastSubmitTime = now;
 	}
 
 	void Environment::configurePresentTarget(const VkSurfaceKHR surface, const VkExtent2D windowSize)
@@ -228,7 +332,11 @@ namespace gflow
 
         const VulkanDevice& device = VulkanContext::getDevice(m_device);
 	    VulkanSwapchainExtension* swapchainExtension = VulkanSwapchainExtension::get(device);
-		m_swapchains[surface].id = swapchainExtension->createSwapchain(surface, extent, format, VK_PRESENT_MODE_FIFO_KHR);
+		const VkPresentModeKHR presentMode = selectPresentMode(surface);
+		m_swapchains[surface].id = swapchainExtension->createSwapchain(surface, extent, format, presentMode);
+		m_swapchains[surface].stats = { presentMode };
+
+		setRenderExtent(extent);
 	}
 
 	bool Environment::present(VkSurfaceKHR surface)
@@ -247,11 +355,66 @@ namespace gflow
 					Logger::print(Logger::WARN, "Swapchain (ID: ", swapchain.id, ") out of date");
 				}
 				swapchain.mustBeAwaited = false;
+
+				const double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - swapchain.acquireTime).count();
+				PresentStats& stats = swapchain.stats;
+				stats.frames++;
+				stats.lastLatencyMs = latency;
+				stats.averageLatencyMs += (latency - stats.averageLatencyMs) / static_cast<double>(std::min<uint64_t>(stats.frames, 120));
+				stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
 			}
 		}
 		return finishedCorrectly;
 	}
 
+	void Environment::setPresentPolicy(const PresentPolicy policy)
+	{
+		m_presentPolicy = policy;
+	}
+
+	Environment::PresentStats Environment::getPresentStats(const VkSurfaceKHR surface) const
+	{
+		const auto it = m_swapchains.find(surface);
+		if (it == m_swapchains.end())
+			throw std::runtime_error("Surface not found in environment (ID: " + std::to_string(getID()));
+		return it->second.stats;
+	}
+
+	VkPresentModeKHR Environment::selectPresentMode(const VkSurfaceKHR surface) const
+	{
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+		uint32_t modeCount = 0;
+		vkGetPhysicalDeviceSurfacePresentModesKHR(*device.getGPU(), surface, &modeCount, nullptr);
+		std::vector<VkPresentModeKHR> supportedModes(modeCount);
+		vkGetPhysicalDeviceSurfacePresentModesKHR(*device.getGPU(), surface, &modeCount, supportedModes.data());
+
+		std::vector<VkPresentModeKHR> preferred{};
+		switch (m_presentPolicy)
+		{
+		case PresentPolicy::LATENCY:
+			preferred = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+			break;
+		case PresentPolicy::THROUGHPUT:
+			preferred = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+			break;
+		case PresentPolicy::POWER_SAVING:
+			preferred = { VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+			break;
+		case PresentPolicy::VSYNC:
+			break;
+		}
+
+		for (const VkPresentModeKHR mode : preferred)
+		{
+			if (std::ranges::find(supportedModes, mode) != supportedModes.end())
+			{
+				Logger::print(Logger::DEBUG, "Selected present mode ", static_cast<uint32_t>(mode));
+				return mode;
+			}
+		}
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
 	uint32_t Environment::man_getSwapchain(const VkSurfaceKHR surface)
 	{
 		return m_swapchains[surface].id;
@@ -276,6 +439,20 @@ namespace gflow
 	{
 		if (m_device == UINT32_MAX) return;
 
+		flushReadbacks();
+		m_readbacks.destroy();
+		VulkanContext::getDevice(m_device).waitIdle();
+		m_uploads.destroy();
+		invalidateRenderGraphs();
+		m_imagePool.destroy();
+		m_descriptors.destroy();
+		m_gpuProfiler.destroy();
+		if (m_recorder != nullptr)
+		{
+			VulkanContext::getDevice(m_device).waitIdle();
+			m_recorder->destroy();
+			m_recorder.reset();
+		}
 		VulkanContext::freeDevice(m_device);
 		m_device = UINT32_MAX;
 	}
@@ -285,7 +462,80 @@ namespace gflow
         const VulkanDevice& device = VulkanContext::getDevice(m_device);
         VulkanSwapchainExtension* swapchainExtension = VulkanSwapchainExtension::get(device);
 		const VulkanSwapchain& swapchain = swapchainExtension->getSwapchain(m_swapchains[surface].id);
-		m_swapchains[surface].id = swapchainExtension->createSwapchain(surface, windowSize, swapchain.getFormat(), VK_PRESENT_MODE_FIFO_KHR, m_swapchains[surface].id);
+		const VkPresentModeKHR presentMode = selectPresentMode(surface);
+		m_swapchains[surface].id = swapchainExtension->createSwapchain(surface, windowSize, swapchain.getFormat(), presentMode, m_swapchains[surface].id);
+		m_swapchains[surface].stats = { presentMode };
+
+		setRenderExtent(windowSize);
+	}
+
+	void Environment::setRenderExtent(const VkExtent2D extent)
+	{
+		if (extent.width == m_renderExtent.width && extent.height == m_renderExtent.height) return;
+
+		invalidateRenderGraphs();
+		m_renderExtent = extent;
+	}
+
+	void Environment::requestReadback(const uint32_t project, const uint32_t image, ReadbackQueue::Callback callback)
+	{
+		const auto it = m_renderGraphs.find(project);
+		if (it == m_renderGraphs.end() || !it->second.isBuilt())
+			throw std::runtime_error("Project (ID: " + std::to_string(project) + ") must be recorded before reading back its images");
+
+		const std::vector<RenderGraph::Image>& images = it->second.getImages();
+		if (image >= images.size())
+			throw std::runtime_error("Image " + std::to_string(image) + " not found in project (ID: " + std::to_string(project) + ")");
+
+		const VulkanCommandBuffer& commandBuffer = VulkanContext::getDevice(m_device).getCommandBuffer(m_commandBuffer, 0);
+		m_readbacks.record(commandBuffer, m_barrierSolver, images[image], project, image, m_submittedFrames + 1, std::move(callback));
+	}
+
+	void Environment::markReadable(const uint32_t project, const uint32_t image)
+	{
+		if (!m_readableImages[project].insert(image).second) return;
+
+		const auto graph = m_renderGraphs.find(project);
+		if (graph == m_renderGraphs.end() || !graph->second.isBuilt()) return;
+		VulkanContext::getDevice(m_device).waitIdle();
+		destroyRenderGraph(graph->second);
+		m_renderGraphs.erase(graph);
+	}
+
+	void Environment::requestReadback(const uint32_t project, const uint32_t image, const std::string& path)
+	{
+		requestReadback(project, image, [path](const ReadbackQueue::Readback& readback) { readback.save(path); });
+	}
+
+	void Environment::flushReadbacks()
+	{
+		if (m_submittedFrames > m_completedFrames)
+		{
+			VulkanContext::getDevice(m_device).getFence(m_inFlightFence).wait();
+			m_completedFrames = m_submittedFrames;
+		}
+		m_readbacks.collect(m_completedFrames);
+	}
+
+	void Environment::invalidateRenderGraphs()
+	{
+		if (m_renderGraphs.empty()) return;
+
+		VulkanContext::getDevice(m_device).waitIdle();
+		for (RenderGraph& graph : m_renderGraphs | std::views::values)
+			destroyRenderGraph(graph);
+		m_renderGraphs.clear();
+	}
+
+	void Environment::destroyRenderGraph(RenderGraph& graph)
+	{
+		// Pooled images outlive the graph, the solver keeps tracking them
+		for (const RenderGraph::Image& image : graph.getImages())
+		{
+			if (!image.pooled)
+				m_barrierSolver.forget(image.image);
+		}
+		graph.destroy();
 	}
 
     Project::Requirements Environment::getRequirements() const
@@ -300,100 +550,43 @@ namespace gflow
 		return requirements;
 	}
 
-	bool Environment::isGPUSuitable(const VulkanGPU gpu, const Project::Requirements& requirements)
+	bool Environment::isGPUSuitable(const VulkanGPU gpu, const GPUCapabilities::Mask& requirements)
 	{
-		Logger::print(Logger::DEBUG, "Checking GPU: ", gpu.getProperties().deviceName);
-
-		bool invalid = false;
-		const GPUQueueStructure queueStructure = gpu.getQueueFamilies();
-
-		// Check features
-		{
-			const VkPhysicalDeviceFeatures features = gpu.getFeatures();
-
-			const uint8_t* featurePtr = reinterpret_cast<const uint8_t*>(&features);
-			const uint8_t* requestedFeaturePtr = reinterpret_cast<const uint8_t*>(&requirements.features);
-
-			for (size_t i = 0; i < sizeof(VkPhysicalDeviceFeatures); i++)
-			{
-				if ((requestedFeaturePtr[i] & featurePtr[i]) != requestedFeaturePtr[i])
-				{
-					invalid = true;
-					break;
-				}
-			}
-			if (invalid)
-			{
-				Logger::print(Logger::INFO, "Invalid GPU: unsupported requested features");
-				return false;
-			}
-		}
-
-		// Check queue families
-		const VkQueueFlags queueFlags = requirements.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
-		if (!queueStructure.areQueueFlagsSupported(queueFlags, true) || !queueStructure.areQueueFlagsSupported(requirements.queueFlags))
+		const GPUCapabilities& capabilities = Context::getGPUCache().get(gpu);
+		Logger::print(Logger::DEBUG, "Checking GPU: ", capabilities.deviceName.data());
+		switch (capabilities.check(requirements))
 		{
+		case GPUCapabilities::Mismatch::NONE: break;
+		case GPUCapabilities::Mismatch::FEATURES:
+			Logger::print(Logger::INFO, "Invalid GPU: unsupported requested features");
+			return false;
+		case GPUCapabilities::Mismatch::QUEUE_FLAGS:
 			Logger::print(Logger::INFO, "Invalid GPU: unsupported requested queue flags");
 			return false;
+		case GPUCapabilities::Mismatch::EXTENSIONS:
+			Logger::print(Logger::INFO, "Invalid GPU: unsupported requested extensions");
+			return false;
 		}
 
-
-		// Check present
+		// Surfaces change between runs, present support is always checked on the device
 		if (requirements.present)
 		{
 			for (const auto& surface : m_swapchains | std::views::keys)
 			{
-				if (!queueStructure.isPresentSupported(surface))
-				{
-					invalid = true;
-					break;
-				}
-			}
-			if (invalid)
-			{
-				Logger::print(Logger::INFO, "Invalid GPU: unsupported present queue");
-				return false;
-			}
-		}
-
-
-		// Check extensions
-		if (!requirements.extensions.empty())
-		{
-			std::vector<VkExtensionProperties> extensions;
-            extensions.resize(gpu.getSupportedExtensionCount());
-		    gpu.getSupportedExtensions(extensions.data());
-			for (const std::string& extension : requirements.extensions)
-			{
-				bool found = false;
-				for (const VkExtensionProperties& supportedExtension : extensions)
-				{
-					if (extension == supportedExtension.extensionName)
-					{
-						found = true;
-						break;
-					}
-				}
-
-				if (!found)
+				if (!capabilities.isPresentSupported(gpu, surface))
 				{
-					invalid = true;
-					break;
+					Logger::print(Logger::INFO, "Invalid GPU: unsupported present queue");
+					return false;
 				}
 			}
-			if (invalid)
-			{
-				Logger::print(Logger::INFO, "Invalid GPU: unsupported requested extensions");
-				return false;
-			}
 		}
 
 		return true;
 	}
 
-	VulkanGPU Environment::selectGPU(const Project::Requirements& requirements)
+	VulkanGPU Environment::selectGPU(const GPUCapabilities::Mask& requirements)
 	{
-		Logger::pushContext("GPU Selection");
+		Profiler::pushContext("GPU Selection");
 		std::vector<VulkanGPU> suitableGPUs{};
         std::vector<VulkanGPU> gpus{ VulkanContext::getGPUCount() };
         VulkanContext::getGPUs(gpus.data());
@@ -402,10 +595,11 @@ namespace gflow
 			if (isGPUSuitable(gpu, requirements))
 				suitableGPUs.push_back(gpu);
 		}
+		Context::getGPUCache().save();
 
 		if (suitableGPUs.empty())
 		{
-			Logger::popContext();
+			Profiler::popContext();
 			throw std::runtime_error("No suitable GPU found");
 		}
 
@@ -413,27 +607,18 @@ namespace gflow
 
 		for (size_t i = 0; i < suitableGPUs.size(); ++i)
 		{
-			const VulkanGPU& gpu = suitableGPUs[i];
+			const GPUCapabilities& capabilities = Context::getGPUCache().get(suitableGPUs[i]);
 
 			// Discrete GPUs get automatic 10000 points
-			if (gpu.getProperties().deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+			if (capabilities.type == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
 			{
 				scores[i] += 10000;
 			}
 
 			// Add 1 point for each 10MB of local memory
-			{
-				VkPhysicalDeviceMemoryProperties properties = gpu.getMemoryProperties();
-				for (const VkMemoryHeap& memory : properties.memoryHeaps)
-				{
-					if (memory.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
-					{
-						scores[i] += static_cast<uint32_t>(memory.size / (10ULL * 1024 * 1024));
-					}
-				}
-			}
+			scores[i] += static_cast<uint32_t>(capabilities.deviceLocalMemory / (10ULL * 1024 * 1024));
 
-			Logger::print(Logger::DEBUG, "GPU ", gpu.getProperties().deviceName, " score: ", scores[i]);
+			Logger::print(Logger::DEBUG, "GPU ", capabilities.deviceName.data(), " score: ", scores[i]);
 		}
 
 		uint32_t bestGPU = 0;
@@ -445,8 +630,8 @@ namespace gflow
 			}
 		}
 
-		Logger::print(Logger::INFO, "Selected GPU: ", suitableGPUs[bestGPU].getProperties().deviceName);
-		Logger::popContext();
+		Logger::print(Logger::INFO, "Selected GPU: ", Context::getGPUCache().get(suitableGPUs[bestGPU]).deviceName.data());
+		Profiler::popContext();
 		return suitableGPUs[bestGPU];
 	}
 } // namespace gflow
\ No newline at end of file
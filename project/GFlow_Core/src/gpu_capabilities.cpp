@@ -0,0 +1,261 @@
+#include "gpu_capabilities.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	template <typename T>
+	static bool readValue(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	template <typename T>
+	static void writeValue(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	GPUCapabilities GPUCapabilities::query(const VulkanGPU gpu)
+	{
+		GPUCapabilities capabilities{};
+		const VkPhysicalDeviceProperties properties = gpu.getProperties();
+		capabilities.vendorID = properties.vendorID;
+		capabilities.deviceID = properties.deviceID;
+		capabilities.driverVersion = properties.driverVersion;
+		std::ranges::copy(properties.pipelineCacheUUID, capabilities.pipelineCacheUUID.begin());
+		std::ranges::copy(properties.deviceName, capabilities.deviceName.begin());
+		capabilities.type = properties.deviceType;
+		capabilities.features = toFeatureMask(gpu.getFeatures());
+
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(*gpu, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(*gpu, &familyCount, families.data());
+		capabilities.queueFamilyCount = familyCount;
+		for (const VkQueueFamilyProperties& family : families)
+		{
+			capabilities.queueFlags |= family.queueFlags;
+			// Every subset of the flags of the family is supported by it
+			const VkQueueFlags flags = family.queueFlags & c_queueFlagMask;
+			for (VkQueueFlags subset = flags;; subset = (subset - 1) & flags)
+			{
+				capabilities.queueFlagCombinations |= 1U << subset;
+				if (subset == 0) break;
+			}
+		}
+
+		const VkPhysicalDeviceMemoryProperties memory = gpu.getMemoryProperties();
+		for (uint32_t i = 0; i < memory.memoryHeapCount; ++i)
+		{
+			if (memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+				capabilities.deviceLocalMemory += memory.memoryHeaps[i].size;
+		}
+
+		std::vector<VkExtensionProperties> extensions(gpu.getSupportedExtensionCount());
+		gpu.getSupportedExtensions(extensions.data());
+		capabilities.extensions.reserve(extensions.size());
+		for (const VkExtensionProperties& extension : extensions)
+		{
+			const uint64_t hash = hashExtension(extension.extensionName);
+			capabilities.extensions.push_back(hash);
+			capabilities.extensionFilter |= 1ULL << (hash & 63);
+		}
+		std::ranges::sort(capabilities.extensions);
+		return capabilities;
+	}
+
+	GPUCapabilities::Mask GPUCapabilities::compile(const Project::Requirements& requirements)
+	{
+		Mask mask{};
+		mask.features = toFeatureMask(requirements.features);
+		mask.queueFlags = requirements.queueFlags;
+		mask.familyFlags = requirements.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+		mask.present = requirements.present;
+		for (const std::string& extension : requirements.extensions)
+		{
+			const uint64_t hash = hashExtension(extension.c_str());
+			mask.extensions.push_back(hash);
+			mask.extensionFilter |= 1ULL << (hash & 63);
+		}
+		std::ranges::sort(mask.extensions);
+		return mask;
+	}
+
+	uint64_t GPUCapabilities::toFeatureMask(const VkPhysicalDeviceFeatures& features)
+	{
+		const VkBool32* values = reinterpret_cast<const VkBool32*>(&features);
+		uint64_t mask = 0;
+		for (uint32_t i = 0; i < c_featureCount; ++i)
+		{
+			if (values[i] != VK_FALSE)
+				mask |= 1ULL << i;
+		}
+		return mask;
+	}
+
+	// FNV-1a
+	uint64_t GPUCapabilities::hashExtension(const char* name)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+		for (; *name != '\0'; ++name)
+		{
+			hash ^= static_cast<uint8_t>(*name);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	GPUCapabilities::Mismatch GPUCapabilities::check(const Mask& mask) const
+	{
+		if (mask.features & ~features)
+			return Mismatch::FEATURES;
+		if ((mask.queueFlags & ~queueFlags) || !(queueFlagCombinations >> (mask.familyFlags & c_queueFlagMask) & 1))
+			return Mismatch::QUEUE_FLAGS;
+		if ((mask.extensionFilter & ~extensionFilter) || !std::ranges::includes(extensions, mask.extensions))
+			return Mismatch::EXTENSIONS;
+		return Mismatch::NONE;
+	}
+
+	bool GPUCapabilities::isPresentSupported(const VulkanGPU gpu, const VkSurfaceKHR surface) const
+	{
+		for (uint32_t i = 0; i < queueFamilyCount; ++i)
+		{
+			VkBool32 supported = VK_FALSE;
+			vkGetPhysicalDeviceSurfaceSupportKHR(*gpu, i, surface, &supported);
+			if (supported) return true;
+		}
+		return false;
+	}
+
+	void GPUCapabilityCache::setPath(const std::string& path)
+	{
+		m_path = path;
+		load();
+	}
+
+	const GPUCapabilities& GPUCapabilityCache::get(const VulkanGPU gpu)
+	{
+		auto device = m_devices.find(*gpu);
+		if (device == m_devices.end())
+		{
+			const VkPhysicalDeviceProperties properties = gpu.getProperties();
+			Key key{ properties.vendorID, properties.deviceID, properties.driverVersion };
+			std::ranges::copy(properties.pipelineCacheUUID, key.pipelineCacheUUID.begin());
+			device = m_devices.emplace(*gpu, key).first;
+		}
+
+		const Key& key = device->second;
+		const auto it = m_entries.find(key);
+		if (it != m_entries.end())
+		{
+			m_stats.hits++;
+			return it->second;
+		}
+
+		m_stats.queries++;
+		m_dirty = true;
+		GPUCapabilities& entry = m_entries[key];
+		entry = GPUCapabilities::query(gpu);
+		return entry;
+	}
+
+	void GPUCapabilityCache::load()
+	{
+		m_entries.clear();
+		m_dirty = false;
+		if (m_path.empty()) return;
+
+		std::ifstream file(m_path, std::ios::binary);
+		if (!file.is_open()) return;
+
+		uint32_t magic = 0, version = 0, count = 0;
+		if (!readValue(file, magic) || !readValue(file, version) || !readValue(file, count) || magic != c_fileMagic || version != c_fileVersion)
+		{
+			Logger::print(Logger::WARN, "Ignoring GPU capability cache ", m_path, ", it was written by a different version");
+			return;
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			GPUCapabilities entry{};
+			uint32_t extensionCount = 0;
+			bool valid = readValue(file, entry.vendorID) && readValue(file, entry.deviceID) && readValue(file, entry.driverVersion)
+				&& readValue(file, entry.pipelineCacheUUID) && readValue(file, entry.deviceName) && readValue(file, entry.type) && readValue(file, entry.features)
+				&& readValue(file, entry.queueFlags) && readValue(file, entry.queueFlagCombinations) && readValue(file, entry.queueFamilyCount)
+				&& readValue(file, entry.deviceLocalMemory) && readValue(file, entry.extensionFilter) && readValue(file, extensionCount);
+			// Guards against reading a corrupt count
+			valid = valid && extensionCount <= c_maxExtensions;
+			if (valid)
+			{
+				entry.extensions.resize(extensionCount);
+				valid = static_cast<bool>(file.read(reinterpret_cast<char*>(entry.extensions.data()), extensionCount * sizeof(uint64_t)));
+			}
+			if (!valid)
+			{
+				Logger::print(Logger::WARN, "GPU capability cache ", m_path, " is truncated, ignoring it");
+				m_entries.clear();
+				return;
+			}
+			const Key key{ entry.vendorID, entry.deviceID, entry.driverVersion, entry.pipelineCacheUUID };
+			m_entries[key] = std::move(entry);
+		}
+		Logger::print(Logger::DEBUG, "Loaded capabilities of ", m_entries.size(), " GPUs from ", m_path);
+	}
+
+	void GPUCapabilityCache::save()
+	{
+		if (!m_dirty || m_path.empty()) return;
+
+		// Entries of a model seen in this run that no device reported were left behind by a driver it no longer runs
+		std::erase_if(m_entries, [&](const auto& entry)
+		{
+			bool modelSeen = false;
+			for (const Key& seen : m_devices | std::views::values)
+			{
+				if (seen == entry.first) return false;
+				modelSeen |= seen.vendorID == entry.first.vendorID && seen.deviceID == entry.first.deviceID;
+			}
+			return modelSeen;
+		});
+
+		const std::filesystem::path directory = std::filesystem::path(m_path).parent_path();
+		std::error_code error;
+		if (!directory.empty())
+			std::filesystem::create_directories(directory, error);
+
+		std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			Logger::print(Logger::WARN, "Could not write GPU capability cache ", m_path);
+			return;
+		}
+
+		writeValue(file, c_fileMagic);
+		writeValue(file, c_fileVersion);
+		writeValue(file, static_cast<uint32_t>(m_entries.size()));
+		for (const GPUCapabilities& entry : m_entries | std::views::values)
+		{
+			writeValue(file, entry.vendorID);
+			writeValue(file, entry.deviceID);
+			writeValue(file, entry.driverVersion);
+			writeValue(file, entry.pipelineCacheUUID);
+			writeValue(file, entry.deviceName);
+			writeValue(file, entry.type);
+			writeValue(file, entry.features);
+			writeValue(file, entry.queueFlags);
+			writeValue(file, entry.queueFlagCombinations);
+			writeValue(file, entry.queueFamilyCount);
+			writeValue(file, entry.deviceLocalMemory);
+			writeValue(file, entry.extensionFilter);
+			writeValue(file, static_cast<uint32_t>(entry.extensions.size()));
+			file.write(reinterpret_cast<const char*>(entry.extensions.data()), entry.extensions.size() * sizeof(uint64_t));
+		}
+		m_dirty = false;
+	}
+} // namespace gflow
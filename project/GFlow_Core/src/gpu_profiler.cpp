@@ -0,0 +1,212 @@
+#include "gpu_profiler.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	static constexpr VkQueryPipelineStatisticFlags c_statisticFlags = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+		| VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+		| VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+		| VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+	// Results come back in the order of the flag bits, which is the order of the members of PipelineStatistics
+	static constexpr uint32_t c_statisticCount = sizeof(GPUProfiler::PipelineStatistics) / sizeof(uint64_t);
+
+	void GPUProfiler::PipelineStatistics::operator+=(const PipelineStatistics& other)
+	{
+		inputAssemblyVertices += other.inputAssemblyVertices;
+		inputAssemblyPrimitives += other.inputAssemblyPrimitives;
+		vertexShaderInvocations += other.vertexShaderInvocations;
+		clippingInvocations += other.clippingInvocations;
+		clippingPrimitives += other.clippingPrimitives;
+		fragmentShaderInvocations += other.fragmentShaderInvocations;
+	}
+
+	GPUProfiler::GPUProfiler(const uint32_t device, const VulkanGPU gpu, const uint32_t queueFamily, const bool pipelineStatistics)
+		: m_device(device), m_statisticsSupported(pipelineStatistics)
+	{
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(*gpu, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(*gpu, &familyCount, families.data());
+		const uint32_t validBits = queueFamily < familyCount ? families[queueFamily].timestampValidBits : 0;
+		if (validBits == 0)
+		{
+			Logger::print(Logger::INFO, "The main queue doesn't support timestamps, GPU profiling is unavailable");
+			m_statisticsSupported = false;
+			return;
+		}
+		m_timestampMask = validBits >= 64 ? UINT64_MAX : (1ULL << validBits) - 1;
+		m_timestampPeriod = gpu.getProperties().limits.timestampPeriod;
+
+		const VkDevice vkDevice = *VulkanContext::getDevice(m_device);
+		m_slots.resize(c_frameSlots);
+		for (Slot& slot : m_slots)
+		{
+			VkQueryPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			poolInfo.queryCount = c_maxScopes * 2;
+			if (vkCreateQueryPool(vkDevice, &poolInfo, nullptr, &slot.timestamps) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create timestamp query pool");
+
+			if (!m_statisticsSupported) continue;
+			poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			poolInfo.queryCount = c_maxStatisticScopes;
+			poolInfo.pipelineStatistics = c_statisticFlags;
+			if (vkCreateQueryPool(vkDevice, &poolInfo, nullptr, &slot.statistics) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create pipeline statistics query pool");
+		}
+	}
+
+	void GPUProfiler::beginFrame(const VkCommandBuffer cmd, const uint64_t frame)
+	{
+		m_current = c_none;
+		if (!m_enabled) return;
+
+		const uint32_t slotIndex = static_cast<uint32_t>(frame % c_frameSlots);
+		Slot& slot = m_slots[slotIndex];
+		// Only possible with more frames in flight than slots, the old results are lost
+		if (slot.pending)
+			Logger::print(Logger::DEBUG, "GPU profiler dropped the results of frame ", slot.frame);
+
+		vkCmdResetQueryPool(cmd, slot.timestamps, 0, c_maxScopes * 2);
+		if (slot.statistics != VK_NULL_HANDLE)
+			vkCmdResetQueryPool(cmd, slot.statistics, 0, c_maxStatisticScopes);
+		slot.frame = frame;
+		slot.pending = true;
+		slot.scopes.clear();
+		slot.statisticCount = 0;
+		slot.droppedScopes = 0;
+		m_current = slotIndex;
+	}
+
+	uint32_t GPUProfiler::beginScope(const VkCommandBuffer cmd, const Key& key, const bool statistics)
+	{
+		if (m_current == c_none) return c_none;
+		Slot& slot = m_slots[m_current];
+		if (slot.scopes.size() == c_maxScopes)
+		{
+			slot.droppedScopes++;
+			return c_none;
+		}
+
+		const uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+		Scope& entry = slot.scopes.emplace_back(key);
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.timestamps, scope * 2);
+		if (statistics && slot.statistics != VK_NULL_HANDLE && slot.statisticCount < c_maxStatisticScopes)
+		{
+			entry.statistics = slot.statisticCount++;
+			vkCmdBeginQuery(cmd, slot.statistics, entry.statistics, 0);
+		}
+		return scope;
+	}
+
+	void GPUProfiler::endScope(const VkCommandBuffer cmd, const uint32_t scope)
+	{
+		if (m_current == c_none || scope == c_none) return;
+		const Slot& slot = m_slots[m_current];
+		if (slot.scopes[scope].statistics != c_none)
+			vkCmdEndQuery(cmd, slot.statistics, slot.scopes[scope].statistics);
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.timestamps, scope * 2 + 1);
+	}
+
+	void GPUProfiler::collect(const uint64_t completedFrame)
+	{
+		Slot* latest = nullptr;
+		for (Slot& slot : m_slots)
+		{
+			if (slot.pending && slot.frame <= completedFrame && (latest == nullptr || slot.frame > latest->frame))
+				latest = &slot;
+		}
+		if (latest == nullptr) return;
+
+		// Older finished slots are superseded, only the newest frame is kept
+		for (Slot& slot : m_slots)
+		{
+			if (slot.pending && slot.frame <= completedFrame)
+				slot.pending = false;
+		}
+
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		Frame result{ latest->frame };
+		result.droppedScopes = latest->droppedScopes;
+		const uint32_t scopeCount = static_cast<uint32_t>(latest->scopes.size());
+		if (scopeCount > 0)
+		{
+			std::vector<uint64_t> timestamps(scopeCount * 2);
+			const VkResult timestampResult = vkGetQueryPoolResults(device, latest->timestamps, 0, scopeCount * 2, timestamps.size() * sizeof(uint64_t),
+				timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+			std::vector<uint64_t> statistics(latest->statisticCount * c_statisticCount);
+			VkResult statisticsResult = VK_SUCCESS;
+			if (latest->statisticCount > 0)
+				statisticsResult = vkGetQueryPoolResults(device, latest->statistics, 0, latest->statisticCount, statistics.size() * sizeof(uint64_t),
+					statistics.data(), c_statisticCount * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+			if (timestampResult != VK_SUCCESS || statisticsResult != VK_SUCCESS)
+			{
+				Logger::print(Logger::WARN, "GPU profiler results of frame ", latest->frame, " are not available");
+				return;
+			}
+
+			result.samples.reserve(scopeCount);
+			for (uint32_t i = 0; i < scopeCount; ++i)
+			{
+				Sample& sample = result.samples.emplace_back(latest->scopes[i].key);
+				const uint64_t ticks = (timestamps[i * 2 + 1] - timestamps[i * 2]) & m_timestampMask;
+				sample.gpuMs = static_cast<double>(ticks) * m_timestampPeriod / 1000000.0;
+				if (latest->scopes[i].statistics != c_none)
+				{
+					sample.hasStatistics = true;
+					std::memcpy(&sample.statistics, statistics.data() + latest->scopes[i].statistics * c_statisticCount, sizeof(PipelineStatistics));
+				}
+			}
+		}
+
+		m_lastFrame = std::move(result);
+		m_lastIndex.clear();
+		for (uint32_t i = 0; i < m_lastFrame.samples.size(); ++i)
+			m_lastIndex[m_lastFrame.samples[i].key] = i;
+
+		// Subpasses and render passes get the statistics of their draws
+		for (const Sample& sample : m_lastFrame.samples)
+		{
+			if (!sample.hasStatistics || sample.key.drawCall == c_none) continue;
+			for (const Key parent : { Key{ sample.key.project, sample.key.renderpass, sample.key.subpass }, Key{ sample.key.project, sample.key.renderpass } })
+			{
+				const auto it = m_lastIndex.find(parent);
+				if (it == m_lastIndex.end()) continue;
+				Sample& target = m_lastFrame.samples[it->second];
+				target.hasStatistics = true;
+				target.statistics += sample.statistics;
+			}
+		}
+	}
+
+	const GPUProfiler::Sample* GPUProfiler::find(const Key& key) const
+	{
+		const auto it = m_lastIndex.find(key);
+		return it == m_lastIndex.end() ? nullptr : &m_lastFrame.samples[it->second];
+	}
+
+	void GPUProfiler::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		for (const Slot& slot : m_slots)
+		{
+			if (slot.timestamps != VK_NULL_HANDLE) vkDestroyQueryPool(device, slot.timestamps, nullptr);
+			if (slot.statistics != VK_NULL_HANDLE) vkDestroyQueryPool(device, slot.statistics, nullptr);
+		}
+		m_slots.clear();
+		m_current = c_none;
+		m_enabled = false;
+		m_lastFrame = {};
+		m_lastIndex.clear();
+	}
+} // namespace gflow
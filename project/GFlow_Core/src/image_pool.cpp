@@ -0,0 +1,233 @@
+#include "image_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ranges>
+#include <stdexcept>
+
+#include "upload_queue.hpp"
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	static constexpr VkFormat c_fallbackFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+	static uint8_t toUnorm8(const float value)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	static uint8_t toSrgb8(const float value)
+	{
+		const float linear = std::clamp(value, 0.0f, 1.0f);
+		const float encoded = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+		return static_cast<uint8_t>(std::lround(encoded * 255.0f));
+	}
+
+	// Round to nearest even is not worth it for a handful of texels, the mantissa is rounded half up
+	static uint16_t toHalf(const float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		const uint16_t sign = static_cast<uint16_t>(bits >> 16 & 0x8000);
+		const int32_t exponent = static_cast<int32_t>(bits >> 23 & 0xFF) - 127 + 15;
+		const uint32_t mantissa = bits & 0x7FFFFF;
+		if ((bits & 0x7FFFFFFF) > 0x7F800000) return sign | 0x7E00;
+		if (exponent >= 31) return sign | 0x7C00;
+		if (exponent <= 0)
+		{
+			if (exponent < -10) return sign;
+			const uint32_t full = mantissa | 0x800000;
+			const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+			return static_cast<uint16_t>(sign | (full + (1U << (shift - 1))) >> shift);
+		}
+		// A carry out of the mantissa correctly bumps the exponent
+		return static_cast<uint16_t>((sign | exponent << 10 | mantissa >> 13) + (mantissa >> 12 & 1));
+	}
+
+	ImagePool::ImagePool(const uint32_t device)
+		: m_device(device)
+	{
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.maxLod = 0.0f;
+		if (vkCreateSampler(*VulkanContext::getDevice(m_device), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create image pool sampler");
+	}
+
+	uint32_t ImagePool::encodeTexel(const VkFormat format, const float color[4], std::array<uint8_t, 16>& texel)
+	{
+		texel = {};
+		switch (format)
+		{
+		case VK_FORMAT_R8_UNORM:
+			texel[0] = toUnorm8(color[0]);
+			return 1;
+		case VK_FORMAT_R8G8_UNORM:
+			texel[0] = toUnorm8(color[0]);
+			texel[1] = toUnorm8(color[1]);
+			return 2;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		{
+			const bool srgb = format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+			const bool bgra = format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+			for (uint32_t i = 0; i < 3; ++i)
+				texel[bgra ? 2 - i : i] = srgb ? toSrgb8(color[i]) : toUnorm8(color[i]);
+			// Alpha is never sRGB encoded
+			texel[3] = toUnorm8(color[3]);
+			return 4;
+		}
+		case VK_FORMAT_R16G16B16A16_UNORM:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		{
+			uint16_t values[4];
+			for (uint32_t i = 0; i < 4; ++i)
+				values[i] = format == VK_FORMAT_R16G16B16A16_SFLOAT ? toHalf(color[i]) : static_cast<uint16_t>(std::lround(std::clamp(color[i], 0.0f, 1.0f) * 65535.0f));
+			std::memcpy(texel.data(), values, sizeof(values));
+			return 8;
+		}
+		case VK_FORMAT_R32_SFLOAT:
+			std::memcpy(texel.data(), color, sizeof(float));
+			return 4;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			std::memcpy(texel.data(), color, 4 * sizeof(float));
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	const ImagePool::Entry& ImagePool::acquire(VkFormat format, const float color[4], UploadQueue& uploads)
+	{
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+		m_stats.requests++;
+
+		std::array<uint8_t, 16> texel;
+		uint32_t texelSize = encodeTexel(format, color, texel);
+		VkFormatProperties properties{};
+		if (texelSize != 0)
+			vkGetPhysicalDeviceFormatProperties(*device.getGPU(), format, &properties);
+		if (texelSize == 0 || !(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+		{
+			format = c_fallbackFormat;
+			texelSize = encodeTexel(format, color, texel);
+		}
+
+		const auto [it, inserted] = m_entries.try_emplace({ format, texel });
+		Entry& entry = it->second;
+		if (!inserted) return entry;
+		entry.format = format;
+
+		try
+		{
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = format;
+			imageInfo.extent = { 1, 1, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			if (vkCreateImage(*device, &imageInfo, nullptr, &entry.image) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create pooled image");
+
+			VkMemoryRequirements requirements;
+			vkGetImageMemoryRequirements(*device, entry.image, &requirements);
+			const auto [memory, offset] = allocate(requirements);
+			vkBindImageMemory(*device, entry.image, memory, offset);
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = entry.image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = format;
+			viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			if (vkCreateImageView(*device, &viewInfo, nullptr, &entry.view) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create view for pooled image");
+		}
+		catch (...)
+		{
+			if (entry.image != VK_NULL_HANDLE) vkDestroyImage(*device, entry.image, nullptr);
+			m_entries.erase(it);
+			throw;
+		}
+
+		entry.ticket = uploads.uploadImage(entry.image, VK_IMAGE_ASPECT_COLOR_BIT, { 1, 1 }, texel.data(), texelSize,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		m_stats.images++;
+		return entry;
+	}
+
+	std::pair<VkDeviceMemory, VkDeviceSize> ImagePool::allocate(const VkMemoryRequirements& requirements)
+	{
+		for (Page& page : m_pages)
+		{
+			if (!(requirements.memoryTypeBits & (1 << page.memoryType))) continue;
+			const VkDeviceSize offset = (page.used + requirements.alignment - 1) / requirements.alignment * requirements.alignment;
+			if (offset + requirements.size > c_pageSize) continue;
+			page.used = offset + requirements.size;
+			return { page.memory, offset };
+		}
+
+		const VulkanDevice& device = VulkanContext::getDevice(m_device);
+		const VkPhysicalDeviceMemoryProperties memProperties = device.getGPU().getMemoryProperties();
+		Page page{};
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount && page.memoryType == UINT32_MAX; ++i)
+		{
+			if ((requirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+				page.memoryType = i;
+		}
+		if (page.memoryType == UINT32_MAX)
+			throw std::runtime_error("Failed to find suitable memory type for pooled images");
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = std::max(c_pageSize, requirements.size);
+		allocInfo.memoryTypeIndex = page.memoryType;
+		if (vkAllocateMemory(*device, &allocInfo, nullptr, &page.memory) != VK_SUCCESS)
+			throw std::runtime_error("Failed to allocate memory for pooled images");
+
+		page.used = requirements.size;
+		m_stats.memory += allocInfo.allocationSize;
+		m_pages.push_back(page);
+		return { page.memory, 0 };
+	}
+
+	void ImagePool::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		for (const Entry& entry : m_entries | std::views::values)
+		{
+			vkDestroyImageView(device, entry.view, nullptr);
+			vkDestroyImage(device, entry.image, nullptr);
+		}
+		m_entries.clear();
+
+		for (const Page& page : m_pages)
+			vkFreeMemory(device, page.memory, nullptr);
+		m_pages.clear();
+
+		if (m_sampler != VK_NULL_HANDLE)
+			vkDestroySampler(device, m_sampler, nullptr);
+		m_sampler = VK_NULL_HANDLE;
+		m_stats = {};
+	}
+} // namespace gflow
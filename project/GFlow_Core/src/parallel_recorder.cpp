@@ -0,0 +1,112 @@
+#include "parallel_recorder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+
+namespace gflow
+{
+	ParallelRecorder::ParallelRecorder(const uint32_t device, const uint32_t queueFamily, const uint32_t threadCount)
+		: m_device(device), m_workers(std::make_unique<WorkerPool>(std::max(threadCount, 1U))), m_pools(std::max(threadCount, 1U))
+	{
+		const VkDevice vkDevice = *VulkanContext::getDevice(m_device);
+		for (ThreadPool& threadPool : m_pools)
+		{
+			// Buffers are never reset one by one, the whole pool is recycled every frame
+			VkCommandPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			poolInfo.queueFamilyIndex = queueFamily;
+			if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &threadPool.pool) != VK_SUCCESS)
+			{
+				destroy();
+				throw std::runtime_error("Failed to create recording thread command pool");
+			}
+		}
+	}
+
+	void ParallelRecorder::beginFrame()
+	{
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		for (ThreadPool& threadPool : m_pools)
+		{
+			if (threadPool.used == 0) continue;
+			vkResetCommandPool(device, threadPool.pool, 0);
+			threadPool.used = 0;
+		}
+	}
+
+	std::vector<VkCommandBuffer> ParallelRecorder::record(const std::vector<Job>& jobs)
+	{
+		// Looked up once, the workers only ever touch their own pool
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		std::vector<VkCommandBuffer> buffers(jobs.size(), VK_NULL_HANDLE);
+		m_workers->parallelFor(static_cast<uint32_t>(jobs.size()), [&](const uint32_t index, const uint32_t worker)
+		{
+			const Job& job = jobs[index];
+			const VkCommandBuffer buffer = acquire(device, m_pools[worker]);
+
+			VkCommandBufferInheritanceInfo inheritance{};
+			inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritance.renderPass = job.renderPass;
+			inheritance.subpass = job.subpass;
+			inheritance.framebuffer = job.framebuffer;
+
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			beginInfo.pInheritanceInfo = &inheritance;
+			if (vkBeginCommandBuffer(buffer, &beginInfo) != VK_SUCCESS)
+				throw std::runtime_error("Failed to begin secondary command buffer");
+
+			job.record(buffer);
+
+			if (vkEndCommandBuffer(buffer) != VK_SUCCESS)
+				throw std::runtime_error("Failed to end secondary command buffer");
+			buffers[index] = buffer;
+		});
+		return buffers;
+	}
+
+	uint32_t ParallelRecorder::getRecordedCount() const
+	{
+		uint32_t count = 0;
+		for (const ThreadPool& threadPool : m_pools)
+			count += threadPool.used;
+		return count;
+	}
+
+	VkCommandBuffer ParallelRecorder::acquire(const VkDevice device, ThreadPool& threadPool)
+	{
+		if (threadPool.used == threadPool.buffers.size())
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = threadPool.pool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer buffer;
+			if (vkAllocateCommandBuffers(device, &allocInfo, &buffer) != VK_SUCCESS)
+				throw std::runtime_error("Failed to allocate secondary command buffer");
+			threadPool.buffers.push_back(buffer);
+		}
+		return threadPool.buffers[threadPool.used++];
+	}
+
+	void ParallelRecorder::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		for (ThreadPool& threadPool : m_pools)
+		{
+			// Destroying the pool frees its buffers
+			if (threadPool.pool != VK_NULL_HANDLE)
+				vkDestroyCommandPool(device, threadPool.pool, nullptr);
+			threadPool = {};
+		}
+		m_device = UINT32_MAX;
+	}
+} // namespace gflow
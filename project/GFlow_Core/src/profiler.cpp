@@ -0,0 +1,210 @@
+#include "profiler.hpp"
+
+#if GFLOW_PROFILING
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace gflow
+{
+#if GFLOW_PROFILING
+	static constexpr uint32_t c_chunkSize = 4096;
+
+	struct ProfileEvent
+	{
+		const char* name;
+		int64_t start;
+		int64_t end;
+	};
+
+	// Filled by the owning thread only, readers see the events up to count
+	struct ProfileChunk
+	{
+		std::array<ProfileEvent, c_chunkSize> events;
+		std::atomic<uint32_t> count{ 0 };
+		std::atomic<ProfileChunk*> next{ nullptr };
+	};
+
+	struct ProfileThread
+	{
+		uint32_t id = 0;
+		ProfileChunk* head = nullptr;
+		// Everything below is only touched by the owning thread
+		ProfileChunk* tail = nullptr;
+		// A start of -1 marks a zone opened while profiling was disabled
+		std::vector<std::pair<const char*, int64_t>> open{};
+		const char* root = nullptr;
+		int64_t rootStart = -1;
+	};
+
+	static const std::chrono::steady_clock::time_point s_origin = std::chrono::steady_clock::now();
+	// Only locked when a thread records its first event and while exporting
+	static std::mutex s_threadsMutex;
+	static std::vector<std::unique_ptr<ProfileThread>> s_threads;
+	static thread_local ProfileThread* t_thread = nullptr;
+
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_origin).count();
+	}
+
+	// Buffers are kept after their thread exits so its events can still be exported
+	static ProfileThread& getThread()
+	{
+		if (t_thread != nullptr) return *t_thread;
+
+		std::unique_ptr<ProfileThread> thread = std::make_unique<ProfileThread>();
+		thread->head = new ProfileChunk();
+		thread->tail = thread->head;
+		thread->open.reserve(32);
+
+		const std::scoped_lock lock(s_threadsMutex);
+		thread->id = static_cast<uint32_t>(s_threads.size());
+		t_thread = s_threads.emplace_back(std::move(thread)).get();
+		return *t_thread;
+	}
+
+	static void record(ProfileThread& thread, const char* name, const int64_t start, const int64_t end)
+	{
+		ProfileChunk* chunk = thread.tail;
+		uint32_t count = chunk->count.load(std::memory_order_relaxed);
+		if (count == c_chunkSize)
+		{
+			ProfileChunk* next = new ProfileChunk();
+			chunk->next.store(next, std::memory_order_release);
+			thread.tail = next;
+			chunk = next;
+			count = 0;
+		}
+		chunk->events[count] = { name, start, end };
+		chunk->count.store(count + 1, std::memory_order_release);
+	}
+
+	static void writeEscaped(std::ofstream& file, const char* text)
+	{
+		for (; *text != '\0'; ++text)
+		{
+			if (*text == '"' || *text == '\\') file << '\\' << *text;
+			else if (static_cast<unsigned char>(*text) < 0x20) file << ' ';
+			else file << *text;
+		}
+	}
+
+	void Profiler::beginZone(const char* name)
+	{
+		ProfileThread& thread = getThread();
+		thread.open.emplace_back(name, isEnabled() ? now() : -1);
+	}
+
+	void Profiler::endZone()
+	{
+		ProfileThread& thread = getThread();
+		if (thread.open.empty()) return;
+		const auto [name, start] = thread.open.back();
+		thread.open.pop_back();
+		if (start >= 0)
+			record(thread, name, start, now());
+	}
+
+	void Profiler::pushContext(const char* name)
+	{
+		Logger::pushContext(name);
+		beginZone(name);
+	}
+
+	void Profiler::popContext()
+	{
+		endZone();
+		Logger::popContext();
+	}
+
+	void Profiler::setRootContext(const char* name)
+	{
+		Logger::setRootContext(name);
+
+		ProfileThread& thread = getThread();
+		const int64_t time = now();
+		if (thread.root != nullptr && thread.rootStart >= 0)
+			record(thread, thread.root, thread.rootStart, time);
+		thread.root = name;
+		thread.rootStart = isEnabled() ? time : -1;
+	}
+
+	bool Profiler::exportChromeTrace(const std::string& path)
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+		{
+			Logger::print(Logger::WARN, "Could not write profiler trace to ", path);
+			return false;
+		}
+
+		// Timestamps are microseconds with nanosecond decimals. The default stream precision switches to scientific
+		// notation after a few seconds of uptime, which trace viewers read as a wrong time
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		uint64_t events = 0;
+		const std::scoped_lock lock(s_threadsMutex);
+		for (const std::unique_ptr<ProfileThread>& thread : s_threads)
+		{
+			file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->id
+				<< ",\"args\":{\"name\":\"Thread " << thread->id << "\"}}";
+			first = false;
+
+			for (const ProfileChunk* chunk = thread->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+			{
+				const uint32_t count = chunk->count.load(std::memory_order_acquire);
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					const ProfileEvent& event = chunk->events[i];
+					file << ",\n{\"name\":\"";
+					writeEscaped(file, event.name);
+					file << "\",\"cat\":\"gflow\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->id
+						<< ",\"ts\":" << static_cast<double>(event.start) / 1000.0
+						<< ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000.0 << "}";
+				}
+				events += count;
+			}
+		}
+		file << "\n]}\n";
+
+		Logger::print(Logger::INFO, "Exported ", events, " profiler events to ", path);
+		return true;
+	}
+
+	void Profiler::clear()
+	{
+		const std::scoped_lock lock(s_threadsMutex);
+		for (const std::unique_ptr<ProfileThread>& thread : s_threads)
+		{
+			ProfileChunk* chunk = thread->head->next.exchange(nullptr);
+			while (chunk != nullptr)
+			{
+				ProfileChunk* next = chunk->next.load();
+				delete chunk;
+				chunk = next;
+			}
+			thread->head->count.store(0);
+			thread->tail = thread->head;
+		}
+	}
+
+	uint64_t Profiler::getEventCount()
+	{
+		uint64_t events = 0;
+		const std::scoped_lock lock(s_threadsMutex);
+		for (const std::unique_ptr<ProfileThread>& thread : s_threads)
+		{
+			for (const ProfileChunk* chunk = thread->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+				events += chunk->count.load(std::memory_order_acquire);
+		}
+		return events;
+	}
+#endif
+} // namespace gflow
@@ -0,0 +1,254 @@
+#include "readback.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_command_buffer.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	ReadbackQueue::ReadbackQueue(const uint32_t device)
+		: m_device(device)
+	{
+
+	}
+
+	uint32_t ReadbackQueue::getTexelSize(const VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SRGB:
+		case VK_FORMAT_S8_UINT:
+			return 1;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R16_SFLOAT:
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+			return 2;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		case VK_FORMAT_R16G16_SFLOAT:
+		case VK_FORMAT_R32_SFLOAT:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+			return 4;
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		case VK_FORMAT_R32G32_SFLOAT:
+			return 8;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	void ReadbackQueue::record(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers, const RenderGraph::Image& image, const uint32_t project, const uint32_t imageIndex, const uint64_t frame, Callback callback)
+	{
+		if (!image.isReadable())
+			throw std::runtime_error("Image " + std::to_string(imageIndex) + " can't be read back, it is transient, pooled or its memory is reused within the frame. Mark it readable before recording");
+
+		const uint32_t texelSize = getTexelSize(image.format);
+		if (texelSize == 0)
+			throw std::runtime_error("Image " + std::to_string(imageIndex) + " has a format that can't be read back");
+
+		const VkDeviceSize size = static_cast<VkDeviceSize>(image.extent.width) * image.extent.height * texelSize;
+		const Staging staging = acquireStaging(size);
+
+		Pending& pending = m_pending.emplace_back();
+		pending.result = { project, imageIndex, image.format, image.extent };
+		pending.callback = std::move(callback);
+		pending.frame = frame;
+		pending.staging = staging;
+		pending.size = size;
+
+		barriers.useImage(image.image, image.aspect, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+		barriers.useBuffer(pending.staging.buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		barriers.flush(commandBuffer);
+
+		VkBufferImageCopy region{};
+		// Copies read a single aspect, the depth of combined depth/stencil images
+		region.imageSubresource = { (image.aspect & VK_IMAGE_ASPECT_DEPTH_BIT) ? static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT) : image.aspect, 0, 0, 1 };
+		region.imageExtent = { image.extent.width, image.extent.height, 1 };
+		vkCmdCopyImageToBuffer(*commandBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pending.staging.buffer, 1, &region);
+
+		// Make the copy visible to the host once the fence of the frame signals
+		barriers.useBuffer(pending.staging.buffer, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+		barriers.flush(commandBuffer);
+		barriers.forget(pending.staging.buffer);
+	}
+
+	void ReadbackQueue::collect(const uint64_t completedFrame)
+	{
+		if (m_pending.empty()) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		// Callbacks may request new readbacks, so finished ones are moved out before running them
+		std::vector<Pending> finished{};
+		for (auto it = m_pending.begin(); it != m_pending.end();)
+		{
+			if (it->frame <= completedFrame)
+			{
+				finished.push_back(std::move(*it));
+				it = m_pending.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		for (Pending& pending : finished)
+		{
+			if (!pending.staging.coherent)
+			{
+				const VkMappedMemoryRange range{ VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, pending.staging.memory, 0, VK_WHOLE_SIZE };
+				vkInvalidateMappedMemoryRanges(device, 1, &range);
+			}
+			pending.result.data.resize(pending.size);
+			std::memcpy(pending.result.data.data(), pending.staging.mapped, pending.size);
+			releaseStaging(pending.staging);
+
+			if (pending.callback)
+				pending.callback(pending.result);
+		}
+	}
+
+	void ReadbackQueue::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		for (const Pending& pending : m_pending)
+			destroyStaging(pending.staging);
+		if (!m_pending.empty())
+			Logger::print(Logger::WARN, "Dropped ", m_pending.size(), " unfinished readbacks");
+		m_pending.clear();
+		for (const Staging& staging : m_freeStaging)
+			destroyStaging(staging);
+		m_freeStaging.clear();
+	}
+
+	ReadbackQueue::Staging ReadbackQueue::acquireStaging(const VkDeviceSize size)
+	{
+		// Smallest free buffer the copy fits in
+		auto best = m_freeStaging.end();
+		for (auto it = m_freeStaging.begin(); it != m_freeStaging.end(); ++it)
+		{
+			if (it->capacity >= size && (best == m_freeStaging.end() || it->capacity < best->capacity))
+				best = it;
+		}
+		if (best != m_freeStaging.end())
+		{
+			const Staging staging = *best;
+			m_freeStaging.erase(best);
+			return staging;
+		}
+
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+		Staging staging{};
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (vkCreateBuffer(*device, &bufferInfo, nullptr, &staging.buffer) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create readback staging buffer");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(*device, staging.buffer, &memRequirements);
+
+		// Cached memory reads much faster from the CPU, coherent memory saves the invalidate
+		const VkPhysicalDeviceMemoryProperties memProperties = device.getGPU().getMemoryProperties();
+		uint32_t memoryType = UINT32_MAX;
+		for (const VkMemoryPropertyFlags properties : { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT })
+		{
+			for (uint32_t i = 0; i < memProperties.memoryTypeCount && memoryType == UINT32_MAX; ++i)
+			{
+				if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+					memoryType = i;
+			}
+			if (memoryType != UINT32_MAX) break;
+		}
+		if (memoryType == UINT32_MAX)
+		{
+			vkDestroyBuffer(*device, staging.buffer, nullptr);
+			throw std::runtime_error("Failed to find host visible memory for readback");
+		}
+		staging.coherent = memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = memoryType;
+		if (vkAllocateMemory(*device, &allocInfo, nullptr, &staging.memory) != VK_SUCCESS)
+		{
+			vkDestroyBuffer(*device, staging.buffer, nullptr);
+			throw std::runtime_error("Failed to allocate readback staging memory");
+		}
+		vkBindBufferMemory(*device, staging.buffer, staging.memory, 0);
+		vkMapMemory(*device, staging.memory, 0, VK_WHOLE_SIZE, 0, &staging.mapped);
+		staging.capacity = size;
+		return staging;
+	}
+
+	void ReadbackQueue::releaseStaging(const Staging& staging)
+	{
+		m_freeStaging.push_back(staging);
+		if (m_freeStaging.size() <= c_maxFreeStaging) return;
+
+		const auto smallest = std::ranges::min_element(m_freeStaging, {}, &Staging::capacity);
+		destroyStaging(*smallest);
+		m_freeStaging.erase(smallest);
+	}
+
+	void ReadbackQueue::destroyStaging(const Staging& staging) const
+	{
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		vkUnmapMemory(device, staging.memory);
+		vkDestroyBuffer(device, staging.buffer, nullptr);
+		vkFreeMemory(device, staging.memory, nullptr);
+	}
+
+	bool ReadbackQueue::Readback::save(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			Logger::print(Logger::ERR, "Failed to open readback output file: ", path);
+			return false;
+		}
+
+		const bool bgra = format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+		const bool rgba = format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+		if (!bgra && !rgba)
+		{
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			return file.good();
+		}
+
+		file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
+		std::vector<uint8_t> row(static_cast<size_t>(extent.width) * 3);
+		for (uint32_t y = 0; y < extent.height; ++y)
+		{
+			const uint8_t* src = data.data() + static_cast<size_t>(y) * extent.width * 4;
+			for (uint32_t x = 0; x < extent.width; ++x)
+			{
+				row[x * 3 + 0] = src[x * 4 + (bgra ? 2 : 0)];
+				row[x * 3 + 1] = src[x * 4 + 1];
+				row[x * 3 + 2] = src[x * 4 + (bgra ? 0 : 2)];
+			}
+			file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+		}
+		return file.good();
+	}
+} // namespace gflow
@@ -0,0 +1,918 @@
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+
+#include "profiler.hpp"
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	static constexpr VkFormat c_defaultColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+	static constexpr VkFormat c_defaultDepthFormat = VK_FORMAT_D32_SFLOAT;
+	// Large enough that a secondary command buffer is worth its overhead
+	static constexpr size_t c_drawsPerJob = 64;
+
+	RenderGraph::RenderGraph(const uint32_t device, const VkExtent2D screenExtent)
+		: m_device(device), m_screenExtent(screenExtent)
+	{
+
+	}
+
+	bool RenderGraph::isDepthFormat(const VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool RenderGraph::isStencilFormat(const VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_S8_UINT:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool RenderGraph::isDepthStencilFormat(const VkFormat format)
+	{
+		return isDepthFormat(format) || isStencilFormat(format);
+	}
+
+	VkImageAspectFlags RenderGraph::getFormatAspect(const VkFormat format)
+	{
+		if (!isDepthStencilFormat(format))
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		VkImageAspectFlags aspect = 0;
+		if (isDepthFormat(format)) aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (isStencilFormat(format)) aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		return aspect;
+	}
+
+	void RenderGraph::build(const Project& project, const std::unordered_set<uint32_t>& externalImages, ImagePool& pool, UploadQueue& uploads)
+	{
+		if (m_built) destroy();
+
+		Profiler::pushContext("Render graph build");
+		m_directory = project.getDirectory();
+		try
+		{
+			declareUsages(project);
+			for (const uint32_t image : externalImages)
+			{
+				if (image < m_images.size())
+					m_images[image].external = true;
+			}
+			createImages(project);
+			acquirePooledImages(project, pool, uploads);
+			createPipelineObjects(project);
+
+			for (uint32_t i = 0; i < m_passes.size(); ++i)
+				createPass(project, i);
+		}
+		catch (...)
+		{
+			destroy();
+			Profiler::popContext();
+			throw;
+		}
+
+		m_built = true;
+		Logger::print(Logger::DEBUG, "Built render graph with ", m_passes.size(), " passes, ", m_pipelineCache.size(), " pipelines");
+		Profiler::popContext();
+	}
+
+	void RenderGraph::declareUsages(const Project& project)
+	{
+		const std::vector<Project::Image>& images = project.getImages();
+		const std::vector<Project::Renderpass>& renderpasses = project.getRenderpasses();
+
+		m_images.clear();
+		m_images.resize(images.size());
+		for (uint32_t i = 0; i < images.size(); ++i)
+		{
+			m_images[i].format = images[i].format;
+			m_images[i].extent = images[i].matchScreen ? m_screenExtent : images[i].size;
+		}
+
+		// Formats left undefined in the project are resolved from how the image is first attached
+		for (const Project::Renderpass& renderpass : renderpasses)
+		{
+			for (const Project::Subpass& subpass : renderpass.subpasses)
+			{
+				for (const Project::AttachmentReference& reference : subpass.attachments)
+				{
+					Image& image = m_images[renderpass.attachments[reference.attachment].image];
+					if (image.format != VK_FORMAT_UNDEFINED) continue;
+					image.format = reference.type == Project::AttachmentReference::DEPTH ? c_defaultDepthFormat : c_defaultColorFormat;
+				}
+			}
+		}
+
+		m_passes.clear();
+		m_passes.reserve(renderpasses.size());
+		for (uint32_t i = 0; i < renderpasses.size(); ++i)
+		{
+			const Project::Renderpass& renderpass = renderpasses[i];
+			if (renderpass.subpasses.empty())
+			{
+				Logger::print(Logger::WARN, "Render pass ", i, " has no subpasses, skipping");
+				continue;
+			}
+
+			Pass& pass = m_passes.emplace_back();
+			pass.renderpass = i;
+			pass.usages.resize(renderpass.attachments.size());
+			for (uint32_t j = 0; j < renderpass.attachments.size(); ++j)
+			{
+				const Project::Attachment& attachment = renderpass.attachments[j];
+				ImageUsage& usage = pass.usages[j];
+				usage.image = attachment.image;
+				usage.discard = attachment.clear;
+				usage.read = !attachment.clear;
+			}
+
+			for (const Project::Subpass& subpass : renderpass.subpasses)
+			{
+				for (const Project::AttachmentReference& reference : subpass.attachments)
+				{
+					ImageUsage& usage = pass.usages[reference.attachment];
+					const bool depth = isDepthStencilFormat(m_images[usage.image].format);
+
+					VkImageLayout layout;
+					switch (reference.type)
+					{
+					case Project::AttachmentReference::DEPTH:
+						usage.stages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+						usage.access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+						usage.write = true;
+						layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+						break;
+					case Project::AttachmentReference::COLOR:
+						usage.stages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+						usage.access |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+						usage.write = true;
+						layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+						break;
+					case Project::AttachmentReference::INPUT:
+						usage.stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+						usage.access |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+						usage.read = true;
+						layout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						break;
+					default:
+						throw std::runtime_error("Unknown attachment reference type in render pass " + std::to_string(i));
+					}
+
+					if (usage.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+						usage.initialLayout = layout;
+					usage.finalLayout = layout;
+				}
+			}
+
+			// Attachments no subpass references are still loaded/cleared and stored by the pass
+			for (ImageUsage& usage : pass.usages)
+			{
+				const bool depth = isDepthStencilFormat(m_images[usage.image].format);
+				if (usage.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+				{
+					usage.initialLayout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+					usage.finalLayout = usage.initialLayout;
+				}
+				if (usage.stages == 0)
+				{
+					usage.stages = depth ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+					usage.access = depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+					usage.write = true;
+				}
+				if (usage.read && !usage.discard)
+					usage.access |= depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+			}
+		}
+	}
+
+	void RenderGraph::analyzeLifetimes(const Project& project)
+	{
+		for (uint32_t i = 0; i < m_passes.size(); ++i)
+		{
+			const Pass& pass = m_passes[i];
+			const Project::Renderpass& renderpass = project.getRenderpasses()[pass.renderpass];
+			for (const Project::Subpass& subpass : renderpass.subpasses)
+			{
+				for (const Project::AttachmentReference& reference : subpass.attachments)
+				{
+					Image& image = m_images[renderpass.attachments[reference.attachment].image];
+					switch (reference.type)
+					{
+					case Project::AttachmentReference::DEPTH: image.usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; break;
+					case Project::AttachmentReference::COLOR: image.usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; break;
+					case Project::AttachmentReference::INPUT: image.usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT; break;
+					}
+				}
+			}
+			for (const ImageUsage& usage : pass.usages)
+			{
+				Image& image = m_images[usage.image];
+				image.usage |= isDepthStencilFormat(image.format) ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+				if (image.firstPass == UINT32_MAX)
+				{
+					image.firstPass = i;
+					image.discarded = usage.discard;
+				}
+				image.lastPass = i;
+				image.consumed = usage.read && !usage.write;
+			}
+		}
+
+		// An image that lives in a single pass, starts cleared and is either consumed as an input attachment or is a depth
+		// buffer never needs to reach memory. Everything else is expected to be seen after the pass that writes it
+		for (Image& image : m_images)
+		{
+			if (image.usage == 0 || image.external || !image.discarded || image.firstPass != image.lastPass) continue;
+			if ((image.usage & VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT) || isDepthStencilFormat(image.format))
+				image.transient = true;
+		}
+	}
+
+	void RenderGraph::createImages(const Project& project)
+	{
+		analyzeLifetimes(project);
+
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		for (uint32_t i = 0; i < m_images.size(); ++i)
+		{
+			Image& image = m_images[i];
+			// Images that are never attached are not owned by the graph
+			if (image.usage == 0) continue;
+
+			if (image.transient)
+				image.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			else
+				image.usage |= VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			// Combined depth/stencil formats need both aspects in every barrier, or the stencil is left undefined
+			image.aspect = getFormatAspect(image.format);
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = image.format;
+			imageInfo.extent = { image.extent.width, image.extent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = image.usage;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			if (vkCreateImage(device, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create render graph image " + project.getImages()[i].id);
+		}
+
+		allocateMemory();
+
+		for (uint32_t i = 0; i < m_images.size(); ++i)
+		{
+			Image& image = m_images[i];
+			if (image.image == VK_NULL_HANDLE) continue;
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = image.image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = image.format;
+			viewInfo.subresourceRange = { image.aspect, 0, 1, 0, 1 };
+			if (vkCreateImageView(device, &viewInfo, nullptr, &image.view) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create view for render graph image " + project.getImages()[i].id);
+		}
+	}
+
+	void RenderGraph::acquirePooledImages(const Project& project, ImagePool& pool, UploadQueue& uploads)
+	{
+		// Only attachments are ever written, so a flat color image that is never attached holds its color forever and
+		// a single texel of it is as good as a full size image
+		for (uint32_t i = 0; i < m_images.size(); ++i)
+		{
+			Image& image = m_images[i];
+			const Project::Image& projectImage = project.getImages()[i];
+			if (image.usage != 0 || projectImage.source != Project::Image::FLAT_COLOR) continue;
+
+			const ImagePool::Entry& entry = pool.acquire(image.format, projectImage.color, uploads);
+			image.image = entry.image;
+			image.view = entry.view;
+			image.format = entry.format;
+			image.extent = { 1, 1 };
+			image.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+			image.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+			image.pooled = true;
+			m_memoryStats.pooledImages++;
+		}
+		if (m_memoryStats.pooledImages > 0)
+			Logger::print(Logger::DEBUG, "Render graph backs ", m_memoryStats.pooledImages, " flat color images with pooled texels");
+	}
+
+	void RenderGraph::allocateMemory()
+	{
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		struct Block
+		{
+			VkDeviceSize size = 0;
+			uint32_t typeBits = UINT32_MAX;
+			std::vector<uint32_t> images{};
+		};
+		std::vector<Block> blocks{};
+		std::vector<uint32_t> aliasable{};
+		std::vector<VkMemoryRequirements> requirements(m_images.size());
+
+		m_memoryStats = {};
+		for (uint32_t i = 0; i < m_images.size(); ++i)
+		{
+			Image& image = m_images[i];
+			if (image.image == VK_NULL_HANDLE) continue;
+
+			vkGetImageMemoryRequirements(device, image.image, &requirements[i]);
+			image.size = requirements[i].size;
+			m_memoryStats.unaliased += image.size;
+
+			// Only images cleared at their first use and only read at their last live entirely inside the frame. Anything
+			// else carries its contents over from the previous frame or hands them to whatever comes after the graph
+			if (image.transient || !image.discarded || !image.consumed || image.external)
+			{
+				Block& block = blocks.emplace_back();
+				block.size = image.size;
+				block.typeBits = requirements[i].memoryTypeBits;
+				block.images.push_back(i);
+			}
+			else
+			{
+				aliasable.push_back(i);
+			}
+		}
+
+		// Greedy interval packing, biggest images first, into the first block none of whose images is alive at the same time
+		std::ranges::sort(aliasable, [&](const uint32_t a, const uint32_t b) { return m_images[a].size > m_images[b].size; });
+		const size_t firstAliasBlock = blocks.size();
+		for (const uint32_t index : aliasable)
+		{
+			const Image& image = m_images[index];
+			Block* target = nullptr;
+			for (size_t i = firstAliasBlock; i < blocks.size() && !target; ++i)
+			{
+				Block& block = blocks[i];
+				if ((block.typeBits & requirements[index].memoryTypeBits) == 0) continue;
+
+				const bool overlaps = std::ranges::any_of(block.images, [&](const uint32_t other) {
+					return image.firstPass <= m_images[other].lastPass && m_images[other].firstPass <= image.lastPass;
+				});
+				if (!overlaps) target = &block;
+			}
+			if (!target)
+				target = &blocks.emplace_back();
+
+			target->size = std::max(target->size, image.size);
+			target->typeBits &= requirements[index].memoryTypeBits;
+			target->images.push_back(index);
+		}
+
+		for (Block& block : blocks)
+		{
+			const bool transient = m_images[block.images.front()].transient;
+			uint32_t memoryType = UINT32_MAX;
+			if (transient)
+				memoryType = findMemoryType(block.typeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+			if (memoryType == UINT32_MAX)
+				memoryType = findMemoryType(block.typeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			if (memoryType == UINT32_MAX)
+				throw std::runtime_error("Failed to find suitable memory type for render graph images");
+
+			VkMemoryAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = block.size;
+			allocInfo.memoryTypeIndex = memoryType;
+			VkDeviceMemory memory;
+			if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+				throw std::runtime_error("Failed to allocate memory for render graph images");
+			m_memoryBlocks.push_back(memory);
+
+			if (transient)
+			{
+				m_memoryStats.transient += block.size;
+				m_memoryStats.lazilyAllocated |= findMemoryType(block.typeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) == memoryType;
+			}
+			else
+			{
+				m_memoryStats.aliased += block.size;
+			}
+
+			std::ranges::sort(block.images, [&](const uint32_t a, const uint32_t b) { return m_images[a].firstPass < m_images[b].firstPass; });
+			for (size_t i = 0; i < block.images.size(); ++i)
+			{
+				Image& image = m_images[block.images[i]];
+				image.memory = memory;
+				vkBindImageMemory(device, image.image, memory, 0);
+
+				// Each image inherits the memory from the one before it, the first one from the last one of the previous frame
+				if (block.images.size() > 1)
+				{
+					const uint32_t previous = block.images[(i + block.images.size() - 1) % block.images.size()];
+					m_passes[image.firstPass].handoffs.emplace_back(previous, block.images[i]);
+					image.aliased = i + 1 < block.images.size();
+				}
+			}
+		}
+
+		Logger::print(Logger::INFO, "Render graph attachment memory: ", m_memoryStats.unaliased / 1024, " KB without aliasing, ",
+			(m_memoryStats.aliased + m_memoryStats.transient) / 1024, " KB with aliasing (", m_memoryStats.transient / 1024, " KB transient",
+			m_memoryStats.lazilyAllocated ? ", lazily allocated)" : ")");
+	}
+
+	void RenderGraph::createPipelineObjects(const Project& project)
+	{
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		const std::vector<Project::Pipeline>& pipelines = project.getPipelines();
+
+		// Only pipelines that are actually drawn with get their shaders loaded
+		std::vector<bool> used(pipelines.size(), false);
+		for (const Pass& pass : m_passes)
+			for (const Project::Subpass& subpass : project.getRenderpasses()[pass.renderpass].subpasses)
+				for (const Project::DrawCall& drawCall : subpass.drawCalls)
+					used[drawCall.pipeline] = true;
+
+		m_pipelineObjects.clear();
+		m_pipelineObjects.resize(pipelines.size());
+		for (uint32_t i = 0; i < pipelines.size(); ++i)
+		{
+			if (!used[i]) continue;
+			PipelineObjects& objects = m_pipelineObjects[i];
+			objects.vertex = loadShaderModule(pipelines[i].vertexPath);
+			objects.fragment = loadShaderModule(pipelines[i].fragmentPath);
+			if (objects.vertex == VK_NULL_HANDLE)
+				throw std::runtime_error("Pipeline " + std::to_string(i) + " has no vertex shader");
+
+			VkPipelineLayoutCreateInfo layoutInfo{};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pipelines[i].pushConstantRanges.size());
+			layoutInfo.pPushConstantRanges = pipelines[i].pushConstantRanges.data();
+			if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &objects.layout) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create layout for pipeline " + std::to_string(i));
+		}
+	}
+
+	void RenderGraph::createPass(const Project& project, const uint32_t passIndex)
+	{
+		Pass& pass = m_passes[passIndex];
+		const Project::Renderpass& renderpass = project.getRenderpasses()[pass.renderpass];
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		pass.extent = m_screenExtent;
+		std::vector<VkAttachmentDescription> attachments(renderpass.attachments.size());
+		std::vector<VkImageView> views(renderpass.attachments.size());
+		pass.clearValues.resize(renderpass.attachments.size());
+		for (uint32_t i = 0; i < renderpass.attachments.size(); ++i)
+		{
+			const Project::Attachment& attachment = renderpass.attachments[i];
+			const ImageUsage& usage = pass.usages[i];
+			const Image& image = m_images[attachment.image];
+
+			// Attachments enter and leave the pass in the layout of the first and last subpass that uses them. Getting
+			// them there is left to the barriers recorded around the pass, so the render pass has no external transitions
+			VkAttachmentDescription& description = attachments[i];
+			description.format = image.format;
+			description.samples = VK_SAMPLE_COUNT_1_BIT;
+			description.loadOp = attachment.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+			description.storeOp = image.transient ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+			// The stencil of combined formats is kept the same way as the depth
+			const bool stencil = isStencilFormat(image.format);
+			description.stencilLoadOp = stencil ? description.loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			description.stencilStoreOp = stencil ? description.storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			description.initialLayout = usage.initialLayout;
+			description.finalLayout = usage.finalLayout;
+
+			if (isDepthStencilFormat(image.format))
+			{
+				pass.clearValues[i].depthStencil = { 1.0f, 0 };
+			}
+			else
+			{
+				const Project::Image& projectImage = project.getImages()[attachment.image];
+				if (projectImage.source == Project::Image::FLAT_COLOR)
+					pass.clearValues[i].color = { { projectImage.color[0], projectImage.color[1], projectImage.color[2], projectImage.color[3] } };
+				else
+					pass.clearValues[i].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+			}
+
+			views[i] = image.view;
+			pass.extent.width = std::min(pass.extent.width, image.extent.width);
+			pass.extent.height = std::min(pass.extent.height, image.extent.height);
+		}
+
+		// The reference arrays must stay alive until the render pass is created
+		std::vector<std::vector<VkAttachmentReference>> colorReferences(renderpass.subpasses.size());
+		std::vector<std::vector<VkAttachmentReference>> inputReferences(renderpass.subpasses.size());
+		std::vector<VkAttachmentReference> depthReferences(renderpass.subpasses.size());
+		std::vector<VkSubpassDescription> subpasses(renderpass.subpasses.size());
+		for (uint32_t i = 0; i < renderpass.subpasses.size(); ++i)
+		{
+			bool hasDepth = false;
+			for (const Project::AttachmentReference& reference : renderpass.subpasses[i].attachments)
+			{
+				const bool depth = isDepthStencilFormat(m_images[renderpass.attachments[reference.attachment].image].format);
+				switch (reference.type)
+				{
+				case Project::AttachmentReference::DEPTH:
+					depthReferences[i] = { reference.attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+					hasDepth = true;
+					break;
+				case Project::AttachmentReference::COLOR:
+					colorReferences[i].push_back({ reference.attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+					break;
+				case Project::AttachmentReference::INPUT:
+					inputReferences[i].push_back({ reference.attachment, depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+					break;
+				}
+			}
+
+			VkSubpassDescription& description = subpasses[i];
+			description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			description.colorAttachmentCount = static_cast<uint32_t>(colorReferences[i].size());
+			description.pColorAttachments = colorReferences[i].data();
+			description.inputAttachmentCount = static_cast<uint32_t>(inputReferences[i].size());
+			description.pInputAttachments = inputReferences[i].data();
+			description.pDepthStencilAttachment = hasDepth ? &depthReferences[i] : nullptr;
+		}
+
+		std::vector<VkSubpassDependency> dependencies{};
+		for (uint32_t i = 1; i < renderpass.subpasses.size(); ++i)
+		{
+			VkSubpassDependency& dependency = dependencies.emplace_back();
+			dependency.srcSubpass = i - 1;
+			dependency.dstSubpass = i;
+			dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			dependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			dependency.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		}
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+		renderPassInfo.pSubpasses = subpasses.data();
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &pass.handle) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create render pass " + std::to_string(pass.renderpass));
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = pass.handle;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+		framebufferInfo.pAttachments = views.data();
+		framebufferInfo.width = pass.extent.width;
+		framebufferInfo.height = pass.extent.height;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &pass.framebuffer) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create framebuffer for render pass " + std::to_string(pass.renderpass));
+
+		pass.draws.resize(renderpass.subpasses.size());
+		for (uint32_t i = 0; i < renderpass.subpasses.size(); ++i)
+		{
+			for (const Project::DrawCall& drawCall : renderpass.subpasses[i].drawCalls)
+				pass.draws[i].push_back({ createPipeline(project, drawCall.pipeline, pass, i), drawCall.vertexCount });
+		}
+	}
+
+	VkPipeline RenderGraph::createPipeline(const Project& project, const uint32_t pipelineIndex, const Pass& pass, const uint32_t subpassIndex)
+	{
+		// A pipeline is bound to a render pass and subpass, so it is only shared between draws of the same subpass
+		const uint64_t key = static_cast<uint64_t>(pass.renderpass) << 40 | static_cast<uint64_t>(subpassIndex) << 20 | pipelineIndex;
+		if (const auto it = m_pipelineCache.find(key); it != m_pipelineCache.end())
+			return it->second;
+
+		const Project::Pipeline& pipeline = project.getPipelines()[pipelineIndex];
+		const Project::Subpass& subpass = project.getRenderpasses()[pass.renderpass].subpasses[subpassIndex];
+		const PipelineObjects& objects = m_pipelineObjects[pipelineIndex];
+
+		uint32_t colorCount = 0;
+		bool hasDepth = false;
+		for (const Project::AttachmentReference& reference : subpass.attachments)
+		{
+			if (reference.type == Project::AttachmentReference::COLOR) colorCount++;
+			else if (reference.type == Project::AttachmentReference::DEPTH) hasDepth = true;
+		}
+
+		std::vector<VkPipelineShaderStageCreateInfo> stages{};
+		{
+			VkPipelineShaderStageCreateInfo& stage = stages.emplace_back();
+			stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			stage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+			stage.module = objects.vertex;
+			stage.pName = "main";
+		}
+		if (objects.fragment != VK_NULL_HANDLE)
+		{
+			VkPipelineShaderStageCreateInfo& stage = stages.emplace_back();
+			stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			stage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			stage.module = objects.fragment;
+			stage.pName = "main";
+		}
+
+		VkPipelineVertexInputStateCreateInfo vertexInput{};
+		vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = pipeline.topology;
+
+		VkPipelineViewportStateCreateInfo viewportState{};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		VkPipelineRasterizationStateCreateInfo rasterization{};
+		rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterization.polygonMode = pipeline.polygonMode;
+		rasterization.cullMode = pipeline.cullMode;
+		rasterization.frontFace = pipeline.frontFace;
+		rasterization.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisample{};
+		multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineDepthStencilStateCreateInfo depthStencil{};
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencil.depthTestEnable = hasDepth && pipeline.depthTestEnable;
+		depthStencil.depthWriteEnable = hasDepth && pipeline.depthTestEnable;
+		depthStencil.depthCompareOp = pipeline.depthCompareOp;
+
+		// The blend state count has to match the subpass, missing entries default to plain writes
+		std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(colorCount);
+		for (uint32_t i = 0; i < colorCount; ++i)
+		{
+			if (i < pipeline.blendAttachments.size())
+				blendAttachments[i] = pipeline.blendAttachments[i];
+			else
+				blendAttachments[i].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		}
+
+		VkPipelineColorBlendStateCreateInfo colorBlend{};
+		colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlend.attachmentCount = colorCount;
+		colorBlend.pAttachments = blendAttachments.data();
+
+		const std::array<VkDynamicState, 2> dynamicStates{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+		pipelineInfo.pStages = stages.data();
+		pipelineInfo.pVertexInputState = &vertexInput;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterization;
+		pipelineInfo.pMultisampleState = &multisample;
+		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pColorBlendState = &colorBlend;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = objects.layout;
+		pipelineInfo.renderPass = pass.handle;
+		pipelineInfo.subpass = subpassIndex;
+
+		VkPipeline handle;
+		if (vkCreateGraphicsPipelines(*VulkanContext::getDevice(m_device), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &handle) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create pipeline " + std::to_string(pipelineIndex) + " for render pass " + std::to_string(pass.renderpass));
+
+		m_pipelineCache[key] = handle;
+		return handle;
+	}
+
+	VkShaderModule RenderGraph::loadShaderModule(const std::string& path) const
+	{
+		if (path.empty()) return VK_NULL_HANDLE;
+
+		std::ifstream file(m_directory + path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			throw std::runtime_error("Failed to open shader file: " + m_directory + path);
+
+		const std::streamsize size = file.tellg();
+		if (size <= 0 || size % sizeof(uint32_t) != 0)
+			throw std::runtime_error("Invalid SPIR-V file: " + m_directory + path);
+
+		std::vector<uint32_t> code(static_cast<size_t>(size) / sizeof(uint32_t));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(code.data()), size);
+		file.close();
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = static_cast<size_t>(size);
+		moduleInfo.pCode = code.data();
+
+		VkShaderModule module;
+		if (vkCreateShaderModule(*VulkanContext::getDevice(m_device), &moduleInfo, nullptr, &module) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create shader module: " + m_directory + path);
+		return module;
+	}
+
+	uint32_t RenderGraph::findMemoryType(const uint32_t typeBits, const VkMemoryPropertyFlags properties) const
+	{
+		const VkPhysicalDeviceMemoryProperties memProperties = VulkanContext::getDevice(m_device).getGPU().getMemoryProperties();
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+		{
+			if ((typeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		}
+		return UINT32_MAX;
+	}
+
+	void RenderGraph::record(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers, ParallelRecorder* recorder, GPUProfiler* profiler, const uint32_t project) const
+	{
+		if (!m_built)
+			throw std::runtime_error("Render graph recorded before being built");
+
+		// Subpasses are split in batches of draws that are recorded up front into secondary command buffers, the primary
+		// then only stitches them in graph order. Batches only depend on the graph, so the output doesn't change with
+		// the number of threads
+		std::vector<VkCommandBuffer> secondaries{};
+		std::vector<uint32_t> subpassJobs{};
+		if (recorder != nullptr)
+		{
+			std::vector<ParallelRecorder::Job> jobs{};
+			for (const Pass& pass : m_passes)
+			{
+				for (uint32_t subpass = 0; subpass < pass.draws.size(); ++subpass)
+				{
+					subpassJobs.push_back(static_cast<uint32_t>(jobs.size()));
+					for (size_t first = 0; first < pass.draws[subpass].size(); first += c_drawsPerJob)
+					{
+						const size_t last = std::min(first + c_drawsPerJob, pass.draws[subpass].size());
+						jobs.push_back({ pass.handle, subpass, pass.framebuffer, [&pass, subpass, first, last](const VkCommandBuffer cmd)
+						{
+							// Dynamic state is not inherited by secondary command buffers
+							setViewport(cmd, pass.extent);
+							recordDraws(cmd, pass.draws[subpass], first, last);
+						} });
+					}
+				}
+			}
+			subpassJobs.push_back(static_cast<uint32_t>(jobs.size()));
+			secondaries = recorder->record(jobs);
+		}
+
+		const VkCommandBuffer cmd = *commandBuffer;
+		const VkSubpassContents contents = recorder != nullptr ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+		uint32_t subpassIndex = 0;
+		for (const Pass& pass : m_passes)
+		{
+			for (const auto& [previous, next] : pass.handoffs)
+				barriers.aliasImage(m_images[previous].image, m_images[next].image);
+			for (const ImageUsage& usage : pass.usages)
+			{
+				const Image& image = m_images[usage.image];
+				barriers.useImage(image.image, image.aspect, usage.stages, usage.access, usage.initialLayout, usage.discard);
+			}
+			barriers.flush(commandBuffer);
+
+			const uint32_t passScope = profiler != nullptr ? profiler->beginScope(cmd, { project, pass.renderpass }, false) : GPUProfiler::c_none;
+			VkRenderPassBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			beginInfo.renderPass = pass.handle;
+			beginInfo.framebuffer = pass.framebuffer;
+			beginInfo.renderArea = { { 0, 0 }, pass.extent };
+			beginInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+			beginInfo.pClearValues = pass.clearValues.data();
+			vkCmdBeginRenderPass(cmd, &beginInfo, contents);
+
+			if (recorder == nullptr)
+				setViewport(cmd, pass.extent);
+
+			for (uint32_t i = 0; i < pass.draws.size(); ++i, ++subpassIndex)
+			{
+				if (i > 0)
+					vkCmdNextSubpass(cmd, contents);
+
+				if (recorder == nullptr && profiler == nullptr)
+				{
+					recordDraws(cmd, pass.draws[i], 0, pass.draws[i].size());
+					continue;
+				}
+				if (recorder == nullptr)
+				{
+					// Draws go one by one so each gets its own scope, statistics are only queried here since they can't nest
+					const uint32_t subpassScope = profiler->beginScope(cmd, { project, pass.renderpass, i }, false);
+					for (uint32_t draw = 0; draw < pass.draws[i].size(); ++draw)
+					{
+						const uint32_t drawScope = profiler->beginScope(cmd, { project, pass.renderpass, i, draw }, true);
+						recordDraws(cmd, pass.draws[i], draw, draw + 1);
+						profiler->endScope(cmd, drawScope);
+					}
+					profiler->endScope(cmd, subpassScope);
+					continue;
+				}
+				const uint32_t first = subpassJobs[subpassIndex];
+				const uint32_t count = subpassJobs[subpassIndex + 1] - first;
+				if (count > 0)
+					vkCmdExecuteCommands(cmd, count, secondaries.data() + first);
+			}
+			vkCmdEndRenderPass(cmd);
+			if (profiler != nullptr)
+				profiler->endScope(cmd, passScope);
+
+			for (const ImageUsage& usage : pass.usages)
+			{
+				const Image& image = m_images[usage.image];
+				barriers.markImage(image.image, image.aspect, usage.stages, usage.access, usage.finalLayout);
+			}
+		}
+	}
+
+	void RenderGraph::setViewport(const VkCommandBuffer cmd, const VkExtent2D extent)
+	{
+		const VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+		const VkRect2D scissor{ { 0, 0 }, extent };
+		vkCmdSetViewport(cmd, 0, 1, &viewport);
+		vkCmdSetScissor(cmd, 0, 1, &scissor);
+	}
+
+	void RenderGraph::recordDraws(const VkCommandBuffer cmd, const std::vector<Draw>& draws, const size_t first, const size_t last)
+	{
+		VkPipeline bound = VK_NULL_HANDLE;
+		for (size_t i = first; i < last; ++i)
+		{
+			if (draws[i].pipeline != bound)
+			{
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, draws[i].pipeline);
+				bound = draws[i].pipeline;
+			}
+			vkCmdDraw(cmd, draws[i].vertexCount, 1, 0, 0);
+		}
+	}
+
+	void RenderGraph::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		for (const VkPipeline pipeline : m_pipelineCache | std::views::values)
+			vkDestroyPipeline(device, pipeline, nullptr);
+		m_pipelineCache.clear();
+
+		for (const Pass& pass : m_passes)
+		{
+			if (pass.framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(device, pass.framebuffer, nullptr);
+			if (pass.handle != VK_NULL_HANDLE) vkDestroyRenderPass(device, pass.handle, nullptr);
+		}
+		m_passes.clear();
+
+		for (const PipelineObjects& objects : m_pipelineObjects)
+		{
+			if (objects.layout != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, objects.layout, nullptr);
+			if (objects.vertex != VK_NULL_HANDLE) vkDestroyShaderModule(device, objects.vertex, nullptr);
+			if (objects.fragment != VK_NULL_HANDLE) vkDestroyShaderModule(device, objects.fragment, nullptr);
+		}
+		m_pipelineObjects.clear();
+
+		for (const Image& image : m_images)
+		{
+			// Pooled images belong to the pool
+			if (image.pooled) continue;
+			if (image.view != VK_NULL_HANDLE) vkDestroyImageView(device, image.view, nullptr);
+			if (image.image != VK_NULL_HANDLE) vkDestroyImage(device, image.image, nullptr);
+		}
+		m_images.clear();
+
+		for (const VkDeviceMemory memory : m_memoryBlocks)
+			vkFreeMemory(device, memory, nullptr);
+		m_memoryBlocks.clear();
+
+		m_built = false;
+	}
+} // namespace gflow
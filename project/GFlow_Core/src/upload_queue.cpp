@@ -0,0 +1,463 @@
+#include "upload_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "vulkan_context.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_command_buffer.hpp"
+#include "utils/logger.hpp"
+
+namespace gflow
+{
+	// Enough for every texel size and for the 4 byte alignment of buffer to image copies
+	static constexpr VkDeviceSize c_alignment = 16;
+
+	UploadQueue::UploadQueue(const uint32_t device, const QueueSelection queue, const uint32_t graphicsFamily, const VkDeviceSize capacity)
+		: m_device(device), m_queue(queue), m_graphicsFamily(graphicsFamily), m_capacity(capacity)
+	{
+		const VkDevice vkDevice = *VulkanContext::getDevice(m_device);
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = m_queue.familyIndex;
+		if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create upload command pool");
+
+		void* mapped;
+		m_ring = createStaging(m_capacity, &mapped, &m_coherent);
+		m_mapped = static_cast<uint8_t*>(mapped);
+	}
+
+	UploadQueue::Staging UploadQueue::createStaging(const VkDeviceSize size, void** mapped, bool* coherent) const
+	{
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+		Staging staging{};
+
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (vkCreateBuffer(*device, &bufferInfo, nullptr, &staging.buffer) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create upload staging buffer");
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(*device, staging.buffer, &memRequirements);
+
+		// The CPU only ever writes sequentially, so uncached coherent memory is the best fit
+		const VkPhysicalDeviceMemoryProperties memProperties = device.getGPU().getMemoryProperties();
+		uint32_t memoryType = UINT32_MAX;
+		for (const VkMemoryPropertyFlags properties : { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT } })
+		{
+			for (uint32_t i = 0; i < memProperties.memoryTypeCount && memoryType == UINT32_MAX; ++i)
+			{
+				if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+					memoryType = i;
+			}
+			if (memoryType != UINT32_MAX) break;
+		}
+		if (memoryType == UINT32_MAX)
+		{
+			vkDestroyBuffer(*device, staging.buffer, nullptr);
+			throw std::runtime_error("Failed to find host visible memory for uploads");
+		}
+		*coherent = memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = memoryType;
+		if (vkAllocateMemory(*device, &allocInfo, nullptr, &staging.memory) != VK_SUCCESS)
+		{
+			vkDestroyBuffer(*device, staging.buffer, nullptr);
+			throw std::runtime_error("Failed to allocate upload staging memory");
+		}
+		vkBindBufferMemory(*device, staging.buffer, staging.memory, 0);
+		vkMapMemory(*device, staging.memory, 0, VK_WHOLE_SIZE, 0, mapped);
+		return staging;
+	}
+
+	VkDeviceSize UploadQueue::allocate(const VkDeviceSize size)
+	{
+		if (size > m_capacity) return UINT64_MAX;
+
+		// Ranges never wrap around, the bytes skipped at the end of the ring are charged to the allocation
+		VkDeviceSize start = (m_head + c_alignment - 1) & ~(c_alignment - 1);
+		if (start + size > m_capacity)
+			start = 0;
+		const VkDeviceSize end = start + size;
+		const VkDeviceSize consumed = start >= m_head ? end - m_head : m_capacity - m_head + end;
+		if (m_used + consumed > m_capacity) return UINT64_MAX;
+
+		m_head = end == m_capacity ? 0 : end;
+		m_used += consumed;
+		m_pendingBytes += consumed;
+		return start;
+	}
+
+	void UploadQueue::stage(Copy& copy, const void* data)
+	{
+		const VkDeviceSize offset = allocate(copy.size);
+		if (offset != UINT64_MAX)
+		{
+			std::memcpy(m_mapped + offset, data, copy.size);
+			copy.source = m_ring.buffer;
+			copy.sourceOffset = offset;
+			return;
+		}
+
+		// The ring is full of uploads the GPU hasn't consumed yet, this one gets its own buffer rather than waiting
+		void* mapped;
+		bool coherent;
+		const Staging staging = createStaging(copy.size, &mapped, &coherent);
+		std::memcpy(mapped, data, copy.size);
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+		if (!coherent)
+		{
+			const VkMappedMemoryRange range{ VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, staging.memory, 0, VK_WHOLE_SIZE };
+			vkFlushMappedMemoryRanges(device, 1, &range);
+		}
+		vkUnmapMemory(device, staging.memory);
+
+		m_pendingDedicated.push_back(staging);
+		copy.source = staging.buffer;
+		copy.sourceOffset = 0;
+	}
+
+	uint64_t UploadQueue::uploadBuffer(const VkBuffer buffer, const VkDeviceSize offset, const void* data, const VkDeviceSize size, const VkPipelineStageFlags dstStages, const VkAccessFlags dstAccess)
+	{
+		if (m_device == UINT32_MAX)
+			throw std::runtime_error("Upload requested before the environment was built");
+		if (dstStages == 0)
+			throw std::runtime_error("Uploads need the stages that will consume them");
+
+		Copy copy{};
+		copy.buffer = buffer;
+		copy.offset = offset;
+		copy.size = size;
+		copy.dstStages = dstStages;
+		copy.dstAccess = dstAccess;
+		stage(copy, data);
+		m_pending.push_back(copy);
+		return m_nextTicket;
+	}
+
+	uint64_t UploadQueue::uploadImage(const VkImage image, const VkImageAspectFlags aspect, const VkExtent2D extent, const void* data, const VkDeviceSize size, const VkImageLayout finalLayout, const VkPipelineStageFlags dstStages, const VkAccessFlags dstAccess)
+	{
+		if (m_device == UINT32_MAX)
+			throw std::runtime_error("Upload requested before the environment was built");
+		if (dstStages == 0)
+			throw std::runtime_error("Uploads need the stages that will consume them");
+
+		Copy copy{};
+		copy.image = image;
+		copy.aspect = aspect;
+		copy.extent = extent;
+		copy.finalLayout = finalLayout;
+		copy.size = size;
+		copy.dstStages = dstStages;
+		copy.dstAccess = dstAccess;
+		stage(copy, data);
+		m_pending.push_back(copy);
+		return m_nextTicket;
+	}
+
+	uint32_t UploadQueue::getFreeBatch()
+	{
+		for (uint32_t i = 0; i < m_batches.size(); ++i)
+		{
+			if (!m_batches[i].inFlight)
+				return i;
+		}
+
+		const VulkanDevice& device = VulkanContext::getDevice(m_device);
+		Batch batch{};
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(*device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("Failed to allocate upload command buffer");
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(*device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create upload fence");
+
+		// Owned by the device so the graphics submission can wait on it by ID
+		batch.semaphore = VulkanContext::getDevice(m_device).createSemaphore();
+
+		m_batches.push_back(std::move(batch));
+		return static_cast<uint32_t>(m_batches.size() - 1);
+	}
+
+	void UploadQueue::recordTransfer(const Batch& batch) const
+	{
+		const VkCommandBuffer cmd = batch.commandBuffer;
+
+		// Everything is written once and never read by this queue, so one barrier before and one after the copies is all it takes
+		std::vector<VkImageMemoryBarrier> imageBarriers{};
+		for (const Copy& copy : batch.copies)
+		{
+			if (copy.image == VK_NULL_HANDLE) continue;
+			VkImageMemoryBarrier& barrier = imageBarriers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = copy.image;
+			barrier.subresourceRange = { copy.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+		}
+		if (!imageBarriers.empty())
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+		for (const Copy& copy : batch.copies)
+		{
+			if (copy.image == VK_NULL_HANDLE)
+			{
+				const VkBufferCopy region{ copy.sourceOffset, copy.offset, copy.size };
+				vkCmdCopyBuffer(cmd, copy.source, copy.buffer, 1, &region);
+				continue;
+			}
+			VkBufferImageCopy region{};
+			region.bufferOffset = copy.sourceOffset;
+			region.imageSubresource = { copy.aspect, 0, 0, 1 };
+			region.imageExtent = { copy.extent.width, copy.extent.height, 1 };
+			vkCmdCopyBufferToImage(cmd, copy.source, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+		}
+
+		// With a dedicated transfer family this is the release half of the ownership transfer, and the layout
+		// transition is part of it. Otherwise the semaphore already makes the writes visible, only layouts are left
+		const bool release = hasOwnershipTransfer();
+		imageBarriers.clear();
+		std::vector<VkBufferMemoryBarrier> bufferBarriers{};
+		for (const Copy& copy : batch.copies)
+		{
+			if (copy.image == VK_NULL_HANDLE)
+			{
+				if (!release) continue;
+				VkBufferMemoryBarrier& barrier = bufferBarriers.emplace_back();
+				barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = 0;
+				barrier.srcQueueFamilyIndex = m_queue.familyIndex;
+				barrier.dstQueueFamilyIndex = m_graphicsFamily;
+				barrier.buffer = copy.buffer;
+				barrier.offset = copy.offset;
+				barrier.size = copy.size;
+				continue;
+			}
+			VkImageMemoryBarrier& barrier = imageBarriers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = copy.finalLayout;
+			barrier.srcQueueFamilyIndex = release ? m_queue.familyIndex : VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = release ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = copy.image;
+			barrier.subresourceRange = { copy.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+		}
+		if (!imageBarriers.empty() || !bufferBarriers.empty())
+		{
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+				static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+				static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+		}
+	}
+
+	void UploadQueue::submit(const uint64_t frame)
+	{
+		m_currentBatch = UINT32_MAX;
+		if (m_pending.empty()) return;
+
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+		if (!m_coherent)
+		{
+			const VkMappedMemoryRange range{ VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, m_ring.memory, 0, VK_WHOLE_SIZE };
+			vkFlushMappedMemoryRanges(*device, 1, &range);
+		}
+
+		const uint32_t batchIndex = getFreeBatch();
+		Batch& batch = m_batches[batchIndex];
+		batch.copies = std::move(m_pending);
+		batch.dedicated = std::move(m_pendingDedicated);
+		batch.ringBytes = m_pendingBytes;
+		batch.ticket = m_nextTicket++;
+		batch.frame = frame;
+		batch.inFlight = true;
+		batch.transferDone = false;
+		m_pending.clear();
+		m_pendingDedicated.clear();
+		m_pendingBytes = 0;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+		recordTransfer(batch);
+		vkEndCommandBuffer(batch.commandBuffer);
+
+		const VkSemaphore semaphore = *device.getSemaphore(batch.semaphore);
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.commandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &semaphore;
+		if (vkQueueSubmit(*device.getQueue(m_queue), 1, &submitInfo, batch.fence) != VK_SUCCESS)
+			throw std::runtime_error("Failed to submit uploads to the transfer queue");
+
+		m_currentBatch = batchIndex;
+	}
+
+	void UploadQueue::acquire(const VulkanCommandBuffer& commandBuffer, BarrierSolver& barriers)
+	{
+		if (m_currentBatch == UINT32_MAX) return;
+		const Batch& batch = m_batches[m_currentBatch];
+
+		std::vector<VkImageMemoryBarrier> imageBarriers{};
+		std::vector<VkBufferMemoryBarrier> bufferBarriers{};
+		VkPipelineStageFlags dstStages = 0;
+		for (const Copy& copy : batch.copies)
+		{
+			dstStages |= copy.dstStages;
+			if (copy.image != VK_NULL_HANDLE)
+				barriers.markImage(copy.image, copy.aspect, copy.dstStages, copy.dstAccess, copy.finalLayout);
+			else
+				barriers.markBuffer(copy.buffer, copy.dstStages, copy.dstAccess);
+
+			if (!hasOwnershipTransfer()) continue;
+			if (copy.image == VK_NULL_HANDLE)
+			{
+				VkBufferMemoryBarrier& barrier = bufferBarriers.emplace_back();
+				barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = copy.dstAccess;
+				barrier.srcQueueFamilyIndex = m_queue.familyIndex;
+				barrier.dstQueueFamilyIndex = m_graphicsFamily;
+				barrier.buffer = copy.buffer;
+				barrier.offset = copy.offset;
+				barrier.size = copy.size;
+				continue;
+			}
+			VkImageMemoryBarrier& barrier = imageBarriers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = copy.dstAccess;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = copy.finalLayout;
+			barrier.srcQueueFamilyIndex = m_queue.familyIndex;
+			barrier.dstQueueFamilyIndex = m_graphicsFamily;
+			barrier.image = copy.image;
+			barrier.subresourceRange = { copy.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+		}
+
+		// Chains with the semaphore wait, which happens at the same stages
+		if (!imageBarriers.empty() || !bufferBarriers.empty())
+		{
+			vkCmdPipelineBarrier(*commandBuffer, dstStages, dstStages, 0, 0, nullptr,
+				static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+				static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+		}
+	}
+
+	uint32_t UploadQueue::getWaitSemaphore() const
+	{
+		return m_currentBatch != UINT32_MAX ? m_batches[m_currentBatch].semaphore : UINT32_MAX;
+	}
+
+	VkPipelineStageFlags UploadQueue::getWaitStages() const
+	{
+		if (m_currentBatch == UINT32_MAX) return 0;
+		VkPipelineStageFlags stages = 0;
+		for (const Copy& copy : m_batches[m_currentBatch].copies)
+			stages |= copy.dstStages;
+		return stages;
+	}
+
+	void UploadQueue::collect(const uint64_t completedFrame)
+	{
+		if (m_device == UINT32_MAX) return;
+		const VkDevice device = *VulkanContext::getDevice(m_device);
+
+		uint64_t oldestPending = m_nextTicket;
+		for (Batch& batch : m_batches)
+		{
+			if (!batch.inFlight) continue;
+
+			// Polled, never waited on. The staging memory is free as soon as the copies are done
+			if (!batch.transferDone && vkGetFenceStatus(device, batch.fence) == VK_SUCCESS)
+			{
+				batch.transferDone = true;
+				m_used -= batch.ringBytes;
+				for (const Staging& staging : batch.dedicated)
+				{
+					vkDestroyBuffer(device, staging.buffer, nullptr);
+					vkFreeMemory(device, staging.memory, nullptr);
+				}
+				batch.dedicated.clear();
+			}
+			if (!batch.transferDone)
+			{
+				oldestPending = std::min(oldestPending, batch.ticket);
+				continue;
+			}
+
+			// The semaphore can't be signaled again until the frame that waits on it is finished
+			if (batch.frame <= completedFrame)
+			{
+				vkResetFences(device, 1, &batch.fence);
+				vkResetCommandBuffer(batch.commandBuffer, 0);
+				batch.copies.clear();
+				batch.inFlight = false;
+			}
+		}
+		m_completedTicket = oldestPending - 1;
+		if (m_used == 0)
+			m_head = 0;
+	}
+
+	void UploadQueue::destroy()
+	{
+		if (m_device == UINT32_MAX) return;
+		VulkanDevice& device = VulkanContext::getDevice(m_device);
+
+		for (const Batch& batch : m_batches)
+		{
+			for (const Staging& staging : batch.dedicated)
+			{
+				vkDestroyBuffer(*device, staging.buffer, nullptr);
+				vkFreeMemory(*device, staging.memory, nullptr);
+			}
+			vkDestroyFence(*device, batch.fence, nullptr);
+		}
+		m_batches.clear();
+		for (const Staging& staging : m_pendingDedicated)
+		{
+			vkDestroyBuffer(*device, staging.buffer, nullptr);
+			vkFreeMemory(*device, staging.memory, nullptr);
+		}
+		m_pendingDedicated.clear();
+		if (!m_pending.empty())
+			Logger::print(Logger::WARN, "Dropped ", m_pending.size(), " uploads that were never submitted");
+		m_pending.clear();
+
+		// Destroying the pool frees the batch command buffers
+		vkDestroyCommandPool(*device, m_commandPool, nullptr);
+		vkUnmapMemory(*device, m_ring.memory);
+		vkDestroyBuffer(*device, m_ring.buffer, nullptr);
+		vkFreeMemory(*device, m_ring.memory, nullptr);
+		m_ring = {};
+		m_mapped = nullptr;
+		m_device = UINT32_MAX;
+	}
+} // namespace gflow
@@ -0,0 +1,92 @@
+#include "worker_pool.hpp"
+
+namespace gflow
+{
+	WorkerPool::WorkerPool(const uint32_t workerCount)
+	{
+		for (uint32_t i = 1; i < workerCount; ++i)
+			m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& thread : m_threads)
+			thread.join();
+	}
+
+	void WorkerPool::parallelFor(const uint32_t count, const Job& job)
+	{
+		if (count == 0) return;
+		if (m_threads.empty() || count == 1)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+				job(i, 0);
+			return;
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_job = &job;
+			m_count = count;
+			m_next.store(0, std::memory_order_relaxed);
+			m_busy = static_cast<uint32_t>(m_threads.size());
+			m_error = nullptr;
+			m_generation++;
+		}
+		m_wake.notify_all();
+
+		runJobs(0);
+
+		std::exception_ptr error;
+		{
+			std::unique_lock lock(m_mutex);
+			m_done.wait(lock, [this] { return m_busy == 0; });
+			m_job = nullptr;
+			error = m_error;
+		}
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	void WorkerPool::workerLoop(const uint32_t worker)
+	{
+		uint64_t generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_mutex);
+				m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+				if (m_stop) return;
+				generation = m_generation;
+			}
+
+			runJobs(worker);
+
+			std::lock_guard lock(m_mutex);
+			if (--m_busy == 0)
+				m_done.notify_one();
+		}
+	}
+
+	void WorkerPool::runJobs(const uint32_t worker)
+	{
+		for (uint32_t i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+		{
+			try
+			{
+				(*m_job)(i, worker);
+			}
+			catch (...)
+			{
+				std::lock_guard lock(m_mutex);
+				if (!m_error)
+					m_error = std::current_exception();
+			}
+		}
+	}
+} // namespace gflow
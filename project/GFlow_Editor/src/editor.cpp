@@ -1,11 +1,15 @@
 #include "editor.hpp"
 
+#include <cstdlib>
 #include <filesystem>
 
 #include "backends/imgui_impl_vulkan.h"
 
 #include "context.hpp"
+#include "frame_arena.hpp"
 #include "imgui.h"
+#include "profiler.hpp"
+#include "project_exporter.hpp"
 #include "resource_manager.hpp"
 #include "string_helper.hpp"
 #include "vulkan_context.hpp"
@@ -21,14 +25,15 @@
 void Editor::init(const std::string& projectPath)
 {
     Logger::setLevels(Logger::ALL);
-    Logger::setRootContext("Window init");
+    gflow::Profiler::setRootContext("Window init");
 
     s_window = SDLWindow{ "GFlow", 1280, 720 };
 
     {
-        Logger::setRootContext("Vulkan init");
+        gflow::Profiler::setRootContext("Vulkan init");
         std::vector<const char*> requiredExts = s_window.getRequiredVulkanExtensions();
         gflow::Context::initVulkan(requiredExts);
+        gflow::Context::setGPUCachePath(SDLWindow::getUserDataPath() + "gpu_capabilities.bin");
         s_window.createSurface(gflow::Context::getVulkanInstance());
     }
 
@@ -61,19 +66,33 @@ void Editor::renderFrame()
 
     env.beginRecording({ s_window.getSurface() });
 
-    // Build and render projects here
+    if (s_previewProject != UINT32_MAX)
+    {
+        try
+        {
+            env.recordProject(s_previewProject);
+        }
+        catch (const std::runtime_error& e)
+        {
+            Logger::print(Logger::ERR, "Project preview failed: ", e.what());
+            stopPreview();
+        }
+    }
 
-    if (!renderImgui()) return;
-    env.setRecordingBarrier();
-    submitImgui();
+    if (renderImgui())
+    {
+        env.setRecordingBarrier();
+        submitImgui();
 
-    env.endRecording();
-    env.present(s_window.getSurface());
+        env.endRecording();
+        env.present(s_window.getSurface());
+    }
+    FrameArena::reset();
 }
 
 void Editor::cleanup()
 {
-    Logger::setRootContext("Environment cleanup");
+    gflow::Profiler::setRootContext("Environment cleanup");
     VulkanContext::getDevice(gflow::Context::getEnvironment(s_environment).man_getDevice()).waitIdle();
 
     ImGui_ImplVulkan_Shutdown();
@@ -88,7 +107,7 @@ void Editor::cleanup()
 
 void Editor::createEnv()
 {
-    Logger::setRootContext("Environment init");
+    gflow::Profiler::setRootContext("Environment init");
     s_environment = gflow::Context::createEnvironment();
     gflow::Environment& env = gflow::Context::getEnvironment(s_environment);
     env.addSurface(s_window.getSurface());
@@ -105,8 +124,12 @@ void Editor::createEnv()
 
 void Editor::initImgui()
 {
-    Logger::pushContext("Init Imgui");
+    gflow::Profiler::pushContext("Init Imgui");
     IMGUI_CHECKVERSION();
+#if GFLOW_PROFILING
+    // ImGui allocates through malloc, which the frame allocation counter doesn't see otherwise
+    ImGui::SetAllocatorFunctions([](const size_t size, void*) { FrameArena::countAllocation(); return std::malloc(size); }, [](void* ptr, void*) { std::free(ptr); });
+#endif
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -124,27 +147,19 @@ void Editor::initImgui()
     gflow::Environment& env = gflow::Context::getEnvironment(s_environment);
     VulkanDevice& device = VulkanContext::getDevice(env.man_getDevice());
 
-    constexpr std::array<VkDescriptorPoolSize, 11> pool_sizes
-    {
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000 },
-        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000 }
+    // The ImGui backend only ever allocates one combined image sampler per texture it shows, the font atlas included.
+    // Project descriptors come from the environment's descriptor allocator
+    constexpr std::array<VkDescriptorPoolSize, 1> pool_sizes
+    {
+        VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, c_imguiMaxTextures }
     };
 
-    const uint32_t imguiPoolID = device.createDescriptorPool(pool_sizes, 1000 * static_cast<uint32_t>(pool_sizes.size()), VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+    const uint32_t imguiPoolID = device.createDescriptorPool(pool_sizes, c_imguiMaxTextures, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
     VulkanSwapchainExtension* swapchainExtension = VulkanSwapchainExtension::get(device);
     VulkanSwapchain& swapchain = swapchainExtension->getSwapchain(env.man_getSwapchain(s_window.getSurface()));
 
     {
-        Logger::pushContext("Create Imgui Renderpass");
+        gflow::Profiler::pushContext("Create Imgui Renderpass");
         VulkanRenderPassBuilder builder{};
         const VkAttachmentDescription colorAttachment = VulkanRenderPassBuilder::createAttachment(swapchain.getFormat().format,
             VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
@@ -164,7 +179,7 @@ void Editor::initImgui()
         dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
         builder.addDependency(dependency);
         s_imguiRenderPass = device.createRenderPass(builder, 0);
-        Logger::popContext();
+        gflow::Profiler::popContext();
     }
 
     const VulkanRenderPass& renderPass = device.getRenderPass(s_imguiRenderPass);
@@ -184,7 +199,7 @@ void Editor::initImgui()
     init_info.ImageCount = swapchain.getImageCount();
     init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     ImGui_ImplVulkan_Init(&init_info);
-    Logger::popContext();
+    gflow::Profiler::popContext();
 
     const VkExtent3D extent = { swapchain.getExtent().width, swapchain.getExtent().height, 1 };
     for (uint32_t i = 0; i < swapchain.getImageCount(); ++i)
@@ -225,6 +240,8 @@ void Editor::createWindows()
         // Setup execution window
         ImGuiExecutionWindow* executionWindow = dynamic_cast<ImGuiExecutionWindow*>(getWindow("Execution"));
         s_projectLoadedSignal.connect(executionWindow, &ImGuiExecutionWindow::onProjectLoaded);
+        s_projectLoadedSignal.connect(&Editor::stopPreview);
+        executionWindow->getProjectChangedSignal().connect(&Editor::previewBuiltProject);
     }
     {
         // Setup project settings window
@@ -286,6 +303,10 @@ void Editor::drawImgui()
         {
             saveProject();
         }
+        if (ImGui::MenuItem("Export project"))
+        {
+            exportProject();
+        }
         ImGui::Separator();
         ImGui::MenuItem("Project Settings", "", &getWindow("Project Settings")->open);
 
@@ -299,6 +320,23 @@ void Editor::drawImgui()
         }
         ImGui::EndMenu();
     }
+#if GFLOW_PROFILING
+    if (ImGui::BeginMenu("Profiling"))
+    {
+        bool enabled = gflow::Profiler::isEnabled();
+        if (ImGui::MenuItem("Record", "", &enabled))
+            gflow::Profiler::setEnabled(enabled);
+        if (ImGui::MenuItem("Export trace"))
+        {
+            std::filesystem::create_directories(".cache");
+            gflow::Profiler::exportChromeTrace(".cache/trace.json");
+        }
+        if (ImGui::MenuItem("Clear"))
+            gflow::Profiler::clear();
+        ImGui::EndMenu();
+    }
+    ImGui::TextDisabled("%llu heap allocations last frame", FrameArena::getFrameAllocations());
+#endif
     ImGui::EndMainMenuBar();
 
     // General window execution
@@ -333,7 +371,7 @@ void Editor::updateImguiWindows()
 
 void Editor::recreateSwapchain(const uint32_t width, const uint32_t height)
 {
-    Logger::pushContext("Recreate Swapchain");
+    gflow::Profiler::pushContext("Recreate Swapchain");
     gflow::Environment& env = gflow::Context::getEnvironment(s_environment);
     VulkanDevice& device = VulkanContext::getDevice(env.man_getDevice());
     device.waitIdle();
@@ -350,7 +388,7 @@ void Editor::recreateSwapchain(const uint32_t width, const uint32_t height)
         VulkanImageView& imageView = swapchain.getImage(i).getImageView(swapchain.getImageView(i));
         s_imguiFrameBuffers[i] = device.createFramebuffer(extent, s_imguiRenderPass, {{ *imageView }});
     }
-    Logger::popContext();
+    gflow::Profiler::popContext();
 }
 
 void Editor::saveProject()
@@ -361,6 +399,49 @@ void Editor::saveProject()
     gflow::parser::ResourceManager::saveAll();
 }
 
+std::string Editor::exportProject()
+{
+    gflow::parser::Project* project = getCurrentProject();
+    if (project == nullptr) return "";
+
+    const std::string path = gflow::parser::ResourceManager::getWorkingDir() + project->getName() + ".gflow";
+    try
+    {
+        ProjectExporter::exportProject(project, path);
+        Logger::print(Logger::INFO, "Project exported to ", path);
+        return path;
+    }
+    catch (const std::runtime_error& e)
+    {
+        Logger::print(Logger::ERR, "Project export failed: ", e.what());
+        return "";
+    }
+}
+
+void Editor::previewBuiltProject(const ProjectChangeSet& changes)
+{
+    if (changes.empty() && s_previewProject != UINT32_MAX) return;
+
+    stopPreview();
+    const std::string path = exportProject();
+    if (path.empty()) return;
+    try
+    {
+        setPreviewProject(gflow::Context::getEnvironment(s_environment).loadProject(path));
+    }
+    catch (const std::runtime_error& e)
+    {
+        Logger::print(Logger::ERR, "Project preview failed: ", e.what());
+    }
+}
+
+void Editor::stopPreview()
+{
+    if (s_previewProject == UINT32_MAX) return;
+    gflow::Context::getEnvironment(s_environment).unloadProject(s_previewProject);
+    setPreviewProject(UINT32_MAX);
+}
+
 ImGuiEditorWindow* Editor::getWindow(const std::string& name)
 {
     for (ImGuiEditorWindow* window : s_imguiWindows)
@@ -389,6 +470,18 @@ gflow::parser::Project* Editor::getCurrentProject()
     return dynamic_cast<gflow::parser::Project*>(gflow::parser::ResourceManager::getProject());
 }
 
+void Editor::setPreviewProject(const uint32_t project)
+{
+    s_previewProject = project;
+    gflow::Context::getEnvironment(s_environment).setGPUProfiling(project != UINT32_MAX);
+}
+
+const gflow::GPUProfiler::Sample* Editor::getGPUSample(const uint32_t renderpass, const uint32_t subpass, const uint32_t drawCall)
+{
+    if (s_previewProject == UINT32_MAX) return nullptr;
+    return gflow::Context::getEnvironment(s_environment).getGPUProfiler().find({ s_previewProject, renderpass, subpass, drawCall });
+}
+
 void Editor::showCreateFolderModal(const std::string& path)
 {
     s_showCreateFolderModal = true;
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "gpu_profiler.hpp"
 #include "ImNodeFlow.h"
 #include "resources/project.hpp"
 #include "sdl_window.hpp"
 #include "windows/imgui_resources.hpp"
 
 class ImGuiResourceEditorWindow;
+struct ProjectChangeSet;
 
 class Editor
 {
@@ -30,11 +32,19 @@ private:
 	static void recreateSwapchain(uint32_t width, uint32_t height);
 
     static void saveProject();
+    // Writes the built project next to the project resource, as <name>.gflow, for gflow::Context::loadProject.
+    // Returns the path written, or an empty string if the export failed
+    static std::string exportProject();
+    // Exports the freshly built project and loads it into the editor environment, where it is recorded every frame
+    static void previewBuiltProject(const ProjectChangeSet& changes);
+    static void stopPreview();
 
 	inline static SDLWindow s_window{};
 	inline static uint32_t s_environment = UINT32_MAX;
 	inline static uint32_t s_imguiRenderPass = UINT32_MAX;
 	inline static std::vector<uint32_t> s_imguiFrameBuffers{};
+	// Textures the ImGui pool can hold at once
+	static constexpr uint32_t c_imguiMaxTextures = 1000;
 
     inline static std::vector<ImGuiEditorWindow*> s_imguiWindows{};
 
@@ -46,6 +56,11 @@ public: // Editor Management
     static gflow::parser::Resource* getSelectedResource();
     static gflow::parser::Project* getCurrentProject();
 
+    // Core project rendered by the editor, its GPU timings are shown on the execution nodes. Turns GPU profiling on
+    // while a project is set
+    static void setPreviewProject(uint32_t project);
+    static const gflow::GPUProfiler::Sample* getGPUSample(uint32_t renderpass, uint32_t subpass, uint32_t drawCall);
+
     static void showCreateFolderModal(const std::string& path);
     static void showRenameFolderModal(const std::string& path);
     static void showDeleteFolderModal(const std::string& path);
@@ -87,6 +102,7 @@ private:
     inline static ImGuiResourcesWindow s_getResourceRefWindow{"Resource Picker"};
 
     inline static std::string s_selectedResource;
+    inline static uint32_t s_previewProject = UINT32_MAX;
 
     inline static Signal<> s_projectLoadedSignal;
 
@@ -0,0 +1,68 @@
+#include "frame_arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "profiler.hpp"
+
+void* FrameArena::allocate(const size_t size, const size_t alignment)
+{
+    s_frameSize += size + alignment - 1;
+    const auto alignedOffset = [alignment]
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(s_block.get());
+        return ((base + s_offset + alignment - 1) & ~(alignment - 1)) - base;
+    };
+
+    size_t offset = alignedOffset();
+    if (s_block == nullptr || offset + size > s_capacity)
+    {
+        if (s_block != nullptr)
+            s_retiredBlocks.push_back(std::move(s_block));
+        s_capacity = std::max({ c_initialCapacity, s_capacity * 2, size + alignment });
+        s_block = std::make_unique_for_overwrite<std::byte[]>(s_capacity);
+        s_offset = 0;
+        offset = alignedOffset();
+    }
+    s_offset = offset + size;
+    return s_block.get() + offset;
+}
+
+void FrameArena::reset()
+{
+    if (!s_retiredBlocks.empty())
+    {
+        s_retiredBlocks.clear();
+        if (s_frameSize > s_capacity)
+        {
+            s_capacity = s_frameSize;
+            s_block = std::make_unique_for_overwrite<std::byte[]>(s_capacity);
+        }
+    }
+    s_offset = 0;
+    s_frameSize = 0;
+    s_frameAllocations = s_allocations.exchange(0, std::memory_order_relaxed);
+}
+
+#if GFLOW_PROFILING
+// Replacing the global operator new counts every allocation of the editor and of the static libraries linked into it.
+// The array, nothrow and sized forms all end up here or in the matching delete
+void* operator new(const size_t size)
+{
+    FrameArena::countAllocation();
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
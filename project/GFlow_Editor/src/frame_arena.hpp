@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Linear allocator for the labels and containers the editor windows only need while a frame is built. Everything is
+// released at once by reset() at the end of Editor::renderFrame, nothing taken from it may be kept across frames
+class FrameArena
+{
+public:
+    template <typename T>
+    struct Allocator
+    {
+        using value_type = T;
+
+        Allocator() = default;
+        template <typename U>
+        Allocator(const Allocator<U>&) {}
+
+        [[nodiscard]] T* allocate(const size_t count) { return static_cast<T*>(FrameArena::allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) {}
+
+        template <typename U>
+        bool operator==(const Allocator<U>&) const { return true; }
+    };
+
+    template <typename T>
+    using Vector = std::vector<T, Allocator<T>>;
+
+    [[nodiscard]] static void* allocate(size_t size, size_t alignment);
+    // Null terminated copy of the parts one after another, meant for ImGui labels
+    template <typename... Args>
+    [[nodiscard]] static const char* concat(const Args&... parts);
+
+    // Frees everything handed out during the frame. If the frame didn't fit the arena grows to hold it whole, so a
+    // steady frame doesn't touch the heap after the first few
+    static void reset();
+
+    // Heap allocations made by the editor during the last frame, from any thread. Only counted while profiling
+    [[nodiscard]] static uint64_t getFrameAllocations() { return s_frameAllocations; }
+    static void countAllocation() { s_allocations.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t c_initialCapacity = 64 * 1024;
+
+    inline static std::unique_ptr<std::byte[]> s_block{};
+    inline static size_t s_capacity = 0;
+    inline static size_t s_offset = 0;
+    // Blocks that ran out during the frame, freed by the next reset
+    inline static std::vector<std::unique_ptr<std::byte[]>> s_retiredBlocks{};
+    inline static size_t s_frameSize = 0;
+
+    inline static std::atomic<uint64_t> s_allocations{ 0 };
+    inline static uint64_t s_frameAllocations = 0;
+};
+
+template <typename... Args>
+const char* FrameArena::concat(const Args&... parts)
+{
+    const std::string_view views[] = { std::string_view(parts)... };
+    size_t size = 1;
+    for (const std::string_view view : views)
+        size += view.size();
+
+    char* str = static_cast<char*>(allocate(size, alignof(char)));
+    char* end = str;
+    for (const std::string_view view : views)
+        end += view.copy(end, view.size());
+    *end = '\0';
+    return str;
+}
@@ -1,5 +1,7 @@
 ﻿#include "execution.hpp"
 
+#include "resource_manager.hpp"
+
 gflow::parser::DataUsage BeginExecutionNodeResource::isUsed(const std::string& variable, const std::vector<Resource*>& parentPath)
 {
     if (variable == "renderpass")
@@ -35,11 +37,63 @@ gflow::parser::DataUsage ImageNodeResource::isUsed(const std::string& variable,
 gflow::parser::DataUsage ModelNodeResource::isUsed(const std::string& variable,
     const std::vector<Resource*>& parentPath)
 {
-    if (variable == "path" || variable == "fields")
+    if (variable == "path" || variable == "fields" || variable == "lodErrors")
         return gflow::parser::USED;
     return NodeResource::isUsed(variable, parentPath);
 }
 
+std::string ModelNodeResource::getCookedPath()
+{
+    const std::string source = gflow::parser::ResourceManager::makePathAbsolute((*path).path);
+    const uint32_t fieldMask = gflow::parser::MeshCooker::getFieldMask((*fields).data());
+    return gflow::parser::MeshCooker::cook(source, fieldMask, (*lodErrors).data(), gflow::parser::ResourceManager::getWorkingDir() + ".cache/meshes");
+}
+
+ModelNodeResource::~ModelNodeResource()
+{
+    // Destroying the futures waits for their jobs, cancelled they return at their next check
+    cancelCook();
+}
+
+void ModelNodeResource::cookAsync()
+{
+    m_cookedPath.clear();
+    // Dropping an async future waits for it, so a job that is still running is cancelled and parked until it returns
+    cancelCook();
+    if ((*path).path.empty()) return;
+
+    const std::string source = gflow::parser::ResourceManager::makePathAbsolute((*path).path);
+    const uint32_t fieldMask = gflow::parser::MeshCooker::getFieldMask((*fields).data());
+    m_cookProgress = std::make_shared<gflow::parser::MeshCooker::Progress>();
+    m_cookJob = gflow::parser::MeshCooker::cookAsync(source, fieldMask, (*lodErrors).data(), gflow::parser::ResourceManager::getWorkingDir() + ".cache/meshes", m_cookProgress);
+}
+
+void ModelNodeResource::cancelCook()
+{
+    if (!m_cookJob.valid()) return;
+    m_cookProgress->cancelled = true;
+    m_supersededJobs.push_back(std::move(m_cookJob));
+}
+
+std::optional<float> ModelNodeResource::pollCook()
+{
+    std::erase_if(m_supersededJobs, [](const std::future<std::string>& job) { return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+
+    if (!m_cookJob.valid()) return std::nullopt;
+    if (m_cookJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return m_cookProgress->get();
+
+    try
+    {
+        m_cookedPath = m_cookJob.get();
+    }
+    catch (const std::exception& e)
+    {
+        Logger::print(Logger::ERR, "Failed to cook model ", (*path).path, ": ", e.what());
+    }
+    return std::nullopt;
+}
+
 gflow::parser::DataUsage ExternalArgumentNodeResource::isUsed(const std::string& variable,
     const std::vector<Resource*>& parentPath)
 {
@@ -1,5 +1,10 @@
 ﻿#pragma once
+#include <future>
+#include <memory>
+#include <optional>
+
 #include "graph.hpp"
+#include "mesh_cooker.hpp"
 #include "resources/renderpass.hpp"
 
 class BeginExecutionNodeResource final : public NodeResource
@@ -11,6 +16,7 @@ class BeginExecutionNodeResource final : public NodeResource
     gflow::parser::DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(BeginExecutionNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 
     gflow::parser::RenderPass* getRenderpass() { return *renderpass; }
 
@@ -27,6 +33,7 @@ class NextExecutionNodeResource final : public NodeResource
 
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(NextExecutionNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 class EndExecutionNodeResource final : public NodeResource
@@ -34,6 +41,7 @@ class EndExecutionNodeResource final : public NodeResource
 
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(EndExecutionNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 class BindPushConstantNodeResource final : public NodeResource
@@ -43,6 +51,7 @@ class BindPushConstantNodeResource final : public NodeResource
 
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(BindPushConstantNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 class DrawCallNodeResource final : public NodeResource
@@ -56,10 +65,13 @@ class DrawCallNodeResource final : public NodeResource
 
 public:
     gflow::parser::Pipeline* getPipeline() { return *pipeline; }
+    // Without a manual count the vertices come from the model, which the runtime does not draw yet
+    int getVertexCount() { return *manualVertexCount ? *vertexCount : 0; }
     void setModelPin(const bool enabled) { *modelPin = enabled; }
     bool hasModelPin() { return *modelPin; }
 
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(DrawCallNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 class ImageNodeResource final : public NodeResource
@@ -76,10 +88,32 @@ class ModelNodeResource final : public NodeResource
 {
     EXPORT(gflow::parser::FilePath, path);
     EXPORT_ENUM_LIST(fields, gflow::parser::EnumContexts::ModelFields);
+    // One simplified LOD per entry, as the allowed error relative to the model radius
+    EXPORT_LIST(float, lodErrors);
     gflow::parser::DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
 
 public:
+    // Cooks the model for the selected fields if the cache doesn't have it yet, returns the cooked file path
+    [[nodiscard]] std::string getCookedPath();
+
+    // Starts cooking on a background thread, replacing any result from before. A job that is still running is cancelled.
+    // Large models take seconds to parse
+    void cookAsync();
+    // Progress of the running cook job, empty when there is none. Picks up the result once the job is done
+    [[nodiscard]] std::optional<float> pollCook();
+    // Last path cookAsync produced, empty if it failed or hasn't finished
+    [[nodiscard]] const std::string& getLastCookedPath() const { return m_cookedPath; }
+
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(ModelNodeResource, NodeResource)
+    ~ModelNodeResource() override;
+
+private:
+    void cancelCook();
+
+    std::future<std::string> m_cookJob;
+    std::vector<std::future<std::string>> m_supersededJobs;
+    std::shared_ptr<gflow::parser::MeshCooker::Progress> m_cookProgress;
+    std::string m_cookedPath;
 };
 
 class DataDecomposeNodeResource final : public NodeResource
@@ -139,6 +173,7 @@ class WatcherNodeResource final : public NodeResource
 
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(WatcherNodeResource, NodeResource)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 // Primitives //
@@ -0,0 +1,221 @@
+#include "execution_analysis.hpp"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+#include "execution.hpp"
+
+ExecutionAnalysis::Result ExecutionAnalysis::analyze(GraphResource& graph)
+{
+    Result result{};
+
+    std::unordered_map<size_t, NodeResource*> nodes{};
+    std::vector<size_t> ids{};
+    size_t init = 0;
+    bool hasInit = false;
+    for (int i = 0; i < graph.getNodes().size(); i++)
+    {
+        NodeResource* resource = graph.getNodes()[i];
+        nodes[resource->getNodeID()] = resource;
+        ids.push_back(resource->getNodeID());
+        if (!hasInit && dynamic_cast<InitNodeResource*>(resource) != nullptr)
+        {
+            init = resource->getNodeID();
+            hasInit = true;
+        }
+    }
+
+    // Connections to nodes that don't exist anymore are left out
+    std::unordered_map<size_t, std::vector<size_t>> successors{};
+    std::unordered_map<size_t, std::vector<size_t>> predecessors{};
+    for (const size_t id : ids)
+    {
+        for (const gflow::parser::ConnectionKey& key : graph.getOutgoing(id))
+        {
+            if (!nodes.contains(key.rightUID)) continue;
+            successors[id].push_back(key.rightUID);
+            predecessors[key.rightUID].push_back(id);
+        }
+    }
+    static const std::vector<size_t> none{};
+    const auto getLinked = [](const std::unordered_map<size_t, std::vector<size_t>>& links, const size_t id) -> const std::vector<size_t>&
+    {
+        const auto it = links.find(id);
+        return it == links.end() ? none : it->second;
+    };
+
+    // Tarjan's strongly connected components, without recursion so long chains can't overflow the stack. The
+    // components come out after everything they lead to
+    std::unordered_map<size_t, uint32_t> index{};
+    std::unordered_map<size_t, uint32_t> lowLink{};
+    std::unordered_set<size_t> onStack{};
+    std::vector<size_t> stack{};
+    std::vector<std::pair<size_t, size_t>> callStack{};
+    std::vector<std::vector<size_t>> components{};
+    const auto open = [&](const size_t id)
+    {
+        const uint32_t visit = static_cast<uint32_t>(index.size());
+        index[id] = visit;
+        lowLink[id] = visit;
+        stack.push_back(id);
+        onStack.insert(id);
+        callStack.emplace_back(id, 0);
+    };
+    for (const size_t root : ids)
+    {
+        if (index.contains(root)) continue;
+        open(root);
+        while (!callStack.empty())
+        {
+            const size_t node = callStack.back().first;
+            const std::vector<size_t>& next = getLinked(successors, node);
+            if (callStack.back().second < next.size())
+            {
+                const size_t target = next[callStack.back().second++];
+                if (!index.contains(target))
+                    open(target);
+                else if (onStack.contains(target))
+                    lowLink[node] = std::min(lowLink[node], index[target]);
+                continue;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty())
+                lowLink[callStack.back().first] = std::min(lowLink[callStack.back().first], lowLink[node]);
+            if (lowLink[node] != index[node]) continue;
+
+            std::vector<size_t>& component = components.emplace_back();
+            size_t member;
+            do
+            {
+                member = stack.back();
+                stack.pop_back();
+                onStack.erase(member);
+                component.push_back(member);
+            } while (member != node);
+        }
+    }
+    result.order.reserve(ids.size());
+    for (auto it = components.rbegin(); it != components.rend(); ++it)
+    {
+        result.order.insert(result.order.end(), it->begin(), it->end());
+        const std::vector<size_t>& next = getLinked(successors, it->front());
+        if (it->size() > 1 || std::ranges::find(next, it->front()) != next.end())
+            result.cycles.push_back(*it);
+    }
+
+    // Same walk as the build, through the first link out of every node of the chain
+    std::unordered_set<size_t> reachable{};
+    std::vector<std::vector<size_t>> passNodes{};
+    bool insideRenderpass = false;
+    size_t current = init;
+    bool hasCurrent = hasInit;
+    while (hasCurrent)
+    {
+        if (!reachable.insert(current).second)
+        {
+            result.chainLoops = true;
+            break;
+        }
+        NodeResource* resource = nodes[current];
+        if (dynamic_cast<BeginExecutionNodeResource*>(resource) != nullptr)
+        {
+            result.renderpasses.push_back(current);
+            passNodes.push_back({ current });
+            insideRenderpass = true;
+        }
+        else if (insideRenderpass)
+        {
+            passNodes.back().push_back(current);
+            insideRenderpass = dynamic_cast<EndExecutionNodeResource*>(resource) == nullptr;
+        }
+
+        hasCurrent = false;
+        for (const size_t next : getLinked(successors, current))
+        {
+            if (!nodes[next]->isExecutionFlow()) continue;
+            current = next;
+            hasCurrent = true;
+            break;
+        }
+    }
+
+    // Data nodes count as reached when they feed a node of the chain, directly or through other data nodes
+    const auto collectInputs = [&](const std::vector<size_t>& consumers, std::unordered_set<size_t>& inputs)
+    {
+        std::vector<size_t> pending = consumers;
+        while (!pending.empty())
+        {
+            const size_t node = pending.back();
+            pending.pop_back();
+            for (const size_t source : getLinked(predecessors, node))
+            {
+                if (!nodes[source]->isExecutionFlow() && inputs.insert(source).second)
+                    pending.push_back(source);
+            }
+        }
+    };
+    collectInputs(std::vector<size_t>(reachable.begin(), reachable.end()), reachable);
+    for (const size_t id : ids)
+    {
+        if (!reachable.contains(id))
+            result.unreachable.push_back(id);
+    }
+
+    // Images are the only data written on the GPU, two render passes that share none can't depend on each other.
+    // Each pass goes one level after the latest earlier pass it shares an image with
+    std::vector<std::set<std::string>> passImages(passNodes.size());
+    std::vector<uint32_t> levels(passNodes.size(), 0);
+    for (size_t i = 0; i < passNodes.size(); i++)
+    {
+        std::unordered_set<size_t> inputs{};
+        collectInputs(passNodes[i], inputs);
+        for (const size_t input : inputs)
+        {
+            if (ImageNodeResource* image = dynamic_cast<ImageNodeResource*>(nodes[input]))
+            {
+                const std::string imageID = image->getValue<std::string>("imageID");
+                passImages[i].insert(imageID.empty() ? "#" + std::to_string(input) : imageID);
+            }
+        }
+        for (size_t j = 0; j < i; j++)
+        {
+            const bool shared = std::ranges::any_of(passImages[i], [&](const std::string& imageID) { return passImages[j].contains(imageID); });
+            if (shared)
+                levels[i] = std::max(levels[i], levels[j] + 1);
+        }
+        if (levels[i] >= result.parallelGroups.size())
+            result.parallelGroups.resize(levels[i] + 1);
+        result.parallelGroups[levels[i]].push_back(static_cast<uint32_t>(i));
+    }
+
+    for (const std::vector<size_t>& cycle : result.cycles)
+    {
+        for (const size_t id : cycle)
+            result.diagnostics[id].push_back({ NodeDiagnostic::ERR, "Part of a cycle" });
+    }
+    if (result.chainLoops)
+        result.diagnostics[current].push_back({ NodeDiagnostic::ERR, "The execution loops back here, the project can't be built" });
+    for (const size_t id : result.unreachable)
+        result.diagnostics[id].push_back({ NodeDiagnostic::WARN, "Not connected to the execution" });
+    for (const std::vector<uint32_t>& group : result.parallelGroups)
+    {
+        if (group.size() < 2) continue;
+        for (const uint32_t pass : group)
+        {
+            std::string message = "Shares no images with render pass";
+            message += group.size() > 2 ? "es " : " ";
+            bool first = true;
+            for (const uint32_t other : group)
+            {
+                if (other == pass) continue;
+                message += (first ? "" : ", ") + std::to_string(other);
+                first = false;
+            }
+            result.diagnostics[result.renderpasses[pass]].push_back({ NodeDiagnostic::INFO, message });
+        }
+    }
+    return result;
+}
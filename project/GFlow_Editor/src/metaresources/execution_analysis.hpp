@@ -0,0 +1,31 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+
+// Static checks over the nodes and connections of an execution graph, nodes are referred to by their node ID
+class ExecutionAnalysis
+{
+public:
+    struct Result
+    {
+        // Every node after the nodes it depends on. The nodes of a cycle come in no particular order
+        std::vector<size_t> order{};
+        std::vector<std::vector<size_t>> cycles{};
+        // Nodes the build never gets to from the init node
+        std::vector<size_t> unreachable{};
+        // Following the chain from the init node comes back to a node it already went through
+        bool chainLoops = false;
+
+        // Begin nodes of the render passes in the order the build finds them, the same order the project gets
+        std::vector<size_t> renderpasses{};
+        // Render passes, as indices into renderpasses, that use none of the images of the others in the group. The
+        // passes of a group only wait on earlier groups, so they could be recorded in parallel or on separate queues
+        std::vector<std::vector<uint32_t>> parallelGroups{};
+
+        std::unordered_map<size_t, std::vector<NodeDiagnostic>> diagnostics{};
+    };
+
+    [[nodiscard]] static Result analyze(GraphResource& graph);
+};
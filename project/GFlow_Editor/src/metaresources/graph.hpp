@@ -1,5 +1,8 @@
 #pragma once
+#include <vector>
+
 #include "resource.hpp"
+#include "resources/connection_list.hpp"
 #include "resources/list.hpp"
 #include "resources/pair.hpp"
 #include "windows/nodes/base_node.hpp"
@@ -39,6 +42,8 @@ public:
 
     void setPos(const gflow::parser::Vec2& pos) { *position = pos; }
     void setNodeID(const size_t id) { *nodeID = id; }
+    // Part of the execution chain, all of its outputs are flow pins
+    [[nodiscard]] virtual bool isExecutionFlow() const { return false; }
 
 protected:
     NodeResource() = default;
@@ -49,30 +54,7 @@ class InitNodeResource final : public NodeResource
 
 public:
     DECLARE_PRIVATE_RESOURCE_ANCESTOR(InitNodeResource, NodeResource)
-};
-
-class Connection final : public gflow::parser::Resource
-{
-private:
-    EXPORT(size_t, leftUID);
-    EXPORT(size_t, leftPin);
-    EXPORT(size_t, rightUID);
-    EXPORT(size_t, rightPin);
-    
-public:
-    [[nodiscard]] size_t getLeftUID() const { return *leftUID; }
-    [[nodiscard]] size_t getLeftPin() const { return *leftPin; }
-    [[nodiscard]] size_t getRightUID() const { return *rightUID; }
-    [[nodiscard]] size_t getRightPin() const { return *rightPin; }
-    void setValues(const size_t leftUID, const size_t leftPin, const size_t rightUID, const size_t rightPin)
-    {
-        *this->leftUID = leftUID;
-        *this->leftPin = leftPin;
-        *this->rightUID = rightUID;
-        *this->rightPin = rightPin;
-    }
-
-    DECLARE_PRIVATE_RESOURCE(Connection)
+    [[nodiscard]] bool isExecutionFlow() const override { return true; }
 };
 
 class GraphResource : public gflow::parser::Resource
@@ -80,23 +62,31 @@ class GraphResource : public gflow::parser::Resource
 protected:
 
     EXPORT_RESOURCE_LIST(NodeResource, nodes);
-    EXPORT_RESOURCE_LIST(Connection, connections);
+    EXPORT_RESOURCE_LIST(gflow::parser::Connection, connections);
     
     gflow::parser::DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
 
 public:
     gflow::parser::List<NodeResource*>& getNodes() { return *nodes; }
-    gflow::parser::List<Connection*>& getConnections() { return *connections; }
+    // Edited only through the functions below, which keep the connection index in sync
+    [[nodiscard]] const gflow::parser::List<gflow::parser::Connection*>& getConnections() const { return *connections; }
 
     template <typename U>
     U* addNode(const gflow::parser::Vec2& position = {});
     void removeNode(GFlowNode* node);
 
     void addConnection(size_t left_uid, size_t left_pin, size_t right_uid, size_t right_pin);
-    void clearConnections() { (*connections).clear(); }
+    bool removeConnection(const gflow::parser::ConnectionKey& key);
+    void clearConnections();
 
+    // Connections leaving and entering a node
+    [[nodiscard]] const std::vector<gflow::parser::ConnectionKey>& getOutgoing(size_t uid);
+    [[nodiscard]] const std::vector<gflow::parser::ConnectionKey>& getIncoming(size_t uid);
 
     DECLARE_PRIVATE_RESOURCE(GraphResource)
+
+private:
+    gflow::parser::ConnectionIndex m_connectionIndex{};
 };
 
 // **************
@@ -126,27 +116,30 @@ U* GraphResource::addNode(const gflow::parser::Vec2& position)
 inline void GraphResource::removeNode(GFlowNode* node)
 {
     (*nodes).erase(node->getLinkedResource());
-    for (int i = 0; i < (*connections).size(); i++)
-    {
-        if ((*connections)[i]->getLeftUID() == node->getUID() || (*connections)[i]->getRightUID() == node->getUID())
-        {
-            (*connections).remove(i);
-            i--;
-        }
-    }
+    m_connectionIndex.removeNode(*connections, node->getUID());
 }
 
 inline void GraphResource::addConnection(const size_t left_uid, const size_t left_pin, const size_t right_uid, const size_t right_pin)
 {
-    for (int i = 0; i < (*connections).size(); i++)
-    {
-        if ((*connections)[i]->getLeftUID() == left_uid && (*connections)[i]->getLeftPin() == left_pin &&
-            (*connections)[i]->getRightUID() == right_uid && (*connections)[i]->getRightPin() == right_pin)
-        {
-            return;
-        }
-    }
-    Connection** connection = (*connections).emplace_back();
-    (*connection)->setValues(left_uid, left_pin, right_uid, right_pin);
+    m_connectionIndex.add(*connections, { left_uid, left_pin, right_uid, right_pin });
+}
+
+inline bool GraphResource::removeConnection(const gflow::parser::ConnectionKey& key)
+{
+    return m_connectionIndex.remove(*connections, key);
+}
+
+inline void GraphResource::clearConnections()
+{
+    m_connectionIndex.clear(*connections);
 }
 
+inline const std::vector<gflow::parser::ConnectionKey>& GraphResource::getOutgoing(const size_t uid)
+{
+    return m_connectionIndex.getOutgoing(*connections, uid);
+}
+
+inline const std::vector<gflow::parser::ConnectionKey>& GraphResource::getIncoming(const size_t uid)
+{
+    return m_connectionIndex.getIncoming(*connections, uid);
+}
@@ -0,0 +1,187 @@
+#include "project_exporter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vulkan/vulkan.h>
+
+#include "resources/project.hpp"
+
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void writeString(std::ofstream& file, const std::string& str)
+{
+    writeValue(file, static_cast<uint16_t>(str.size()));
+    file.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+// The runtime loads SPIR-V, the shader is expected to be compiled next to its source (shader.vert -> shader.vert.spv)
+static std::string getShaderBinaryPath(const gflow::parser::FilePath& path)
+{
+    return path.path.empty() ? "" : path.path + ".spv";
+}
+
+static void writeRequirements(std::ofstream& file)
+{
+    writeValue(file, VkPhysicalDeviceFeatures{});
+    writeValue(file, static_cast<VkQueueFlags>(VK_QUEUE_GRAPHICS_BIT));
+    writeValue(file, true);
+    writeValue(file, static_cast<uint16_t>(0));
+}
+
+static void writeImages(std::ofstream& file, const std::vector<gflow::parser::ProjectImageSource*>& images)
+{
+    using namespace gflow::parser;
+
+    writeValue(file, static_cast<uint16_t>(images.size()));
+    for (ProjectImageSource* image : images)
+    {
+        const Vec2 size = image->getValue<Vec2>("size");
+        const Color color = image->getValue<Color>("color");
+        writeString(file, image->getValue<std::string>("imageID"));
+        writeValue(file, EnumContexts::format.values[image->getValue<EnumExport>("format").id]);
+        writeValue(file, static_cast<uint8_t>(EnumContexts::ImageSource.values[image->getValue<EnumExport>("source").id]));
+        writeValue(file, image->getValue<bool>("matchScreen"));
+        writeValue(file, static_cast<uint32_t>(size.x));
+        writeValue(file, static_cast<uint32_t>(size.y));
+        writeValue(file, color);
+        writeString(file, image->getValue<FilePath>("path").path);
+    }
+}
+
+static void writePipeline(std::ofstream& file, gflow::parser::Pipeline* pipeline)
+{
+    using namespace gflow::parser;
+
+    auto* inputAssembly = pipeline->getValue<PipelineInputAssemblyState*>("inputAssemblyState");
+    auto* rasterization = pipeline->getValue<PipelineRasterizationState*>("rasterizationState");
+    auto* depthStencil = pipeline->getValue<PipelineDepthStencilState*>("depthStencilState");
+    auto* colorBlend = pipeline->getValue<PipelineColorBlendState*>("colorBlendState");
+
+    writeString(file, getShaderBinaryPath(pipeline->getValue<FilePath>("vertex")));
+    writeString(file, getShaderBinaryPath(pipeline->getValue<FilePath>("fragment")));
+    writeValue(file, EnumContexts::primitiveTopology.values[inputAssembly->getValue<EnumExport>("topology").id]);
+    writeValue(file, EnumContexts::polygonMode.values[rasterization->getValue<EnumExport>("polygonMode").id]);
+    writeValue(file, EnumContexts::cullMode.values[rasterization->getValue<EnumExport>("cullMode").id]);
+    writeValue(file, EnumContexts::frontFace.values[rasterization->getValue<EnumExport>("frontFace").id]);
+    writeValue(file, depthStencil->getValue<bool>("depthTestEnable"));
+    writeValue(file, EnumContexts::compareOp.values[depthStencil->getValue<EnumExport>("depthCompareOp").id]);
+
+    std::vector<VkPipelineColorBlendAttachmentState> blendAttachments;
+    for (PipelineColorBlendAttachment* attachment : colorBlend->getValue<List<PipelineColorBlendAttachment*>*>("colorBlendAttachments")->data())
+    {
+        VkPipelineColorBlendAttachmentState& state = blendAttachments.emplace_back();
+        state.blendEnable = attachment->getValue<bool>("blendEnable") ? VK_TRUE : VK_FALSE;
+        state.srcColorBlendFactor = static_cast<VkBlendFactor>(EnumContexts::blendFactor.values[attachment->getValue<EnumExport>("srcColorBlendFactor").id]);
+        state.dstColorBlendFactor = static_cast<VkBlendFactor>(EnumContexts::blendFactor.values[attachment->getValue<EnumExport>("dstColorBlendFactor").id]);
+        state.colorBlendOp = static_cast<VkBlendOp>(EnumContexts::blendOp.values[attachment->getValue<EnumExport>("colorBlendOp").id]);
+        state.srcAlphaBlendFactor = static_cast<VkBlendFactor>(EnumContexts::blendFactor.values[attachment->getValue<EnumExport>("srcAlphaBlendFactor").id]);
+        state.dstAlphaBlendFactor = static_cast<VkBlendFactor>(EnumContexts::blendFactor.values[attachment->getValue<EnumExport>("dstAlphaBlendFactor").id]);
+        state.alphaBlendOp = static_cast<VkBlendOp>(EnumContexts::blendOp.values[attachment->getValue<EnumExport>("alphaBlendOp").id]);
+        state.colorWriteMask = attachment->getValue<EnumBitmask>("colorWriteMask").mask;
+    }
+    writeValue(file, static_cast<uint16_t>(blendAttachments.size()));
+    file.write(reinterpret_cast<const char*>(blendAttachments.data()), static_cast<std::streamsize>(blendAttachments.size() * sizeof(VkPipelineColorBlendAttachmentState)));
+
+    // Push constant ranges depend on the render pass the pipeline is bound in, the runtime does not push any yet
+    writeValue(file, static_cast<uint16_t>(0));
+}
+
+template <typename T>
+static uint16_t findIndex(const std::vector<T>& values, const T& value, const std::string& error)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (values[i] == value)
+            return static_cast<uint16_t>(i);
+    }
+    throw std::runtime_error(error);
+}
+
+void ProjectExporter::exportProject(gflow::parser::Project* project, const std::string& path)
+{
+    using namespace gflow::parser;
+
+    std::vector<std::string> imageIDs;
+    for (ProjectImageSource* image : project->getImages())
+        imageIDs.push_back(image->getValue<std::string>("imageID"));
+
+    // Draw calls reference pipelines by index, each pipeline is written once no matter how many draw calls use it
+    std::vector<Pipeline*> pipelines;
+    for (ProjectRenderpass* renderpass : project->getRenderpasses())
+        for (const ProjectRenderpassSubpass* subpass : renderpass->getSubpasses())
+            for (ProjectRenderpassDrawCall* drawCall : subpass->getDrawCalls())
+                if (drawCall->getPipeline() != nullptr && std::ranges::find(pipelines, drawCall->getPipeline()) == pipelines.end())
+                    pipelines.push_back(drawCall->getPipeline());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open project file for writing: " + path);
+
+    // Section positions are patched once the sections are written
+    size_t requirementsPos = 0, renderPassPos = 0, resourcesPos = 0;
+    writeValue(file, requirementsPos);
+    writeValue(file, renderPassPos);
+    writeValue(file, resourcesPos);
+
+    requirementsPos = static_cast<size_t>(file.tellp());
+    writeRequirements(file);
+
+    resourcesPos = static_cast<size_t>(file.tellp());
+    writeImages(file, project->getImages());
+    writeValue(file, static_cast<uint16_t>(pipelines.size()));
+    for (Pipeline* pipeline : pipelines)
+        writePipeline(file, pipeline);
+
+    renderPassPos = static_cast<size_t>(file.tellp());
+    writeValue(file, static_cast<uint16_t>(project->getRenderpasses().size()));
+    for (ProjectRenderpass* projectRenderpass : project->getRenderpasses())
+    {
+        const RenderPass* renderpass = projectRenderpass->getRenderpass();
+        if (renderpass == nullptr)
+            throw std::runtime_error("Project render pass has no render pass resource assigned");
+
+        const std::vector<std::string> attachmentIDs = renderpass->getAttachmentIDs();
+        writeValue(file, static_cast<uint16_t>(attachmentIDs.size()));
+        for (const ImageAttachment* attachment : renderpass->getAttachments())
+        {
+            writeValue(file, findIndex(imageIDs, attachment->getImageID(), "Render pass attachment " + attachment->getImageID() + " is not a project image"));
+            writeValue(file, attachment->isClear());
+        }
+
+        // The execution graph fills one project subpass per render pass subpass, in the same order
+        const std::vector<ProjectRenderpassSubpass*>& subpasses = projectRenderpass->getSubpasses();
+        writeValue(file, static_cast<uint16_t>(subpasses.size()));
+        for (size_t i = 0; i < subpasses.size(); ++i)
+        {
+            const std::vector<SubpassAttachment*> references = i < renderpass->getSubpasses().size() ? renderpass->getSubpasses()[i]->getAttachments() : std::vector<SubpassAttachment*>{};
+            writeValue(file, static_cast<uint16_t>(references.size()));
+            for (const SubpassAttachment* reference : references)
+            {
+                writeValue(file, findIndex(attachmentIDs, reference->getImageID(), "Subpass attachment " + reference->getImageID() + " is not a render pass attachment"));
+                writeValue(file, static_cast<uint8_t>(reference->getAttachmentType()));
+            }
+
+            std::vector<ProjectRenderpassDrawCall*> drawCalls;
+            for (ProjectRenderpassDrawCall* drawCall : subpasses[i]->getDrawCalls())
+                if (drawCall->getPipeline() != nullptr)
+                    drawCalls.push_back(drawCall);
+            writeValue(file, static_cast<uint16_t>(drawCalls.size()));
+            for (ProjectRenderpassDrawCall* drawCall : drawCalls)
+            {
+                writeValue(file, findIndex(pipelines, drawCall->getPipeline(), "Draw call pipeline was not written"));
+                writeValue(file, static_cast<uint32_t>(drawCall->getVertexCount()));
+            }
+        }
+    }
+
+    file.seekp(0);
+    writeValue(file, requirementsPos);
+    writeValue(file, renderPassPos);
+    writeValue(file, resourcesPos);
+    file.close();
+}
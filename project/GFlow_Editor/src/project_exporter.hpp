@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+
+namespace gflow::parser
+{
+    class Project;
+}
+
+// Writes the built project in the binary format gflow::Project (GFlow_Core/src/core_project.cpp) reads. Paths are
+// stored relative to the working directory, so the file has to be written there for the runtime to find them
+class ProjectExporter
+{
+public:
+    static void exportProject(gflow::parser::Project* project, const std::string& path);
+};
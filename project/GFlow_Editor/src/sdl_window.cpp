@@ -132,6 +132,21 @@ void SDLWindow::shutdownImgui() const
     ImGui_ImplSDL2_Shutdown();
 }
 
+std::string SDLWindow::getUserDataPath()
+{
+    char* path = SDL_GetPrefPath("GFlow", "Editor");
+    if (path == nullptr)
+        path = SDL_GetBasePath();
+    if (path == nullptr)
+    {
+        Logger::print(Logger::WARN, "No user data directory available: ", SDL_GetError());
+        return "";
+    }
+    std::string result = path;
+    SDL_free(path);
+    return result;
+}
+
 Signal<uint32_t, uint32_t>& SDLWindow::getResizeSignal()
 {
     return m_resizeSignal;
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <string_view>
 #include <vector>
 #include <SDL2/SDL_vulkan.h>
@@ -46,6 +47,10 @@ public:
     void free();
 	void shutdownImgui() const;
 
+	// Per user writable directory for the editor's own files, ends with a separator. Falls back to the directory of
+	// the executable if the platform has none
+	[[nodiscard]] static std::string getUserDataPath();
+
 	[[nodiscard]] Signal<uint32_t, uint32_t>& getResizeSignal();
     [[nodiscard]] Signal<>& getSaveInputSignal();
 
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
 
-#define IMGUI_NAME(name) (name + std::string("##") + m_name).c_str()
+#include "frame_arena.hpp"
+
+// Only valid until the end of the frame
+#define IMGUI_NAME(name) FrameArena::concat(name, "##", m_name)
 
 class ImGuiEditorWindow
 {
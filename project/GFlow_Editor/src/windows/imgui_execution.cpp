@@ -2,83 +2,186 @@
 
 #include "editor.hpp"
 #include "imgui.h"
+#include "profiler.hpp"
+#include "metaresources/execution_analysis.hpp"
 #include "nodes/execution_nodes.hpp"
+#include "nodes/node_registry.hpp"
 #include "resources/project.hpp"
 
-class NodeCreateHelper
+ImGuiExecutionWindow::ImGuiExecutionWindow(const std::string& name, const bool defaultOpen)
+: ImGuiGraphWindow(name, defaultOpen)
 {
-public:
-    template <typename T, typename Tr>
-    static std::shared_ptr<T> createNode(ImGuiExecutionWindow* window)
-    {
-        Tr* resource = window->m_selectedExecMeta->addNode<Tr>();
-        const std::shared_ptr<T> newNode = window->m_grid.placeNode<T>(window, resource);
-        resource->setPos({ newNode->getPos().x, newNode->getPos().y });
-        resource->setNodeID(newNode->getUID());
-        newNode->getDestroyedSignal().connect(window, &ImGuiExecutionWindow::onNodeDestroyed);
-        return newNode;
-    }
+    m_refreshRequestedSignal.connect(this, &ImGuiExecutionWindow::buildProject);
+}
 
-    template <typename T, typename Tr>
-    static std::shared_ptr<T> createNodeAtPlace(ImGuiExecutionWindow* window, const ImVec2& pos)
+// What a render pass of the project should contain according to the graph. Draw calls without a pipeline are left
+// out, the exporter and the runtime would skip them anyway
+struct CompiledDrawCall
+{
+    gflow::parser::Pipeline* pipeline = nullptr;
+    int vertexCount = 0;
+};
+
+struct CompiledRenderpass
+{
+    gflow::parser::RenderPass* renderpass = nullptr;
+    std::vector<std::vector<CompiledDrawCall>> subpasses{};
+};
+
+static bool matchesCompiled(gflow::parser::ProjectRenderpass* renderpassResource, const CompiledRenderpass& compiled)
+{
+    if (renderpassResource->getRenderpass() != compiled.renderpass)
+        return false;
+    const std::vector<gflow::parser::ProjectRenderpassSubpass*>& subpasses = renderpassResource->getSubpasses();
+    if (subpasses.size() != compiled.subpasses.size())
+        return false;
+    for (size_t i = 0; i < subpasses.size(); ++i)
     {
-        Tr* resource = window->m_selectedExecMeta->addNode<Tr>();
-        const std::shared_ptr<T> newNode = window->m_grid.addNode<T>(pos, window, resource);
-        resource->setPos({ newNode->getPos().x, newNode->getPos().y });
-        resource->setNodeID(newNode->getUID());
-        newNode->getDestroyedSignal().connect(window, &ImGuiExecutionWindow::onNodeDestroyed);
-        return newNode;
+        const std::vector<gflow::parser::ProjectRenderpassDrawCall*>& drawCalls = subpasses[i]->getDrawCalls();
+        if (drawCalls.size() != compiled.subpasses[i].size())
+            return false;
+        for (size_t j = 0; j < drawCalls.size(); ++j)
+        {
+            const CompiledDrawCall& drawCall = compiled.subpasses[i][j];
+            if (drawCalls[j]->getPipeline() != drawCall.pipeline || drawCalls[j]->getVertexCount() != drawCall.vertexCount)
+                return false;
+        }
     }
-};
+    return true;
+}
 
-ImGuiExecutionWindow::ImGuiExecutionWindow(const std::string& name, const bool defaultOpen)
-: ImGuiGraphWindow(name, defaultOpen)
+static void fillCompiled(gflow::parser::ProjectRenderpass* renderpassResource, const CompiledRenderpass& compiled)
 {
-    m_refreshRequestedSignal.connect(this, &ImGuiExecutionWindow::buildProject);
+    renderpassResource->setRenderpass(compiled.renderpass);
+    renderpassResource->clearSubpasses();
+    for (const std::vector<CompiledDrawCall>& drawCalls : compiled.subpasses)
+    {
+        gflow::parser::ProjectRenderpassSubpass* subpassResource = renderpassResource->addSubpass();
+        for (const CompiledDrawCall& drawCall : drawCalls)
+        {
+            gflow::parser::ProjectRenderpassDrawCall* drawCallResource = subpassResource->addDrawCall();
+            drawCallResource->setPipeline(drawCall.pipeline);
+            drawCallResource->setVertexCount(drawCall.vertexCount);
+        }
+    }
 }
 
 void ImGuiExecutionWindow::buildProject()
 {
     if (m_selectedExecMeta == nullptr) return;
-    Editor::getCurrentProject()->clear();
+    GFLOW_PROFILE_ZONE("Build project");
+
+    // The analysis reads the connections from the resource, which only gets the links of the grid on save
+    saveExecution();
+    ExecutionAnalysis::Result analysis = ExecutionAnalysis::analyze(*m_selectedExecMeta);
+    for (const std::shared_ptr<ImFlow::BaseNode>& node : m_grid.getNodes() | std::views::values)
+    {
+        GFlowNode* gnode = dynamic_cast<GFlowNode*>(node.get());
+        if (gnode == nullptr) continue;
+        const auto diagnostics = analysis.diagnostics.find(gnode->getUID());
+        if (diagnostics != analysis.diagnostics.end())
+            gnode->setDiagnostics(std::move(diagnostics->second));
+        else
+            gnode->clearDiagnostics();
+    }
+    if (analysis.chainLoops)
+    {
+        Logger::print(Logger::WARN, "The execution chain loops back on itself, the project was not built");
+        return;
+    }
+    if (!analysis.cycles.empty() || !analysis.unreachable.empty())
+        Logger::print(Logger::DEBUG, "Execution graph has ", analysis.cycles.size(), " cycles and ", analysis.unreachable.size(), " unreachable nodes");
+
+    // The walk only collects what the project should contain, the project is patched against it afterwards
+    std::vector<CompiledRenderpass> compiled{};
+    bool insideRenderpass = false;
+    // Indices of the built project, the same ones the core library profiles with
+    GPUScope scope{};
+    uint32_t endedRenderpass = gflow::GPUProfiler::c_none;
     GFlowNode* next = getInit()->getNext();
-    gflow::parser::ProjectRenderpassSubpass* subpassResource = nullptr;
-    gflow::parser::ProjectRenderpass* renderpassResource = nullptr;
     while (next != nullptr)
     {
         if (BeginExecutionNode* beginNode = dynamic_cast<BeginExecutionNode*>(next))
         {
             BeginExecutionNodeResource* beginResource = dynamic_cast<BeginExecutionNodeResource*>(beginNode->getLinkedResource());
-            renderpassResource = Editor::getCurrentProject()->addRenderpass();
-            renderpassResource->setRenderpass(beginResource->getRenderpass());
-            subpassResource = renderpassResource->addSubpass();
-            processRenderpassConnections(beginNode, renderpassResource);
+            compiled.push_back({ beginResource->getRenderpass(), { {} } });
+            insideRenderpass = true;
+            processRenderpassConnections(beginNode, beginResource->getRenderpass());
+            scope = { static_cast<uint32_t>(compiled.size() - 1), 0, 0 };
+            beginNode->setGPUScope({ scope.renderpass });
             next = beginNode->getNext();
         }
         else if (const NextExecutionNode* nextNode = dynamic_cast<NextExecutionNode*>(next))
         {
-            subpassResource = renderpassResource->addSubpass();
+            if (insideRenderpass)
+            {
+                compiled.back().subpasses.emplace_back();
+                scope.subpass++;
+                scope.drawCall = 0;
+            }
             next = nextNode->getNext();
         }
         else if (const EndExecutionNode* endNode = dynamic_cast<EndExecutionNode*>(next))
         {
-            renderpassResource = nullptr;
+            if (insideRenderpass)
+                endedRenderpass = scope.renderpass;
+            insideRenderpass = false;
             next = endNode->getNext();
         }
+        else if (WatcherNode* watcherNode = dynamic_cast<WatcherNode*>(next))
+        {
+            watcherNode->setGPUScope({ endedRenderpass });
+            next = watcherNode->getNext();
+        }
         else if (BindPushConstantNode* bindNode = dynamic_cast<BindPushConstantNode*>(next))
         {
-            processBindPushConstantConnections(bindNode, renderpassResource);
+            processBindPushConstantConnections(bindNode, insideRenderpass ? compiled.back().renderpass : nullptr);
             next = bindNode->getNext();
         }
         else if (DrawCallNode* drawNode = dynamic_cast<DrawCallNode*>(next))
         {
-            gflow::parser::ProjectRenderpassDrawCall* drawCallResource = subpassResource->addDrawCall();
-            DrawCallNodeResource* drawCallNodeResource = dynamic_cast<DrawCallNodeResource*>(drawNode->getLinkedResource());
-            drawCallResource->setPipeline(drawCallNodeResource->getPipeline());
-            processDrawCallConnections(drawNode, drawCallResource);
+            DrawCallNodeResource* drawResource = dynamic_cast<DrawCallNodeResource*>(drawNode->getLinkedResource());
+            gflow::parser::Pipeline* pipeline = drawResource->getPipeline();
+            processDrawCallConnections(drawNode, pipeline);
+            // Draw calls outside of a render pass or without a pipeline don't end up in the project, nor in its numbering
+            if (insideRenderpass && pipeline != nullptr)
+            {
+                compiled.back().subpasses.back().push_back({ pipeline, drawResource->getVertexCount() });
+                drawNode->setGPUScope({ scope.renderpass, scope.subpass, scope.drawCall++ });
+            }
+            else
+                drawNode->setGPUScope({});
             next = drawNode->getNext();
         }
+        else break;
     }
+
+    gflow::parser::Project* project = Editor::getCurrentProject();
+    const std::vector<gflow::parser::ProjectRenderpass*>& renderpasses = project->getRenderpasses();
+    ProjectChangeSet changes{};
+    for (uint32_t i = 0; i < compiled.size(); ++i)
+    {
+        if (i >= renderpasses.size())
+        {
+            fillCompiled(project->addRenderpass(), compiled[i]);
+            changes.added.push_back(i);
+        }
+        else if (!matchesCompiled(renderpasses[i], compiled[i]))
+        {
+            fillCompiled(renderpasses[i], compiled[i]);
+            changes.modified.push_back(i);
+        }
+    }
+    for (uint32_t i = static_cast<uint32_t>(renderpasses.size()); i > compiled.size(); --i)
+    {
+        project->removeRenderpass(static_cast<int>(i - 1));
+        changes.removed.insert(changes.removed.begin(), i - 1);
+    }
+
+    // Emitted even when nothing changed, the first build after loading a project still has to be previewed
+    if (!changes.empty())
+        Logger::print(Logger::DEBUG, "Project build added ", changes.added.size(), ", modified ", changes.modified.size(), " and removed ", changes.removed.size(), " render passes");
+    m_projectChangedSignal.emit(changes);
 }
 
 void ImGuiExecutionWindow::onProjectLoaded()
@@ -101,11 +204,11 @@ void ImGuiExecutionWindow::onProjectLoaded()
     else
     {
         m_selectedExecMeta = gflow::parser::ResourceManager::createResource<ExecutionResource>(metaPath, nullptr);
-        const std::shared_ptr<InitExecutionNode> newNode = NodeCreateHelper::createNodeAtPlace<InitExecutionNode, InitNodeResource>(this, {20, 20});
+        const ImVec2 initPos{ 20, 20 };
+        createNode(*NodeRegistry::find(InitNodeResource::getTypeStatic()), &initPos);
         m_selectedExecMeta->serialize();
         loadExecution(false);
     }
-    loadExecution();
 }
 
 void ImGuiExecutionWindow::save()
@@ -123,78 +226,51 @@ void ImGuiExecutionWindow::onNodeDestroyed(GFlowNode* node)
     }
 }
 
+// Draws the items of a submenu, returns the node picked if any
+static const NodeRegistry::Entry* drawNodeMenu(const NodeRegistry::MenuItem& menu)
+{
+    const NodeRegistry::Entry* picked = nullptr;
+    for (const NodeRegistry::MenuItem& item : menu.children)
+    {
+        if (item.entry != nullptr)
+        {
+            if (ImGui::MenuItem(item.label.c_str()))
+                picked = item.entry;
+        }
+        else if (ImGui::BeginMenu(item.label.c_str()))
+        {
+            if (const NodeRegistry::Entry* entry = drawNodeMenu(item))
+                picked = entry;
+            ImGui::EndMenu();
+        }
+    }
+    return picked;
+}
+
 void ImGuiExecutionWindow::rightClick(ImFlow::BaseNode* node)
 {
     if (node == nullptr)
     {
         if (ImGui::BeginMenu("Add node"))
         {
-            if (ImGui::BeginMenu("Renderpass"))
-            {
-                if (ImGui::MenuItem("Begin"))
-                    NodeCreateHelper::createNode<BeginExecutionNode, BeginExecutionNodeResource>(this);
-                if (ImGui::MenuItem("Next"))
-                    NodeCreateHelper::createNode<NextExecutionNode, NextExecutionNodeResource>(this);
-                if (ImGui::MenuItem("End"))
-                    NodeCreateHelper::createNode<EndExecutionNode, EndExecutionNodeResource>(this);
-                if (ImGui::MenuItem("Draw Call"))
-                    NodeCreateHelper::createNode<DrawCallNode, DrawCallNodeResource>(this);
-                if (ImGui::MenuItem("Bind Push Constant"))
-                    NodeCreateHelper::createNode<BindPushConstantNode, BindPushConstantNodeResource>(this);
-                ImGui::EndMenu();
-            }
-            if (ImGui::BeginMenu("Resources"))
-            {
-                if (ImGui::MenuItem("Image"))
-                    NodeCreateHelper::createNode<ImageNode, ImageNodeResource>(this);
-                if (ImGui::MenuItem("Model"))
-                    NodeCreateHelper::createNode<ModelNode, ModelNodeResource>(this);
-                if (ImGui::MenuItem("Data Decompose"))
-                    NodeCreateHelper::createNode<DataDecomposeNode, DataDecomposeNodeResource>(this);
-                if (ImGui::MenuItem("External Argument"))
-                    NodeCreateHelper::createNode<ExternalArgumentNode, ExternalArgumentNodeResource>(this);
-                if (ImGui::BeginMenu("Camera"))
-                {
-                    if (ImGui::MenuItem("Flight"))
-                        NodeCreateHelper::createNode<CameraFlightNode, CameraNodeResource>(this);
-                    if (ImGui::MenuItem("Object"))
-                        NodeCreateHelper::createNode<CameraObjectNode, ObjectCameraNodeResource>(this);
-                    ImGui::EndMenu();
-                }
-                if (ImGui::BeginMenu("Primitives"))
-                {
-                    if (ImGui::BeginMenu("Data Types"))
-                    {
-                        if (ImGui::MenuItem("Float"))
-                            NodeCreateHelper::createNode<PrimitiveFloatNode, PrimitiveFloatNodeResource>(this);
-                        if (ImGui::MenuItem("Int"))
-                            NodeCreateHelper::createNode<PrimitiveIntNode, PrimitiveIntNodeResource>(this);
-                        if (ImGui::MenuItem("Color"))
-                            NodeCreateHelper::createNode<PrimitiveColorNode, PrimitiveColorNodeResource>(this);
-                        if (ImGui::MenuItem("Vec2"))
-                            NodeCreateHelper::createNode<PrimitiveVec2Node, PrimitiveVec2NodeResource>(this);
-                        if (ImGui::MenuItem("Vec3"))
-                            NodeCreateHelper::createNode<PrimitiveVec3Node, PrimitiveVec3NodeResource>(this);
-                        if (ImGui::MenuItem("Vec4"))
-                            NodeCreateHelper::createNode<PrimitiveVec4Node, PrimitiveVec4NodeResource>(this);
-                        if (ImGui::MenuItem("Mat3"))
-                            NodeCreateHelper::createNode<PrimitiveMat3Node, PrimitiveMat3NodeResource>(this);
-                        if (ImGui::MenuItem("Mat4"))
-                            NodeCreateHelper::createNode<PrimitiveMat4Node, PrimitiveMat4NodeResource>(this);
-                        ImGui::EndMenu();
-                    }
-                    ImGui::EndMenu();
-                }
-                ImGui::EndMenu();
-            }
-            if (ImGui::MenuItem("Watcher"))
-                NodeCreateHelper::createNode<WatcherNode, WatcherNodeResource>(this);
+            if (const NodeRegistry::Entry* entry = drawNodeMenu(NodeRegistry::getMenu()))
+                createNode(*entry);
             ImGui::EndMenu();
         }
     }
     else ImGuiGraphWindow::rightClick(node);
 }
 
+GFlowNode* ImGuiExecutionWindow::createNode(const NodeRegistry::Entry& entry, const ImVec2* pos)
+{
+    NodeResource* resource = entry.createResource(m_selectedExecMeta);
+    GFlowNode* newNode = entry.createNode(m_grid, pos, this, resource).get();
+    resource->setPos({ newNode->getPos().x, newNode->getPos().y });
+    resource->setNodeID(newNode->getUID());
+    newNode->getDestroyedSignal().connect(this, &ImGuiExecutionWindow::onNodeDestroyed);
+    return newNode;
+}
+
 void ImGuiExecutionWindow::saveExecution()
 {
     if (m_selectedExecMeta == nullptr) return;
@@ -221,72 +297,50 @@ void ImGuiExecutionWindow::saveExecution()
 
 void ImGuiExecutionWindow::loadExecution(const bool loadInit)
 {
-    for (int i = 0; i < m_selectedExecMeta->getNodes().size(); ++i)
+    // Every node is created before any link so links never wait on a node further down the list
+    const gflow::parser::List<NodeResource*>& resources = m_selectedExecMeta->getNodes();
+    std::unordered_map<size_t, GFlowNode*> loadedNodes{};
+    loadedNodes.reserve(resources.size());
+    for (int i = 0; i < resources.size(); ++i)
     {
-        NodeResource* resource = m_selectedExecMeta->getNodes()[i];
-        GFlowNode* newNode = nullptr;
-        if (resource->getType() == "InitNodeResource" && loadInit)
-            newNode = m_grid.placeNode<InitExecutionNode>(this, resource).get();
-        else if (resource->getType() == "BeginExecutionNodeResource" && loadInit)
-            newNode = m_grid.placeNode<BeginExecutionNode>(this, resource).get();
-        else if (resource->getType() == "NextExecutionNodeResource")
-            newNode = m_grid.placeNode<NextExecutionNode>(this, resource).get();
-        else if (resource->getType() == "EndExecutionNodeResource")
-            newNode = m_grid.placeNode<EndExecutionNode>(this, resource).get();
-        else if (resource->getType() == "BindPushConstantNodeResource")
-            newNode = m_grid.placeNode<BindPushConstantNode>(this, resource).get();
-        else if (resource->getType() == "DrawCallNodeResource")
-            newNode = m_grid.placeNode<DrawCallNode>(this, resource).get();
-        else if (resource->getType() == "ImageNodeResource")
-            newNode = m_grid.placeNode<ImageNode>(this, resource).get();
-        else if (resource->getType() == "ModelNodeResource")
-            newNode = m_grid.placeNode<ModelNode>(this, resource).get();
-        else if (resource->getType() == "DataDecomposeNodeResource")
-            newNode = m_grid.placeNode<DataDecomposeNode>(this, resource).get();
-        else if (resource->getType() == "PrimitiveFloatNodeResource")
-            newNode = m_grid.placeNode<PrimitiveFloatNode>(this, resource).get();
-        else if (resource->getType() == "PrimitiveIntNodeResource")
-            newNode = m_grid.placeNode<PrimitiveIntNode>(this, resource).get();
-        else if (resource->getType() == "PrimitiveColorNodeResource")
-            newNode = m_grid.placeNode<PrimitiveColorNode>(this, resource).get();
-        else if (resource->getType() == "PrimitiveVec2NodeResource")
-            newNode = m_grid.placeNode<PrimitiveVec2Node>(this, resource).get();
-        else if (resource->getType() == "PrimitiveVec3NodeResource")
-            newNode = m_grid.placeNode<PrimitiveVec3Node>(this, resource).get();
-        else if (resource->getType() == "PrimitiveVec4NodeResource")
-            newNode = m_grid.placeNode<PrimitiveVec4Node>(this, resource).get();
-        else if (resource->getType() == "PrimitiveMat3NodeResource")
-            newNode = m_grid.placeNode<PrimitiveMat3Node>(this, resource).get();
-        else if (resource->getType() == "PrimitiveMat4NodeResource")
-            newNode = m_grid.placeNode<PrimitiveMat4Node>(this, resource).get();
-        else if (resource->getType() == "ExternalArgumentNodeResource")
-            newNode = m_grid.placeNode<ExternalArgumentNode>(this, resource).get();
-        else if (resource->getType() == "WatcherNodeResource")
-            newNode = m_grid.placeNode<WatcherNode>(this, resource).get();
-        else if (resource->getType() == "ObjectCameraNodeResource")
-            newNode = m_grid.placeNode<CameraObjectNode>(this, resource).get();
-        else if (resource->getType() == "CameraFlightNodeResource")
-            newNode = m_grid.placeNode<CameraFlightNode>(this, resource).get();
-
-        if (!newNode) continue;
+        NodeResource* resource = resources[i];
+        const NodeRegistry::Entry* entry = NodeRegistry::find(resource->getType());
+        if (entry == nullptr)
+        {
+            Logger::print(Logger::WARN, "Execution node of unknown type ", resource->getType(), " was not loaded");
+            continue;
+        }
+        if ((entry->flags & NODE_LOADS_WITH_INIT) && !loadInit) continue;
 
+        GFlowNode* newNode = entry->createNode(m_grid, nullptr, this, resource).get();
         newNode->setPos({ resource->getPos().x, resource->getPos().y });
         newNode->setUID(resource->getNodeID());
         newNode->getDestroyedSignal().connect(this, &ImGuiExecutionWindow::onNodeDestroyed);
+        loadedNodes[resource->getNodeID()] = newNode;
     }
 
-    for (int i = 0; i < m_selectedExecMeta->getConnections().size(); ++i)
+    // Nodes already on the grid, like a freshly created init node, are looked up there instead
+    const auto findNode = [&](const size_t uid) -> ImFlow::BaseNode*
     {
-        const Connection* connection = m_selectedExecMeta->getConnections()[i];
-        ImFlow::Pin* left = m_grid.getNodes().at(connection->getLeftUID())->outPin(connection->getLeftPin());
-        ImFlow::Pin* right = m_grid.getNodes().at(connection->getRightUID())->inPin(connection->getRightPin());
-        left->createLink(right);
+        if (const auto it = loadedNodes.find(uid); it != loadedNodes.end())
+            return it->second;
+        const auto it = m_grid.getNodes().find(uid);
+        return it != m_grid.getNodes().end() ? it->second.get() : nullptr;
+    };
+    const gflow::parser::List<gflow::parser::Connection*>& connections = m_selectedExecMeta->getConnections();
+    for (int i = 0; i < connections.size(); ++i)
+    {
+        const gflow::parser::Connection* connection = connections[i];
+        ImFlow::BaseNode* leftNode = findNode(connection->getLeftUID());
+        ImFlow::BaseNode* rightNode = findNode(connection->getRightUID());
+        if (leftNode == nullptr || rightNode == nullptr) continue;
+        leftNode->outPin(connection->getLeftPin())->createLink(rightNode->inPin(connection->getRightPin()));
     }
 }
 
-void ImGuiExecutionWindow::processRenderpassConnections(BeginExecutionNode* renderpassNode, gflow::parser::ProjectRenderpass* renderpassResource) const
+void ImGuiExecutionWindow::processRenderpassConnections(BeginExecutionNode* renderpassNode, gflow::parser::RenderPass* renderpass) const
 {
-    if (renderpassResource->getRenderpass() == nullptr)
+    if (renderpass == nullptr)
     {
         renderpassNode->removeAllReflectionPins();
         return;
@@ -295,7 +349,7 @@ void ImGuiExecutionWindow::processRenderpassConnections(BeginExecutionNode* rend
     const std::unordered_set<std::string> oldAttachments = renderpassNode->getAttachments();
 
     std::unordered_set<std::string> newAttachments{};
-    for (const std::string& attachment : renderpassResource->getRenderpass()->getAttachmentIDs())
+    for (const std::string& attachment : renderpass->getAttachmentIDs())
         newAttachments.insert(attachment);
     
     for (const std::string& attachment : oldAttachments)
@@ -306,15 +360,14 @@ void ImGuiExecutionWindow::processRenderpassConnections(BeginExecutionNode* rend
             renderpassNode->addAttachmentPin(attachment, true);
 }
 
-void ImGuiExecutionWindow::processDrawCallConnections(DrawCallNode* drawNode, gflow::parser::ProjectRenderpassDrawCall* drawCallResource) const
+void ImGuiExecutionWindow::processDrawCallConnections(DrawCallNode* drawNode, gflow::parser::Pipeline* pipeline) const
 {
-    if (drawCallResource->getPipeline() == nullptr)
+    if (pipeline == nullptr)
     {
         drawNode->setModelPin(false, false);
         return;
     }
 
-    gflow::parser::Pipeline* pipeline = drawCallResource->getPipeline();
     pipeline->getShaderReflectionData(gflow::parser::Pipeline::VERTEX);
     /*if (reflectionData == nullptr)
     {
@@ -325,15 +378,17 @@ void ImGuiExecutionWindow::processDrawCallConnections(DrawCallNode* drawNode, gf
     // Check if the vertex shader has vertex inputs
 }
 
-void ImGuiExecutionWindow::processBindPushConstantConnections(BindPushConstantNode* bindNode, gflow::parser::ProjectRenderpass* renderpassResource) const
+void ImGuiExecutionWindow::processBindPushConstantConnections(BindPushConstantNode* bindNode, gflow::parser::RenderPass* renderpass) const
 {
-    if (renderpassResource == nullptr || renderpassResource->getRenderpass() == nullptr)
+    if (renderpass == nullptr)
         return;
 
     if (bindNode->getPushConstantDataPin()->getLink().expired() || bindNode->getPushConstantDataPin()->getLink().lock()->left()->getParent() == nullptr)
+    {
+        bindNode->setLayout(nullptr);
         return;
+    }
 
-    gflow::parser::RenderPass* renderpass = renderpassResource->getRenderpass();
     const std::string structID = bindNode->getLinkedResource()->getValue<std::string>("structID");
     std::vector<std::string> pushConstants = renderpass->getPushConstantIDs(false);
     DataDecomposeNode* pushConstantNode = dynamic_cast<DataDecomposeNode*>(bindNode->getPushConstantDataPin()->getLink().lock()->left()->getParent());
@@ -341,6 +396,7 @@ void ImGuiExecutionWindow::processBindPushConstantConnections(BindPushConstantNo
     if (std::ranges::find(pushConstants, structID) == pushConstants.end())
     {
         pushConstantNode->removeAllReflectionPins();
+        bindNode->setLayout(nullptr);
         return;
     }
 
@@ -354,6 +410,8 @@ void ImGuiExecutionWindow::processBindPushConstantConnections(BindPushConstantNo
     for (const std::string& pin : newPins)
         if (std::ranges::find(oldPins, pin) == oldPins.end())
             pushConstantNode->addComponentPin(pin, true);
+
+    bindNode->setLayout(&renderpass->getPushConstantStructure(structID)->getLayout());
 }
 
 InitExecutionNode* ImGuiExecutionWindow::getInit()
@@ -3,15 +3,29 @@
 #include "ImNodeFlow.h"
 #include "metaresources/execution.hpp"
 #include "nodes/execution_nodes.hpp"
+#include "nodes/node_registry.hpp"
 #include "resources/project.hpp"
 
 class InitExecutionNode;
 
+// Render passes of the project that a build touched, by index. Removed indices refer to the project before the build
+struct ProjectChangeSet
+{
+    std::vector<uint32_t> added{};
+    std::vector<uint32_t> modified{};
+    std::vector<uint32_t> removed{};
+
+    [[nodiscard]] bool empty() const { return added.empty() && modified.empty() && removed.empty(); }
+};
+
 class ImGuiExecutionWindow final : public ImGuiGraphWindow
 {
 public:
     explicit ImGuiExecutionWindow(const std::string& name, bool defaultOpen = true);
+    // Only the render passes that differ from the graph are rebuilt, the rest of the project is left in place
     void buildProject();
+    // Emitted after every build, the change set is empty if the project already matched the graph
+    [[nodiscard]] Signal<const ProjectChangeSet&>& getProjectChangedSignal() { return m_projectChangedSignal; }
 
     void onProjectLoaded();
 
@@ -20,18 +34,19 @@ public:
 private:
     void onNodeDestroyed(GFlowNode* node);
     void rightClick(ImFlow::BaseNode* node) override;
+    // Adds a new node and its resource, at the mouse if there is no position
+    GFlowNode* createNode(const NodeRegistry::Entry& entry, const ImVec2* pos = nullptr);
 
     void saveExecution();
     void loadExecution(bool loadInit = true);
 
-    void processRenderpassConnections(BeginExecutionNode* renderpassNode, gflow::parser::ProjectRenderpass* renderpassResource) const;
-    void processDrawCallConnections(DrawCallNode* drawNode, gflow::parser::ProjectRenderpassDrawCall* drawCallResource) const;
-    void processBindPushConstantConnections(BindPushConstantNode* bindNode, gflow::parser::ProjectRenderpass* renderpassResource) const;
+    void processRenderpassConnections(BeginExecutionNode* renderpassNode, gflow::parser::RenderPass* renderpass) const;
+    void processDrawCallConnections(DrawCallNode* drawNode, gflow::parser::Pipeline* pipeline) const;
+    void processBindPushConstantConnections(BindPushConstantNode* bindNode, gflow::parser::RenderPass* renderpass) const;
 
     InitExecutionNode* getInit();
 
     ExecutionResource* m_selectedExecMeta = nullptr;
-
-    friend class NodeCreateHelper;
+    Signal<const ProjectChangeSet&> m_projectChangedSignal;
 };
 
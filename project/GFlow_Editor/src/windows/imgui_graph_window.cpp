@@ -1,5 +1,6 @@
 #include "imgui_graph_window.hpp"
 
+#include <algorithm>
 #include <bit>
 
 #include "nodes/base_node.hpp"
@@ -23,7 +24,10 @@ void ImGuiGraphWindow::drawBody()
 {
     if (ImGui::Button("Recalculate"))
         m_refreshRequestedSignal.emit();
+    m_showNodeDetail = m_grid.getGrid().scale() >= c_detailMinZoom;
+    parkHiddenNodes();
     m_grid.update();
+    restoreParkedNodes();
     ImGui::End();
     if (m_sidePanelTarget != nullptr)
     {
@@ -44,7 +48,66 @@ void ImGuiGraphWindow::clearGrid()
     m_grid.getNodeCreatedSignal().connect(this, &ImGuiGraphWindow::onNodeCreated);
     m_grid.getNodeDeletedSignal().connect(this, &ImGuiGraphWindow::onNodeDeleted);
     m_grid.getConnectionSignal().connect(this, &ImGuiGraphWindow::onConnection);
+    m_grid.getNodeDeletedSignal().connect(this, &ImGuiGraphWindow::forgetNode);
     m_grid.rightClickPopUpContent([this](ImFlow::BaseNode* node){this->rightClick(node);});
+    m_nodeIndex.clear();
+    m_parkedNodes.clear();
+    m_lastGridScale = 0.0f;
+}
+
+void ImGuiGraphWindow::parkHiddenNodes()
+{
+    // Parked nodes keep the pin positions of the last frame they were updated in, which only stay right while the
+    // view holds still. Any pan or zoom updates every node
+    const ImVec2 origin = m_grid.grid2screen({ 0.0f, 0.0f });
+    const float scale = m_grid.getGrid().scale();
+    const bool viewMoved = origin.x != m_lastGridOrigin.x || origin.y != m_lastGridOrigin.y || scale != m_lastGridScale;
+    m_lastGridOrigin = origin;
+    m_lastGridScale = scale;
+    if (viewMoved)
+        return;
+
+    // The grid takes the rest of the window
+    const ImVec2 screenMin = ImGui::GetCursorScreenPos();
+    const ImVec2 available = ImGui::GetContentRegionAvail();
+    const ImVec2 viewMin = m_grid.screen2grid(screenMin);
+    const ImVec2 viewMax = m_grid.screen2grid({ screenMin.x + available.x, screenMin.y + available.y });
+    m_nodeIndex.query({ viewMin.x - c_viewMargin, viewMin.y - c_viewMargin }, { viewMax.x + c_viewMargin, viewMax.y + c_viewMargin }, m_visibleNodes);
+
+    auto& nodes = m_grid.getNodes();
+    for (auto it = nodes.begin(); it != nodes.end();)
+    {
+        const auto& [uid, node] = *it;
+        // Nodes that were never indexed haven't been laid out yet, selected ones may be dragged into view
+        if (node->isSelected() || !m_nodeIndex.contains(uid) || std::ranges::binary_search(m_visibleNodes, uid))
+        {
+            ++it;
+            continue;
+        }
+        m_parkedNodes.emplace_back(uid, node);
+        it = nodes.erase(it);
+    }
+}
+
+void ImGuiGraphWindow::restoreParkedNodes()
+{
+    auto& nodes = m_grid.getNodes();
+    // Only the nodes that went through the update can have moved, resized or been created
+    for (const auto& [uid, node] : nodes)
+    {
+        const ImVec2 pos = node->getPos();
+        const ImVec2 size = node->getSize();
+        m_nodeIndex.update(uid, pos, { pos.x + size.x, pos.y + size.y });
+    }
+
+    for (auto& [uid, node] : m_parkedNodes)
+        nodes.emplace(uid, std::move(node));
+    m_parkedNodes.clear();
+}
+
+void ImGuiGraphWindow::forgetNode(ImFlow::BaseNode* node)
+{
+    m_nodeIndex.remove(node->getUID());
 }
 
 void ImGuiGraphWindow::rightClick(ImFlow::BaseNode* node)
@@ -1,6 +1,7 @@
 #pragma once
 #include "imgui_editor_window.hpp"
 #include "imgui_resource_editor.hpp"
+#include "node_spatial_index.hpp"
 #include "ImNodeFlow.h"
 
 class GFlowNode;
@@ -13,6 +14,10 @@ public:
 
     [[nodiscard]] Signal<const gflow::parser::ResourceElemPath&>& getSidePanelUpdateSignal() { return m_sidePanel.getVariableChangedSignal(); }
 
+    // Below this zoom the nodes skip their contents and only keep the header and pins
+    static constexpr float c_detailMinZoom = 0.6f;
+    [[nodiscard]] bool showsNodeDetail() const { return m_showNodeDetail; }
+
 protected:
     virtual void rightClick(ImFlow::BaseNode* node);
     void drawBody();
@@ -28,5 +33,22 @@ protected:
     GFlowNode* m_sidePanelTarget = nullptr;
     ImGuiResourceEditorWindow m_sidePanel;
     Signal<> m_refreshRequestedSignal;
+
+private:
+    // Nodes out of view are taken out of the grid while it updates, so ImNodeFlow doesn't draw them or their pins
+    void parkHiddenNodes();
+    void restoreParkedNodes();
+    void forgetNode(ImFlow::BaseNode* node);
+
+    // Extra grid space kept around the view, so nodes are back before their borders or links come into sight
+    static constexpr float c_viewMargin = 64.0f;
+
+    bool m_showNodeDetail = true;
+
+    NodeSpatialIndex m_nodeIndex{};
+    std::vector<size_t> m_visibleNodes{};
+    std::vector<std::pair<size_t, std::shared_ptr<ImFlow::BaseNode>>> m_parkedNodes{};
+    ImVec2 m_lastGridOrigin{};
+    float m_lastGridScale = 0.0f;
 };
 
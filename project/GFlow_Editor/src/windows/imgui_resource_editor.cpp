@@ -22,12 +22,14 @@ void ImGuiResourceEditorWindow::resourceSelected(const std::string& resource)
 
     m_selectedResource = gflow::parser::ResourceManager::getResource(resource);
     m_nestedResourcesOpened.clear();
+    m_inspectorModels.clear();
 }
 
 void ImGuiResourceEditorWindow::resourceSelected(gflow::parser::Resource* resource)
 {
     m_selectedResource = resource;
     m_nestedResourcesOpened.clear();
+    m_inspectorModels.clear();
 }
 
 void ImGuiResourceEditorWindow::draw()
@@ -35,7 +37,8 @@ void ImGuiResourceEditorWindow::draw()
     ImGui::Begin(m_name.c_str(), &open);
     if (m_selectedResource)
     {
-        drawResource(m_selectedResource->getType(), &m_selectedResource, {});
+        m_parentPath.clear();
+        drawResource(m_selectedResource->getType(), &m_selectedResource);
     }
     ImGui::End();
 }
@@ -66,7 +69,7 @@ bool ImGuiResourceEditorWindow::drawFloat(const std::string& name, void* data) c
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat(("##" + name).c_str(), &tmp, 0.1f, 1.0f);
+    ImGui::InputFloat("##value", &tmp, 0.1f, 1.0f);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -81,7 +84,7 @@ bool ImGuiResourceEditorWindow::drawInt(const std::string& name, void* data) con
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputInt(("##" + name).c_str(), &tmp, 1, 10);
+    ImGui::InputInt("##value", &tmp, 1, 10);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -98,7 +101,7 @@ bool ImGuiResourceEditorWindow::drawBigInt(const std::string& name, void* data)
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
     constexpr size_t step = 1;
     constexpr size_t step_fast = 10;
-    ImGui::InputScalar(("##" + name).c_str(), ImGuiDataType_::ImGuiDataType_U64, &tmp, &step, &step_fast);
+    ImGui::InputScalar("##value", ImGuiDataType_::ImGuiDataType_U64, &tmp, &step, &step_fast);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -107,19 +110,27 @@ bool ImGuiResourceEditorWindow::drawBigInt(const std::string& name, void* data)
 
 }
 
+// Lets ImGui edit the string in place, it is only resized when the text outgrows it
+static int resizeStringCallback(ImGuiInputTextCallbackData* data)
+{
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize)
+    {
+        std::string* str = static_cast<std::string*>(data->UserData);
+        str->resize(data->BufTextLen);
+        data->Buf = str->data();
+    }
+    return 0;
+}
+
 bool ImGuiResourceEditorWindow::drawString(const std::string& name, void* data, const bool isShort) const
 {
     std::string* str = static_cast<std::string*>(data);
-    char buff[256] = "";
-    if (!str->empty()) strcpy_s(buff, str->c_str());
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(isShort ? -80.f : LEFT_ALIGN_ITEM);
-    ImGui::InputText(("##" + name).c_str(), buff, 256);
+    const bool changed = ImGui::InputText("##value", str->data(), str->capacity() + 1, ImGuiInputTextFlags_CallbackResize, resizeStringCallback, str);
     if (!isShort) ImGui::Spacing();
     ImGui::PopItemWidth();
-    const bool changed = *str != buff;
-    str->assign(buff);
     return changed;
 }
 
@@ -130,7 +141,7 @@ bool ImGuiResourceEditorWindow::drawBool(const std::string& name, void* data) co
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::Checkbox(("##" + name).c_str(), &tmp);
+    ImGui::Checkbox("##value", &tmp);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -145,7 +156,7 @@ bool ImGuiResourceEditorWindow::drawVec2(const std::string& name, void* data) co
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat2(("##" + name).c_str(), reinterpret_cast<float*>(&tmp));
+    ImGui::InputFloat2("##value", reinterpret_cast<float*>(&tmp));
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -160,7 +171,7 @@ bool ImGuiResourceEditorWindow::drawVec3(const std::string& name, void* data) co
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat3(("##" + name).c_str(), reinterpret_cast<float*>(&tmp));
+    ImGui::InputFloat3("##value", reinterpret_cast<float*>(&tmp));
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -175,7 +186,7 @@ bool ImGuiResourceEditorWindow::drawVec4(const std::string& name, void* data) co
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat4(("##" + name).c_str(), reinterpret_cast<float*>(&tmp));
+    ImGui::InputFloat4("##value", reinterpret_cast<float*>(&tmp));
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -189,9 +200,9 @@ bool ImGuiResourceEditorWindow::drawMat3(const std::string& name, void* data) co
     gflow::parser::Mat3 tmp = *value;
     ImGui::Text(name.c_str());
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat3(("##1_" + name).c_str(), &tmp.data[0]);
-    ImGui::InputFloat3(("##2_" + name).c_str(), &tmp.data[3]);
-    ImGui::InputFloat3(("##3_" + name).c_str(), &tmp.data[6]);
+    ImGui::InputFloat3("##1", &tmp.data[0]);
+    ImGui::InputFloat3("##2", &tmp.data[3]);
+    ImGui::InputFloat3("##3", &tmp.data[6]);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -205,10 +216,10 @@ bool ImGuiResourceEditorWindow::drawMat4(const std::string& name, void* data) co
     gflow::parser::Mat4 tmp = *value;
     ImGui::Text(name.c_str());
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::InputFloat4(("##1_" + name).c_str(), &tmp.data[0]);
-    ImGui::InputFloat4(("##2_" + name).c_str(), &tmp.data[4]);
-    ImGui::InputFloat4(("##3_" + name).c_str(), &tmp.data[8]);
-    ImGui::InputFloat4(("##4_" + name).c_str(), &tmp.data[12]);
+    ImGui::InputFloat4("##1", &tmp.data[0]);
+    ImGui::InputFloat4("##2", &tmp.data[4]);
+    ImGui::InputFloat4("##3", &tmp.data[8]);
+    ImGui::InputFloat4("##4", &tmp.data[12]);
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -223,7 +234,7 @@ bool ImGuiResourceEditorWindow::drawColor(const std::string& name, void* data) c
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::ColorEdit4(("##" + name).c_str(), reinterpret_cast<float*>(&tmp));
+    ImGui::ColorEdit4("##value", reinterpret_cast<float*>(&tmp));
     ImGui::PopItemWidth();
     ImGui::Spacing();
     const bool changed = tmp != *value;
@@ -239,7 +250,7 @@ bool ImGuiResourceEditorWindow::drawUColor(const std::string& name, void* data)
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     ImGui::PushItemWidth(LEFT_ALIGN_ITEM);
-    ImGui::ColorEdit4(("##" + name).c_str(), reinterpret_cast<float*>(&ftmp));
+    ImGui::ColorEdit4("##value", reinterpret_cast<float*>(&ftmp));
     ImGui::PopItemWidth();
     ImGui::Spacing();
     tmp.fromfColor(ftmp);
@@ -253,21 +264,50 @@ bool ImGuiResourceEditorWindow::drawFile(const std::string& name, void* data) co
     gflow::parser::FilePath* str = static_cast<gflow::parser::FilePath*>(data);
     drawString(name, &str->path, true);
     ImGui::SameLine(0, 10);
-    const bool aa = ImGui::Button(("refresh##" + std::string(name)).c_str());
+    const bool aa = ImGui::Button("refresh");
     return aa;
 }
 
-void ImGuiResourceEditorWindow::drawResource(const std::string& stackedName, void* data, const std::vector<gflow::parser::Resource*>& parentPath)
+ImGuiResourceEditorWindow::InspectorModel& ImGuiResourceEditorWindow::getInspectorModel(const std::string& stackedName, gflow::parser::Resource* resource)
+{
+    InspectorModel& model = m_inspectorModels[stackedName];
+    bool upToDate = model.resource == resource && model.resourceID == resource->getID() && model.revisions.size() == m_parentPath.size() + 1;
+    for (size_t i = 0; upToDate && i < m_parentPath.size(); i++)
+        upToDate = model.revisions[i] == m_parentPath[i]->getRevision();
+    if (upToDate && model.revisions.back() == resource->getRevision())
+        return model;
+
+    model.resource = resource;
+    model.resourceID = resource->getID();
+    model.revisions.clear();
+    for (const gflow::parser::Resource* parent : m_parentPath)
+        model.revisions.push_back(parent->getRevision());
+    model.revisions.push_back(resource->getRevision());
+
+    model.fields.clear();
+    for (gflow::parser::Resource::ExportData& exportElem : resource->getExports())
+    {
+        const gflow::parser::DataUsage usage = resource->isUsed(exportElem.name, m_parentPath);
+        if (usage == gflow::parser::NOT_USED) continue;
+
+        InspectorField& field = model.fields.emplace_back(InspectorField{ std::move(exportElem), usage });
+        if (field.data.type != gflow::parser::DataType::RESOURCE) continue;
+        field.childName = stackedName + "." + field.data.name;
+        const gflow::parser::Resource* subresource = *static_cast<gflow::parser::Resource**>(field.data.data);
+        field.buttonLabel = (subresource != nullptr ? subresource->getType() : "...") + "##resource";
+    }
+    return model;
+}
+
+void ImGuiResourceEditorWindow::drawResource(const std::string& stackedName, void* data)
 {
     bool isHeaderOpen = true;
     gflow::parser::Resource** resource = static_cast<gflow::parser::Resource**>(data);
     if (*resource == nullptr) return;
     std::vector<std::string> changedExports{};
-    for (gflow::parser::Resource::ExportData& exportElem : (*resource)->getExports())
+    for (InspectorField& field : getInspectorModel(stackedName, *resource).fields)
     {
-        const gflow::parser::DataUsage usage = (*resource)->isUsed(exportElem.name, parentPath);
-        if (usage == gflow::parser::NOT_USED) continue;
-
+        gflow::parser::Resource::ExportData& exportElem = field.data;
         if (exportElem.data == nullptr)
         {
             isHeaderOpen = ImGui::CollapsingHeader(exportElem.name.data());
@@ -277,7 +317,9 @@ void ImGuiResourceEditorWindow::drawResource(const std::string& stackedName, voi
 
         if (!isHeaderOpen) continue;
         bool changed = false;
-        ImGui::BeginDisabled(usage == gflow::parser::READ_ONLY);
+        // The address of the value is unique in the window, so the widgets of every export can share their labels
+        ImGui::PushID(exportElem.data);
+        ImGui::BeginDisabled(field.usage == gflow::parser::READ_ONLY);
         switch (exportElem.type)
         {
         case gflow::parser::DataType::STRING:
@@ -326,14 +368,13 @@ void ImGuiResourceEditorWindow::drawResource(const std::string& stackedName, voi
             changed = drawBitmask(exportElem.name, exportElem.data, exportElem.enumContext);
             break;
         case gflow::parser::DataType::RESOURCE:
-            {
-                std::vector<gflow::parser::Resource*> resourcePath = parentPath;
-                resourcePath.push_back(*resource);
-                drawSubresource(exportElem.name, stackedName, exportElem, resourcePath);
-                break;
-            }
+            m_parentPath.push_back(*resource);
+            drawSubresource(field);
+            m_parentPath.pop_back();
+            break;
         }
         ImGui::EndDisabled();
+        ImGui::PopID();
 
         if (changed)
             changedExports.push_back(exportElem.name);
@@ -342,36 +383,33 @@ void ImGuiResourceEditorWindow::drawResource(const std::string& stackedName, voi
     for (const std::string& changedExport : changedExports)
     {
         m_variableChangedSignal.emit({m_selectedResource->getPath(), m_selectedResource, changedExport, stackedName});
+        (*resource)->markChanged();
         (*resource)->exportChanged(changedExport);
     }
 }
 
-void ImGuiResourceEditorWindow::drawSubresource(const std::string& name, std::string stackedName, gflow::parser::Resource::ExportData& data, const std::vector<gflow::parser::Resource*>& parentPath)
+void ImGuiResourceEditorWindow::drawSubresource(InspectorField& field)
 {
-    stackedName += "." + name;
+    const std::string& name = field.data.name;
+    const std::string& stackedName = field.childName;
+    gflow::parser::Resource::ExportData& data = field.data;
+    gflow::parser::Resource* parent = m_parentPath.back();
 
     gflow::parser::Resource** resource = static_cast<gflow::parser::Resource**>(data.data);
-    std::string subResource = "...";
-    if (*resource != nullptr)
-    {
-        subResource = (*resource)->getType();
-    }
-
-    if (!m_nestedResourcesOpened.contains(stackedName))
-        m_nestedResourcesOpened.emplace(stackedName, false);
 
+    bool& isOpened = m_nestedResourcesOpened[stackedName];
     bool childBegan = false;
-    if (m_nestedResourcesOpened[stackedName])
+    if (isOpened)
     {
-        ImGui::BeginChild((name + "##Child-" + stackedName).c_str(), ImVec2(0, 0), ImGuiChildFlags_Border | ImGuiChildFlags_AutoResizeY);
+        ImGui::BeginChild("##child", ImVec2(0, 0), ImGuiChildFlags_Border | ImGuiChildFlags_AutoResizeY);
         childBegan = true;
     }
 
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
-    if (ImGui::Button((subResource + "##" + stackedName).c_str()) && *resource != nullptr)
+    if (ImGui::Button(field.buttonLabel.c_str()) && *resource != nullptr)
     {
-        m_nestedResourcesOpened[stackedName] = !m_nestedResourcesOpened[stackedName];
+        isOpened = !isOpened;
         if (childBegan) ImGui::EndChild();
         return;
     }
@@ -384,17 +422,18 @@ void ImGuiResourceEditorWindow::drawSubresource(const std::string& name, std::st
             if (ImGui::MenuItem("Create embedded"))
             {
                 *resource = gflow::parser::ResourceManager::createResource("", data.resourceFactory, &data);
-                m_nestedResourcesOpened[stackedName] = true;
+                parent->markChanged();
+                isOpened = true;
                 shouldReturn = true;
-                m_variableChangedSignal.emit({m_selectedResource->getPath(), parentPath.back(), name, stackedName});
+                m_variableChangedSignal.emit({m_selectedResource->getPath(), parent, name, stackedName});
             }
         }
         
         ImGui::BeginDisabled(gflow::parser::ResourceManager::isTypeSubresource(data.getType()));
         if (ImGui::MenuItem("Load"))
         {
-            m_variablesFlaggedToChange.emplace_back(m_selectedResource->getPath(), parentPath.back(), name, stackedName);
-            Editor::showResourcePickerModal(this, parentPath.back(), name, data.getType());
+            m_variablesFlaggedToChange.emplace_back(m_selectedResource->getPath(), parent, name, stackedName);
+            Editor::showResourcePickerModal(this, parent, name, data.getType());
         }
         ImGui::EndDisabled();
         if (ImGui::MenuItem("Clear"))
@@ -404,8 +443,9 @@ void ImGuiResourceEditorWindow::drawSubresource(const std::string& name, std::st
                 gflow::parser::ResourceManager::deleteResource(*resource);
             }
             *resource = nullptr;
-            m_variableChangedSignal.emit({ m_selectedResource->getPath(), parentPath.back(), name, stackedName });
-            m_nestedResourcesOpened[stackedName] = false;
+            parent->markChanged();
+            m_variableChangedSignal.emit({ m_selectedResource->getPath(), parent, name, stackedName });
+            isOpened = false;
             shouldReturn = true;
         }
         ImGui::EndPopup();
@@ -416,10 +456,10 @@ void ImGuiResourceEditorWindow::drawSubresource(const std::string& name, std::st
         }
     }
 
-    if (m_nestedResourcesOpened[stackedName])
+    if (isOpened)
     {
         ImGui::Separator();
-        drawResource(stackedName, data.data, parentPath);
+        drawResource(stackedName, data.data);
         ImGui::EndChild();
     }
     ImGui::Spacing();
@@ -430,7 +470,7 @@ bool ImGuiResourceEditorWindow::drawEnum(const std::string& name, void* data, co
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     uint32_t currentSelection = *static_cast<uint32_t*>(data);
-    if (ImGui::BeginCombo(("##" + name).c_str(), context->names[currentSelection], 0))
+    if (ImGui::BeginCombo("##value", context->names[currentSelection], 0))
     {
         for (uint32_t n = 0; n < context->names.size(); n++)
         {
@@ -454,7 +494,7 @@ bool ImGuiResourceEditorWindow::drawBitmask(const std::string& name, void* data,
     ImGui::Text(name.c_str());
     ImGui::SameLine(m_inlinePadding);
     uint32_t currentMask = *static_cast<uint32_t*>(data);
-    if (ImGui::BeginCombo(("##" + name).c_str(), "Bitmask...", 0))
+    if (ImGui::BeginCombo("##value", "Bitmask...", 0))
     {
         for (uint32_t n = 0; n < context->names.size(); n++)
         {
@@ -35,8 +35,29 @@ private:
     bool drawMat4(const std::string& name, void* data) const;
     bool drawColor(const std::string& name, void* data) const;
     bool drawUColor(const std::string& name, void* data) const;
-    void drawResource(const std::string& stackedName, void* data, const std::vector<gflow::parser::Resource*>& parentPath);
-    void drawSubresource(const std::string& name, std::string stackedName, gflow::parser::Resource::ExportData& data, const std::vector<gflow::parser::Resource*>& parentPath);
+    // An export that is drawn, with what can be worked out from it ahead of time
+    struct InspectorField
+    {
+        gflow::parser::Resource::ExportData data;
+        gflow::parser::DataUsage usage;
+        // Only for subresources
+        std::string childName{};
+        std::string buttonLabel{};
+    };
+
+    // What drawResource shows of a resource, built again only when the resource or one of its parents changes
+    struct InspectorModel
+    {
+        gflow::parser::Resource* resource = nullptr;
+        uint32_t resourceID = 0;
+        // Revisions of the parents followed by the one of the resource
+        std::vector<uint32_t> revisions{};
+        std::vector<InspectorField> fields{};
+    };
+
+    InspectorModel& getInspectorModel(const std::string& stackedName, gflow::parser::Resource* resource);
+    void drawResource(const std::string& stackedName, void* data);
+    void drawSubresource(InspectorField& field);
     bool drawEnum(const std::string& name, void* data, const gflow::parser::EnumContext* context) const;
     bool drawBitmask(const std::string& name, void* data, const gflow::parser::EnumContext* context) const;
     bool drawFile(const std::string& name, void* data) const;
@@ -45,6 +66,9 @@ private:
     gflow::parser::Resource* m_selectedResource = nullptr;
 
     mutable std::unordered_map<std::string, bool> m_nestedResourcesOpened;
+    std::unordered_map<std::string, InspectorModel> m_inspectorModels;
+    // Resources above the one being drawn
+    std::vector<gflow::parser::Resource*> m_parentPath;
 
     std::vector<gflow::parser::ResourceElemPath> m_variablesFlaggedToChange;
 
@@ -12,12 +12,12 @@ ImGuiResourcesWindow::ImGuiResourcesWindow(const std::string& name, const bool d
 {
 }
 
-void ImGuiResourcesWindow::pushFolder(std::vector<std::pair<std::string, bool>>& folderStack, const std::string& path, const std::string& folderName) const
+void ImGuiResourcesWindow::pushFolder(FolderStack& folderStack, const std::string& path, const char* folderName) const
 {
-    folderStack.emplace_back(path, addTreeNode(folderName, path));
+    folderStack.emplace_back(&path, addTreeNode(folderName, path));
 }
 
-void ImGuiResourcesWindow::popFolder(std::vector<std::pair<std::string, bool>>& folderStack) const
+void ImGuiResourcesWindow::popFolder(FolderStack& folderStack) const
 {
     if (folderStack.back().second)
     {
@@ -26,12 +26,12 @@ void ImGuiResourcesWindow::popFolder(std::vector<std::pair<std::string, bool>>&
     folderStack.pop_back();
 }
 
-bool ImGuiResourcesWindow::addTreeNode(const std::string& name, const std::string& path) const
+bool ImGuiResourcesWindow::addTreeNode(const char* name, const std::string& path) const
 {
-    const bool opened = ImGui::TreeNode(name.c_str());
+    const bool opened = ImGui::TreeNode(name);
     if (ImGui::BeginPopupContextItem())
     {
-        ImGui::Text(("Make changes to " + name).c_str());
+        ImGui::Text("Make changes to %s", name);
         ImGui::SeparatorEx(ImGuiSeparatorFlags_Horizontal, 3.0f);
         ImGui::BeginDisabled(path.empty());
         if (ImGui::MenuItem(IMGUI_NAME("Delete")))
@@ -57,12 +57,12 @@ bool ImGuiResourcesWindow::addTreeNode(const std::string& name, const std::strin
     return opened;
 }
 
-bool ImGuiResourcesWindow::addSelectable(const std::string& name, const bool selected) const
+bool ImGuiResourcesWindow::addSelectable(const Entry& entry, const bool selected) const
 {
-    const bool ret = ImGui::Selectable(IMGUI_NAME(name), selected);
+    const bool ret = ImGui::Selectable(entry.label.c_str(), selected);
     if (ImGui::BeginPopupContextItem())
     {
-        ImGui::Text(("Make changes to " + name).c_str());
+        ImGui::Text("Make changes to %s", entry.name.c_str());
         ImGui::SeparatorEx(ImGuiSeparatorFlags_Horizontal, 3.0f);
         if (ImGui::MenuItem(IMGUI_NAME("Delete")))
         {
@@ -88,8 +88,6 @@ void ImGuiResourcesWindow::drawContent()
 {
     if (!gflow::parser::ResourceManager::hasProject()) return;
 
-    std::vector<std::pair<std::string, bool>> folderStack;
-
     if (ImGui::Button(IMGUI_NAME("Refresh")))
         gflow::parser::ResourceManager::resetWorkingDir(gflow::parser::ResourceManager::getWorkingDir());
 
@@ -97,59 +95,61 @@ void ImGuiResourcesWindow::drawContent()
 
     if (!addTreeNode(IMGUI_NAME("root"), "")) return;
 
-    const std::vector<std::string> orderedPaths = gflow::parser::ResourceManager::getTree().getOrderedPaths();
-    for (const std::string& path : orderedPaths)
+    updateEntries();
+    FolderStack folderStack;
+    for (const Entry& entry : m_entries)
     {
-        std::string name = gflow::string::getPathFilename(path);
-        
-        // Check if it is hidden
-        {
-            if (name[0] == '_') continue;
-            std::vector<std::string> pathParts = gflow::string::split(path, "/");
-            bool isHidden = false;
-            for (const std::string& part : pathParts)
-            {
-                if (part[0] == '_')
-                {
-                    isHidden = true;
-                    break;
-                }
-            }
-            if (isHidden) continue;
-        }
-
-        if (!folderStack.empty() && path == folderStack.back().first)
+        if (!folderStack.empty() && entry.path == *folderStack.back().first)
         {
             popFolder(folderStack);
             continue;
         }
 
-        std::string parentDir = gflow::string::getPathDirectory(path);
-        if (!parentDir.empty() && !folderStack.back().second) 
+        if (entry.hasParent && !folderStack.back().second) 
             continue;
 
-        if (path.back() == '/')
+        if (entry.isFolder)
         {
-            pushFolder(folderStack, path, name);
+            pushFolder(folderStack, entry.path, entry.name.c_str());
             continue;
         }
 
-        if (gflow::parser::ResourceManager::hasResource(path) 
-            && (m_typeFilter.empty() || gflow::parser::ResourceManager::getResourceType(path) == m_typeFilter)
-            && gflow::parser::ResourceManager::isResourcePublic(path))
+        if (addSelectable(entry, entry.path == m_selectedResource) && entry.path != m_selectedResource)
         {
-            if (addSelectable(name, path == m_selectedResource) && path != m_selectedResource)
-            {
-                m_selectedResource = path;
-                m_resourceSelectedSignal.emit(m_selectedResource);
-            }
+            m_selectedResource = entry.path;
+            m_resourceSelectedSignal.emit(m_selectedResource);
         }
     }
     ImGui::TreePop();
 }
 
+void ImGuiResourcesWindow::updateEntries()
+{
+    const gflow::parser::FileTree& tree = gflow::parser::ResourceManager::getTree();
+    if (m_entriesRevision == tree.getRevision()) return;
+    m_entriesRevision = tree.getRevision();
+
+    m_entries.clear();
+    for (const std::string& path : tree.getOrderedPaths())
+    {
+        // Anything inside a folder starting with '_' is hidden too
+        if (path[0] == '_' || path.find("/_") != std::string::npos) continue;
+
+        const bool isFolder = path.back() == '/';
+        if (!isFolder && !(gflow::parser::ResourceManager::hasResource(path)
+            && (m_typeFilter.empty() || gflow::parser::ResourceManager::getResourceType(path) == m_typeFilter)
+            && gflow::parser::ResourceManager::isResourcePublic(path)))
+            continue;
+
+        std::string name = gflow::string::getPathFilename(path);
+        std::string label = name + "##" + m_name;
+        m_entries.push_back({ path, std::move(name), std::move(label), isFolder, !gflow::string::getPathDirectory(path).empty() });
+    }
+}
+
 void ImGuiResourcesWindow::projectLoaded()
 {
+    m_entriesRevision = UINT32_MAX;
     m_selectedResource = "";
     m_resourceSelectedSignal.emit(m_selectedResource);
 }
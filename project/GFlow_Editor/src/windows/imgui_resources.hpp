@@ -15,7 +15,7 @@ class ImGuiResourcesWindow final : public ImGuiEditorWindow
 public:
     explicit ImGuiResourcesWindow(const std::string& name, const bool defaultOpen = true);
 
-    void setFilter(const std::string& filter) { m_typeFilter = filter; }
+    void setFilter(const std::string& filter) { m_typeFilter = filter; m_entriesRevision = UINT32_MAX; }
 
     void draw() override;
     void drawContent();
@@ -25,15 +25,33 @@ public:
     [[nodiscard]] Signal<const std::string&>& getResourceSelectedSignal() { return m_resourceSelectedSignal; }
 
 private:
-    void pushFolder(std::vector<std::pair<std::string, bool>>& folderStack, const std::string& path, const std::string& folderName) const;
-    void popFolder(std::vector<std::pair<std::string, bool>>& folderStack) const;
+    // A visible folder or resource of the file tree. Folders come in twice, when they open and when they close
+    struct Entry
+    {
+        std::string path;
+        std::string name;
+        std::string label;
+        bool isFolder;
+        bool hasParent;
+    };
 
-    [[nodiscard]] bool addTreeNode(const std::string& name, const std::string& path) const;
-    [[nodiscard]] bool addSelectable(const std::string& name, bool selected) const;
+    using FolderStack = FrameArena::Vector<std::pair<const std::string*, bool>>;
+
+    void pushFolder(FolderStack& folderStack, const std::string& path, const char* folderName) const;
+    void popFolder(FolderStack& folderStack) const;
+
+    [[nodiscard]] bool addTreeNode(const char* name, const std::string& path) const;
+    [[nodiscard]] bool addSelectable(const Entry& entry, bool selected) const;
+
+    // Walks the file tree again, only when it changed or the filter did
+    void updateEntries();
 
     std::string m_typeFilter;
     std::string m_selectedResource;
 
+    std::vector<Entry> m_entries;
+    uint32_t m_entriesRevision = UINT32_MAX;
+
     Signal<const std::string&> m_resourceSelectedSignal;
 };
 
@@ -0,0 +1,90 @@
+#include "node_spatial_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void NodeSpatialIndex::update(const size_t node, const ImVec2& min, const ImVec2& max)
+{
+    const auto it = m_rects.find(node);
+    if (it != m_rects.end())
+    {
+        Rect& rect = it->second;
+        if (rect.min.x == min.x && rect.min.y == min.y && rect.max.x == max.x && rect.max.y == max.y)
+            return;
+        // Most moves stay within the same cells, only the stored rectangle changes then
+        if (getCells(rect.min, rect.max) == getCells(min, max))
+        {
+            rect = { min, max };
+            return;
+        }
+        remove(node);
+    }
+
+    m_rects[node] = { min, max };
+    const CellRange cells = getCells(min, max);
+    for (int32_t y = cells.minY; y <= cells.maxY; ++y)
+        for (int32_t x = cells.minX; x <= cells.maxX; ++x)
+            m_cells[getCellKey(x, y)].push_back(node);
+}
+
+void NodeSpatialIndex::remove(const size_t node)
+{
+    const auto it = m_rects.find(node);
+    if (it == m_rects.end()) return;
+
+    const CellRange cells = getCells(it->second.min, it->second.max);
+    for (int32_t y = cells.minY; y <= cells.maxY; ++y)
+    {
+        for (int32_t x = cells.minX; x <= cells.maxX; ++x)
+        {
+            const auto cell = m_cells.find(getCellKey(x, y));
+            if (cell == m_cells.end()) continue;
+            std::erase(cell->second, node);
+            if (cell->second.empty())
+                m_cells.erase(cell);
+        }
+    }
+    m_rects.erase(it);
+}
+
+void NodeSpatialIndex::clear()
+{
+    m_rects.clear();
+    m_cells.clear();
+}
+
+void NodeSpatialIndex::query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& result) const
+{
+    result.clear();
+    const CellRange cells = getCells(min, max);
+    for (int32_t y = cells.minY; y <= cells.maxY; ++y)
+    {
+        for (int32_t x = cells.minX; x <= cells.maxX; ++x)
+        {
+            const auto cell = m_cells.find(getCellKey(x, y));
+            if (cell == m_cells.end()) continue;
+            for (const size_t node : cell->second)
+            {
+                const Rect& rect = m_rects.at(node);
+                if (rect.min.x <= max.x && min.x <= rect.max.x && rect.min.y <= max.y && min.y <= rect.max.y)
+                    result.push_back(node);
+            }
+        }
+    }
+    // Nodes spanning several cells are found once per cell
+    std::ranges::sort(result);
+    result.erase(std::ranges::unique(result).begin(), result.end());
+}
+
+NodeSpatialIndex::CellRange NodeSpatialIndex::getCells(const ImVec2& min, const ImVec2& max)
+{
+    return {
+        static_cast<int32_t>(std::floor(min.x / c_cellSize)), static_cast<int32_t>(std::floor(min.y / c_cellSize)),
+        static_cast<int32_t>(std::floor(max.x / c_cellSize)), static_cast<int32_t>(std::floor(max.y / c_cellSize))
+    };
+}
+
+uint64_t NodeSpatialIndex::getCellKey(const int32_t x, const int32_t y)
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "imgui.h"
+
+// Uniform grid over the node rectangles of a graph, in grid coordinates. A node only touches the cells it covers when
+// its rectangle changes, so finding what is in view doesn't go through every node
+class NodeSpatialIndex
+{
+public:
+    // Inserts the node or moves it if its rectangle changed
+    void update(size_t node, const ImVec2& min, const ImVec2& max);
+    void remove(size_t node);
+    void clear();
+
+    // Nodes whose rectangle overlaps the area, each one once and in no particular order
+    void query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& result) const;
+    [[nodiscard]] bool contains(const size_t node) const { return m_rects.contains(node); }
+
+    static constexpr float c_cellSize = 512.0f;
+
+private:
+    struct Rect
+    {
+        ImVec2 min{};
+        ImVec2 max{};
+    };
+
+    struct CellRange
+    {
+        int32_t minX = 0, minY = 0, maxX = -1, maxY = -1;
+
+        [[nodiscard]] bool operator==(const CellRange& other) const = default;
+    };
+
+    [[nodiscard]] static CellRange getCells(const ImVec2& min, const ImVec2& max);
+    [[nodiscard]] static uint64_t getCellKey(int32_t x, int32_t y);
+
+    std::unordered_map<size_t, Rect> m_rects{};
+    std::unordered_map<uint64_t, std::vector<size_t>> m_cells{};
+};
@@ -1,5 +1,9 @@
 #include "base_node.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "node_registry.hpp"
 #include "metaresources/graph.hpp"
 #include "windows/imgui_graph_window.hpp"
 
@@ -25,6 +29,56 @@ void GFlowNode::setInspectionStatus(const bool status)
     m_inspectionStatusChanged.emit(status);
 }
 
+void GFlowNode::draw()
+{
+    updateContent();
+
+    // Contents out of view or too small to read are replaced by a space of the same size, so the node keeps its
+    // shape and its pins stay where they were
+    if (!m_parent->showsNodeDetail() || !ImGui::IsRectVisible(m_contentSize))
+    {
+        ImGui::Dummy(m_contentSize);
+        return;
+    }
+
+    static const ImVec4 c_colors[] = { ImVec4(0.6f, 0.8f, 1.0f, 1.0f), ImVec4(1.0f, 0.8f, 0.3f, 1.0f), ImVec4(1.0f, 0.35f, 0.35f, 1.0f) };
+    ImGui::BeginGroup();
+    for (const NodeDiagnostic& diagnostic : m_diagnostics)
+        ImGui::TextColored(c_colors[diagnostic.severity], "%s", diagnostic.message.c_str());
+    drawContent();
+    ImGui::EndGroup();
+    m_contentSize = ImGui::GetItemRectSize();
+}
+
+static const NodeRegistry::Entry& getRegistryEntry(const NodeResource* resource)
+{
+    const NodeRegistry::Entry* entry = NodeRegistry::find(resource->getType());
+    if (entry == nullptr)
+        throw std::runtime_error("Node type " + resource->getType() + " is not registered");
+    return *entry;
+}
+
+std::shared_ptr<ImFlow::InPin<int>> GFlowNode::addRegisteredIN(const size_t index, const std::shared_ptr<ImFlow::PinStyle>& style)
+{
+    const NodePinInfo& info = getRegistryEntry(getLinkedResource()).inputs.at(index);
+    const std::vector<PinType> accepts = info.accepts;
+    const std::shared_ptr<ImFlow::InPin<int>> pin = addIN(info.name, 0, [accepts](const ImFlow::Pin* pin1, const ImFlow::Pin*) -> bool
+    {
+        return std::ranges::find(accepts, pin1->getFilterID()) != accepts.end();
+    }, style);
+    pin->setFilterID(info.filterID);
+    return pin;
+}
+
+std::shared_ptr<ImFlow::OutPin<int>> GFlowNode::addRegisteredOUT(const size_t index, const std::shared_ptr<ImFlow::PinStyle>& style)
+{
+    const NodePinInfo& info = getRegistryEntry(getLinkedResource()).outputs.at(index);
+    const std::shared_ptr<ImFlow::OutPin<int>> pin = addOUT<int>(info.name, style);
+    pin->behaviour([]() -> int { return 0; }); //Not used, but needed to prevent segfault
+    pin->setFilterID(info.filterID);
+    return pin;
+}
+
 void GFlowNode::destroy()
 {
     BaseNode::destroy();
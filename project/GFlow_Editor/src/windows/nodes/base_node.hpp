@@ -24,6 +24,20 @@ enum PinType : uint8_t
     EXTERNAL_ARGUMENT,
 };
 
+// Problem or hint about a node found by the graph analysis
+struct NodeDiagnostic
+{
+    enum Severity : uint8_t
+    {
+        INFO,
+        WARN,
+        ERR,
+    };
+
+    Severity severity = INFO;
+    std::string message{};
+};
+
 class GFlowNode : public ImFlow::BaseNode
 {
 public:
@@ -33,15 +47,32 @@ public:
     void setInspectionStatus(bool status);
 
     void destroy() override;
+    // Updates the node and draws the diagnostics above its contents, the drawing is skipped when the node is out of
+    // view or the graph is zoomed out
+    void draw() final;
+
+    void setDiagnostics(std::vector<NodeDiagnostic> diagnostics) { m_diagnostics = std::move(diagnostics); }
+    void clearDiagnostics() { m_diagnostics.clear(); }
 
     virtual void onResourceUpdated(const gflow::parser::ResourceElemPath&) {}
     [[nodiscard]] Signal<GFlowNode*>& getDestroyedSignal() { return m_destroyed; }
 
 protected:
+    // Runs every frame, also while the contents are not drawn
+    virtual void updateContent() {}
+    virtual void drawContent() {}
+
+    // Fixed pins of the node type in the order NodeRegistry lists them, the linked resource has to be set already
+    std::shared_ptr<ImFlow::InPin<int>> addRegisteredIN(size_t index, const std::shared_ptr<ImFlow::PinStyle>& style);
+    std::shared_ptr<ImFlow::OutPin<int>> addRegisteredOUT(size_t index, const std::shared_ptr<ImFlow::PinStyle>& style);
+
     Signal<bool> m_inspectionStatusChanged;
 
 private:
     ImGuiGraphWindow* m_parent = nullptr;
+    std::vector<NodeDiagnostic> m_diagnostics{};
+    // As of the last frame the contents were drawn
+    ImVec2 m_contentSize{};
     Signal<GFlowNode*> m_destroyed;
 };
 
@@ -1,12 +1,25 @@
 ﻿#include "execution_nodes.hpp"
 
+#include "editor.hpp"
+
+static void drawGPUTiming(const GPUScope& scope, const bool statistics)
+{
+    if (scope.renderpass == gflow::GPUProfiler::c_none) return;
+    // Nothing is shown until the scope has been profiled at least once
+    const gflow::GPUProfiler::Sample* sample = Editor::getGPUSample(scope.renderpass, scope.subpass, scope.drawCall);
+    if (sample == nullptr) return;
+    ImGui::Text("GPU: %.3f ms", sample->gpuMs);
+    if (!statistics || !sample->hasStatistics) return;
+    ImGui::Text("Vertices: %llu", static_cast<unsigned long long>(sample->statistics.vertexShaderInvocations));
+    ImGui::Text("Primitives: %llu / %llu clipped", static_cast<unsigned long long>(sample->statistics.inputAssemblyPrimitives), static_cast<unsigned long long>(sample->statistics.clippingPrimitives));
+    ImGui::Text("Fragments: %llu", static_cast<unsigned long long>(sample->statistics.fragmentShaderInvocations));
+}
+
 InitExecutionNode::InitExecutionNode(ImGuiGraphWindow* parent, NodeResource* resource)
  : GFlowNode("Init", parent), m_resource(dynamic_cast<InitNodeResource*>(resource))
 {
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(106,174,204,255), ImColor(233,241,244,255), 3.5f));
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(INIT);
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 }
 
 GFlowNode* InitExecutionNode::getNext() const
@@ -20,11 +33,8 @@ BeginExecutionNode::BeginExecutionNode(ImGuiGraphWindow* parent, NodeResource* r
  : GFlowNode("Begin", parent), m_resource(dynamic_cast<BeginExecutionNodeResource*>(resource))
 {
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(255,113,41,255), ImColor(233,241,244,255), 3.5f));
-    m_in = addIN("-->", 0, getLambdaFilter(INIT, END), ImFlow::PinStyle::white());
-    m_in->setFilterID(BEGIN);
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(BEGIN);
+    m_in = addRegisteredIN(0, ImFlow::PinStyle::white());
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 
     for (const std::string& attachment : m_resource->getAttachments())
         addAttachmentPin(attachment, false);
@@ -69,15 +79,17 @@ std::unordered_set<std::string> BeginExecutionNode::getAttachments() const
     return pins;
 }
 
+void BeginExecutionNode::drawContent()
+{
+    drawGPUTiming(m_gpuScope, false);
+}
+
 NextExecutionNode::NextExecutionNode(ImGuiGraphWindow* parent, NodeResource* resource)
  : GFlowNode("Next", parent), m_resource(dynamic_cast<NextExecutionNodeResource*>(resource))
 {
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(181,60,0,255), ImColor(233,241,244,255), 3.5f));
-    m_in = addIN("-->", 0, getLambdaFilter(NEXT, BEGIN, BIND_PUSH_CONSTANT, DRAW_CALL), ImFlow::PinStyle::white());
-    m_in->setFilterID(NEXT);
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(NEXT);
+    m_in = addRegisteredIN(0, ImFlow::PinStyle::white());
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 }
 
 GFlowNode* NextExecutionNode::getNext() const
@@ -91,11 +103,8 @@ EndExecutionNode::EndExecutionNode(ImGuiGraphWindow* parent, NodeResource* resou
  : GFlowNode("End", parent), m_resource(dynamic_cast<EndExecutionNodeResource*>(resource))
 {
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(107, 36, 0, 255), ImColor(233,241,244,255), 3.5f));
-    m_in = addIN("-->", 0, getLambdaFilter(NEXT, BEGIN, BIND_PUSH_CONSTANT, DRAW_CALL), ImFlow::PinStyle::white());
-    m_in->setFilterID(END);
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(END);
+    m_in = addRegisteredIN(0, ImFlow::PinStyle::white());
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 }
 
 GFlowNode* EndExecutionNode::getNext() const
@@ -110,16 +119,12 @@ BindPushConstantNode::BindPushConstantNode(ImGuiGraphWindow* parent, NodeResourc
 {
     m_resource = dynamic_cast<BindPushConstantNodeResource*>(resource);
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(0,135,166,255), ImColor(233,241,244,255), 3.5f));
-    m_in = addIN("-->", 0, getLambdaFilter(NEXT, BEGIN, DRAW_CALL), ImFlow::PinStyle::white());
-    m_in->setFilterID(BIND_PUSH_CONSTANT);
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(BIND_PUSH_CONSTANT);
+    m_in = addRegisteredIN(0, ImFlow::PinStyle::white());
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(0,135,166,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
 
-    m_pushConstantData = addIN("Data", 0, getLambdaFilter(PUSH_CONSTANT, EXTERNAL_ARGUMENT), pinColor);
-    m_pushConstantData->setFilterID(PUSH_CONSTANT);
+    m_pushConstantData = addRegisteredIN(1, pinColor);
 
     const std::string currentID = getLinkedResource()->getValue<std::string>("structID");
     setTitle("Bind Data" + (currentID.empty() ? "" : " (" + currentID + ")"));
@@ -139,16 +144,30 @@ void BindPushConstantNode::onResourceUpdated(const gflow::parser::ResourceElemPa
     setTitle("Bind Data" + (newID.empty() ? "" : " (" + newID + ")"));
 }
 
+void BindPushConstantNode::drawContent()
+{
+    if (m_layoutSize == 0) return;
+    ImGui::Text("%u bytes", m_layoutSize);
+    for (const std::string& error : m_layoutErrors)
+        ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), "%s", error.c_str());
+}
+
+void BindPushConstantNode::setLayout(const gflow::parser::PushConstantLayout* layout)
+{
+    m_layoutErrors.clear();
+    m_layoutSize = layout != nullptr ? layout->getSize() : 0;
+    // The editor doesn't know which device the project ends up on, only the guaranteed limit is safe
+    if (layout != nullptr)
+        m_layoutErrors = layout->validate(gflow::parser::PushConstantLayout::c_guaranteedMaxSize).errors;
+}
+
 DrawCallNode::DrawCallNode(ImGuiGraphWindow* parent, NodeResource* resource)
  : GFlowNode("Draw Call", parent)
 {
     m_resource = dynamic_cast<DrawCallNodeResource*>(resource);
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(109,0,181,255), ImColor(233,241,244,255), 3.5f));
-    m_in = addIN("-->", 0, getLambdaFilter(NEXT, BEGIN, BIND_PUSH_CONSTANT), ImFlow::PinStyle::white());
-    m_in->setFilterID(DRAW_CALL);
-    m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(DRAW_CALL);
+    m_in = addRegisteredIN(0, ImFlow::PinStyle::white());
+    m_out = addRegisteredOUT(0, ImFlow::PinStyle::white());
 
     if (m_resource->hasModelPin())
         setModelPin(true, true);
@@ -161,6 +180,11 @@ GFlowNode* DrawCallNode::getNext() const
     return dynamic_cast<GFlowNode*>(link.lock()->right()->getParent());
 }
 
+void DrawCallNode::drawContent()
+{
+    drawGPUTiming(m_gpuScope, true);
+}
+
 void DrawCallNode::setModelPin(const bool enabled, const bool force)
 {
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(90,117,191,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
@@ -186,9 +210,7 @@ ImageNode::ImageNode(ImGuiGraphWindow* parent, NodeResource* resource)
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(99,156,0,255), ImColor(233,241,244,255), 3.5f));
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(145,255,150,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("-->", pinColor);
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(IMAGE);
+    m_out = addRegisteredOUT(0, pinColor);
 
     if (getLinkedResource()->getValue<gflow::parser::EnumExport>("type").id == gflow::parser::EnumContexts::ExecutionImageType["Screen"])
     {
@@ -220,9 +242,29 @@ ModelNode::ModelNode(ImGuiGraphWindow* parent, NodeResource* resource)
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(90,117,191,255), ImColor(233,241,244,255), 3.5f));
     
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(90,117,191,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("-->", pinColor);
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(MODEL);
+    m_out = addRegisteredOUT(0, pinColor);
+
+    m_resource->cookAsync();
+}
+
+void ModelNode::onResourceUpdated(const gflow::parser::ResourceElemPath& element)
+{
+    // Edits inside the lists come from the list itself, they are only recognizable by their stacked path
+    if (element.element == "path" || element.element == "fields" || element.element == "lodErrors"
+        || element.stackedPath.find(".fields") != std::string::npos || element.stackedPath.find(".lodErrors") != std::string::npos)
+        m_resource->cookAsync();
+}
+
+void ModelNode::updateContent()
+{
+    // Finished cooks are picked up even while the node is culled
+    m_cookProgress = m_resource->pollCook();
+}
+
+void ModelNode::drawContent()
+{
+    if (m_cookProgress.has_value())
+        ImGui::ProgressBar(*m_cookProgress, ImVec2(120.0f, 0.0f), "Cooking...");
 }
 
 DataDecomposeNode::DataDecomposeNode(ImGuiGraphWindow* parent, NodeResource* resource)
@@ -232,9 +274,7 @@ DataDecomposeNode::DataDecomposeNode(ImGuiGraphWindow* parent, NodeResource* res
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(26,102,120,255), ImColor(233,241,244,255), 3.5f));
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(0,135,166,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("-->", pinColor);
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(PUSH_CONSTANT);
+    m_out = addRegisteredOUT(0, pinColor);
 
     for (const std::string& attachment : m_resource->getComponents())
         addComponentPin(attachment, false);
@@ -277,9 +317,7 @@ ExternalArgumentNode::ExternalArgumentNode(ImGuiGraphWindow* parent, NodeResourc
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(19,69,82,255), ImColor(233,241,244,255), 3.5f));
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(26,102,120,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("-->", pinColor);
-    m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-    m_out->setFilterID(EXTERNAL_ARGUMENT);
+    m_out = addRegisteredOUT(0, pinColor);
 
     const std::string currentID = getLinkedResource()->getValue<std::string>("name");
     setTitle("Extern" + (currentID.empty() ? "" : " (" + currentID + ")"));
@@ -297,8 +335,7 @@ CameraFlightNode::CameraFlightNode(ImGuiGraphWindow* parent, NodeResource* resou
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(49,125,143,255), ImColor(233,241,244,255), 3.5f));
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(26,102,120,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("VP Matrix", pinColor);
-    m_out->setFilterID(PRIMITIVE);
+    m_out = addRegisteredOUT(0, pinColor);
 }
 
 CameraObjectNode::CameraObjectNode(ImGuiGraphWindow* parent, NodeResource* resource) : GFlowNode("Camera Object", parent)
@@ -307,8 +344,7 @@ CameraObjectNode::CameraObjectNode(ImGuiGraphWindow* parent, NodeResource* resou
     setStyle(std::make_shared<ImFlow::NodeStyle>(IM_COL32(49,125,143,255), ImColor(233,241,244,255), 3.5f));
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(26,102,120,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_out = addOUT<int>("VP Matrix", pinColor);
-    m_out->setFilterID(PRIMITIVE);
+    m_out = addRegisteredOUT(0, pinColor);
 }
 
 WatcherNode::WatcherNode(ImGuiGraphWindow* parent, NodeResource* resource) : GFlowNode("Watcher", parent)
@@ -319,7 +355,7 @@ WatcherNode::WatcherNode(ImGuiGraphWindow* parent, NodeResource* resource) : GFl
     m_out = addOUT<int>("-->", ImFlow::PinStyle::white());
 
     static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(145,255,150,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-    m_Image = addIN("Image", 0, getLambdaFilter(IMAGE), pinColor);
+    m_Image = addRegisteredIN(0, pinColor);
 }
 
 GFlowNode* WatcherNode::getNext() const
@@ -328,3 +364,8 @@ GFlowNode* WatcherNode::getNext() const
     if (link.expired()) return nullptr;
     return dynamic_cast<GFlowNode*>(link.lock()->right()->getParent());
 }
+
+void WatcherNode::drawContent()
+{
+    drawGPUTiming(m_gpuScope, true);
+}
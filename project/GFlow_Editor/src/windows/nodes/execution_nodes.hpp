@@ -1,8 +1,17 @@
 ﻿#pragma once
 
+#include "gpu_profiler.hpp"
 #include "metaresources/execution.hpp"
 #include "windows/nodes/base_node.hpp"
 
+// Where a node ends up in the built project, used to find its GPU timings
+struct GPUScope
+{
+    uint32_t renderpass = gflow::GPUProfiler::c_none;
+    uint32_t subpass = gflow::GPUProfiler::c_none;
+    uint32_t drawCall = gflow::GPUProfiler::c_none;
+};
+
 class InitExecutionNode final : public GFlowNode
 {
 public:
@@ -35,8 +44,12 @@ public:
     
     [[nodiscard]] std::unordered_set<std::string> getAttachments() const;
 
+    void drawContent() override;
+    void setGPUScope(const GPUScope& scope) { m_gpuScope = scope; }
+
 private:
     BeginExecutionNodeResource* m_resource = nullptr;
+    GPUScope m_gpuScope{};
     
     std::shared_ptr<ImFlow::InPin<int>> m_in;
     std::shared_ptr<ImFlow::OutPin<int>> m_out;
@@ -82,11 +95,16 @@ public:
     NodeResource* getLinkedResource() override { return m_resource; }
     [[nodiscard]] GFlowNode* getNext() const;
     void onResourceUpdated(const gflow::parser::ResourceElemPath& element) override;
+    void drawContent() override;
 
     std::shared_ptr<ImFlow::InPin<int>> getPushConstantDataPin() const { return m_pushConstantData; }
+    // Shown under the pins, a null layout hides it. Only the size and errors are kept, there are no values to pack
+    void setLayout(const gflow::parser::PushConstantLayout* layout);
 
 private:
     BindPushConstantNodeResource* m_resource = nullptr;
+    uint32_t m_layoutSize = 0;
+    std::vector<std::string> m_layoutErrors{};
 
     std::shared_ptr<ImFlow::InPin<int>> m_in;
     std::shared_ptr<ImFlow::OutPin<int>> m_out;
@@ -104,8 +122,12 @@ public:
 
     void setModelPin(bool enabled, bool force);
 
+    void drawContent() override;
+    void setGPUScope(const GPUScope& scope) { m_gpuScope = scope; }
+
 private:
     DrawCallNodeResource* m_resource = nullptr;
+    GPUScope m_gpuScope{};
 
     std::shared_ptr<ImFlow::InPin<int>> m_in;
     std::shared_ptr<ImFlow::OutPin<int>> m_out;
@@ -129,9 +151,14 @@ class ModelNode final : public GFlowNode
 public:
     explicit ModelNode(ImGuiGraphWindow* parent, NodeResource* resource);
     NodeResource* getLinkedResource() override { return m_resource; }
+    void onResourceUpdated(const gflow::parser::ResourceElemPath& element) override;
+
+    void updateContent() override;
+    void drawContent() override;
 
 private:
     ModelNodeResource* m_resource = nullptr;
+    std::optional<float> m_cookProgress{};
     std::shared_ptr<ImFlow::OutPin<int>> m_out;
 };
 
@@ -196,9 +223,13 @@ public:
 
     NodeResource* getLinkedResource() override { return m_resource; }
 
+    // Shows the render pass that ended right before the watcher
+    void drawContent() override;
+    void setGPUScope(const GPUScope& scope) { m_gpuScope = scope; }
 
 private:
     WatcherNodeResource* m_resource = nullptr;
+    GPUScope m_gpuScope{};
     std::shared_ptr<ImFlow::InPin<int>> m_in;
     std::shared_ptr<ImFlow::InPin<int>> m_Image;
     std::shared_ptr<ImFlow::OutPin<int>> m_out;
@@ -214,9 +245,7 @@ public:
         m_resource = dynamic_cast<T*>(resource);
 
         static std::shared_ptr<ImFlow::PinStyle> pinColor = std::make_shared<ImFlow::PinStyle>(ImFlow::PinStyle(IM_COL32(26,102,120,255), 4, 4.f, 4.67f, 4.2f, 1.3f));
-        m_out = addOUT<int>("-->", pinColor);
-        m_out->behaviour([this]() -> int { return 0; }); //Not used, but needed to prevent segfault
-        m_out->setFilterID(PRIMITIVE);
+        m_out = addRegisteredOUT(0, pinColor);
     }
 
     NodeResource* getLinkedResource() override { return m_resource; }
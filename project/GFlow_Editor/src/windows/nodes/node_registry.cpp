@@ -0,0 +1,87 @@
+#include "node_registry.hpp"
+
+#include <algorithm>
+
+#include "execution_nodes.hpp"
+
+template <typename T, typename Tr>
+void NodeRegistry::registerNode(Registry& registry, const std::string& menuPath, std::vector<NodePinInfo> inputs, std::vector<NodePinInfo> outputs, const uint8_t flags)
+{
+    Entry entry{ Tr::getTypeStatic(), menuPath };
+    entry.createResource = [](ExecutionResource* execution) -> NodeResource* { return execution->addNode<Tr>(); };
+    entry.createNode = [](ImFlow::ImNodeFlow& grid, const ImVec2* pos, ImGuiGraphWindow* window, NodeResource* resource) -> std::shared_ptr<GFlowNode>
+    {
+        if (pos == nullptr)
+            return grid.placeNode<T>(window, resource);
+        return grid.addNode<T>(*pos, window, resource);
+    };
+    entry.inputs = std::move(inputs);
+    entry.outputs = std::move(outputs);
+    entry.flags = flags;
+    const Entry* registered = &registry.entries.emplace(entry.resourceType, std::move(entry)).first->second;
+    if (menuPath.empty()) return;
+
+    MenuItem* parent = &registry.menu;
+    size_t start = 0;
+    size_t separator = menuPath.find('/');
+    while (separator != std::string::npos)
+    {
+        const std::string label = menuPath.substr(start, separator - start);
+        const auto it = std::ranges::find_if(parent->children, [&label](const MenuItem& item) { return item.entry == nullptr && item.label == label; });
+        parent = it != parent->children.end() ? &*it : &parent->children.emplace_back(MenuItem{ label });
+        start = separator + 1;
+        separator = menuPath.find('/', start);
+    }
+    parent->children.push_back({ menuPath.substr(start), registered });
+}
+
+NodeRegistry::Registry& NodeRegistry::getRegistry()
+{
+    static Registry registry = []
+    {
+        Registry r{};
+        const std::vector<PinType> subpassFlow = { NEXT, BEGIN, BIND_PUSH_CONSTANT, DRAW_CALL };
+
+        registerNode<InitExecutionNode, InitNodeResource>(r, "", {}, { { "-->", INIT } }, NODE_LOADS_WITH_INIT);
+
+        registerNode<BeginExecutionNode, BeginExecutionNodeResource>(r, "Renderpass/Begin", { { "-->", BEGIN, { INIT, END } } }, { { "-->", BEGIN } }, NODE_LOADS_WITH_INIT);
+        registerNode<NextExecutionNode, NextExecutionNodeResource>(r, "Renderpass/Next", { { "-->", NEXT, subpassFlow } }, { { "-->", NEXT } });
+        registerNode<EndExecutionNode, EndExecutionNodeResource>(r, "Renderpass/End", { { "-->", END, subpassFlow } }, { { "-->", END } });
+        registerNode<DrawCallNode, DrawCallNodeResource>(r, "Renderpass/Draw Call", { { "-->", DRAW_CALL, { NEXT, BEGIN, BIND_PUSH_CONSTANT } } }, { { "-->", DRAW_CALL } });
+        registerNode<BindPushConstantNode, BindPushConstantNodeResource>(r, "Renderpass/Bind Push Constant",
+            { { "-->", BIND_PUSH_CONSTANT, { NEXT, BEGIN, DRAW_CALL } }, { "Data", PUSH_CONSTANT, { PUSH_CONSTANT, EXTERNAL_ARGUMENT } } }, { { "-->", BIND_PUSH_CONSTANT } });
+
+        registerNode<ImageNode, ImageNodeResource>(r, "Resources/Image", {}, { { "-->", IMAGE } });
+        registerNode<ModelNode, ModelNodeResource>(r, "Resources/Model", {}, { { "-->", MODEL } });
+        registerNode<DataDecomposeNode, DataDecomposeNodeResource>(r, "Resources/Data Decompose", {}, { { "-->", PUSH_CONSTANT } });
+        registerNode<ExternalArgumentNode, ExternalArgumentNodeResource>(r, "Resources/External Argument", {}, { { "-->", EXTERNAL_ARGUMENT } });
+        registerNode<CameraFlightNode, CameraNodeResource>(r, "Resources/Camera/Flight", {}, { { "VP Matrix", PRIMITIVE } });
+        registerNode<CameraObjectNode, ObjectCameraNodeResource>(r, "Resources/Camera/Object", {}, { { "VP Matrix", PRIMITIVE } });
+
+        registerNode<PrimitiveFloatNode, PrimitiveFloatNodeResource>(r, "Resources/Primitives/Data Types/Float", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveIntNode, PrimitiveIntNodeResource>(r, "Resources/Primitives/Data Types/Int", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveColorNode, PrimitiveColorNodeResource>(r, "Resources/Primitives/Data Types/Color", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveVec2Node, PrimitiveVec2NodeResource>(r, "Resources/Primitives/Data Types/Vec2", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveVec3Node, PrimitiveVec3NodeResource>(r, "Resources/Primitives/Data Types/Vec3", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveVec4Node, PrimitiveVec4NodeResource>(r, "Resources/Primitives/Data Types/Vec4", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveMat3Node, PrimitiveMat3NodeResource>(r, "Resources/Primitives/Data Types/Mat3", {}, { { "-->", PRIMITIVE } });
+        registerNode<PrimitiveMat4Node, PrimitiveMat4NodeResource>(r, "Resources/Primitives/Data Types/Mat4", {}, { { "-->", PRIMITIVE } });
+
+        // The flow pins of the watcher have no filter ID and are left out
+        registerNode<WatcherNode, WatcherNodeResource>(r, "Watcher", { { "Image", IMAGE, { IMAGE } } }, {});
+        return r;
+    }();
+    return registry;
+}
+
+const NodeRegistry::Entry* NodeRegistry::find(const std::string& resourceType)
+{
+    const Registry& registry = getRegistry();
+    const auto it = registry.entries.find(resourceType);
+    return it == registry.entries.end() ? nullptr : &it->second;
+}
+
+const NodeRegistry::MenuItem& NodeRegistry::getMenu()
+{
+    return getRegistry().menu;
+}
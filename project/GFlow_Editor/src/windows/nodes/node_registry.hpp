@@ -0,0 +1,70 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base_node.hpp"
+
+class ExecutionResource;
+
+// A pin every node of a type is created with, the node adds it with GFlowNode::addRegisteredIN/OUT. Pins that come
+// from reflection data, like render pass attachments or push constant components, are not listed
+struct NodePinInfo
+{
+    std::string name{};
+    PinType filterID;
+    // Filter IDs of the output pins that can link into this one, empty for outputs
+    std::vector<PinType> accepts{};
+};
+
+enum NodeFlags : uint8_t
+{
+    NODE_FLAGS_NONE = 0,
+    // Skipped when the execution is loaded without its init node
+    NODE_LOADS_WITH_INIT = 1 << 0,
+};
+
+// Node types of the execution graph keyed by the type of their NodeResource
+class NodeRegistry
+{
+public:
+    // Adds the node of a resource to the grid, at the mouse if there is no position
+    using NodeFactory = std::function<std::shared_ptr<GFlowNode>(ImFlow::ImNodeFlow& grid, const ImVec2* pos, ImGuiGraphWindow* window, NodeResource* resource)>;
+
+    struct Entry
+    {
+        std::string resourceType{};
+        // Submenus of "Add node" separated by '/', empty if the node can't be added by hand
+        std::string menuPath{};
+        std::function<NodeResource*(ExecutionResource*)> createResource;
+        NodeFactory createNode;
+        std::vector<NodePinInfo> inputs{};
+        std::vector<NodePinInfo> outputs{};
+        uint8_t flags = NODE_FLAGS_NONE;
+    };
+
+    struct MenuItem
+    {
+        std::string label{};
+        // Null for submenus
+        const Entry* entry = nullptr;
+        std::vector<MenuItem> children{};
+    };
+
+    [[nodiscard]] static const Entry* find(const std::string& resourceType);
+    // Root of the "Add node" menu, items keep the order they were registered in
+    [[nodiscard]] static const MenuItem& getMenu();
+
+private:
+    struct Registry
+    {
+        std::unordered_map<std::string, Entry> entries{};
+        MenuItem menu{};
+    };
+
+    template <typename T, typename Tr>
+    static void registerNode(Registry& registry, const std::string& menuPath, std::vector<NodePinInfo> inputs, std::vector<NodePinInfo> outputs, uint8_t flags = NODE_FLAGS_NONE);
+    static Registry& getRegistry();
+};
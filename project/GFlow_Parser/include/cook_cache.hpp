@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace gflow::parser
+{
+    // Content hashing and entry naming shared by the asset cookers. Entries are named after a hash of the source
+    // contents combined with everything that affects the cooked output
+    class CookCache
+    {
+    public:
+        static constexpr uint64_t c_hashSeed = 14695981039346656037ULL;
+
+        // FNV-1a, chained through seed
+        [[nodiscard]] static uint64_t hash(const void* data, size_t size, uint64_t seed = c_hashSeed);
+        [[nodiscard]] static uint64_t hashFile(const std::string& path);
+        [[nodiscard]] static std::string getEntryPath(const std::string& directory, uint64_t key, const std::string& extension);
+
+    private:
+        static constexpr uint64_t c_hashPrime = 1099511628211ULL;
+    };
+}
@@ -39,5 +39,6 @@ namespace gflow::parser
         static EnumContext ImageSource;
         static EnumContext ModelFields;
         static EnumContext ExecutionImageType;
+        static EnumContext MipFilter;
     };
 }
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace gflow::parser
+{
+    // Read only memory mapping of a whole file. Cooked assets are laid out so they can be used straight from it
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool open(const std::string& path);
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+        [[nodiscard]] const uint8_t* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "resource.hpp"
+
+namespace gflow::parser
+{
+    // Turns model source files into a compact binary blob with deduplicated vertices, only the requested fields
+    // interleaved, and triangles reordered for the post transform cache and vertex fetch locality
+    class MeshCooker
+    {
+    public:
+        // Bit i matches the value i of EnumContexts::ModelFields
+        enum Field : uint32_t
+        {
+            POSITION = 1 << 0,
+            NORMAL = 1 << 1,
+            TEXCOORD = 1 << 2,
+            COLOR_0 = 1 << 3,
+            COLOR_1 = 1 << 4,
+            TANGENT = 1 << 5,
+            BITANGENT = 1 << 6
+        };
+
+        static constexpr uint32_t c_magic = 0x534D4647; // GFMS
+        static constexpr uint32_t c_version = 2;
+
+        // A range of the index buffer. Every level indexes the same vertex buffer, error is the distance in model
+        // units the level may be off from the full resolution surface
+        struct Lod
+        {
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;
+            float error = 0.0f;
+            uint32_t reserved = 0;
+        };
+
+        // Vertex data, index data and the LOD table follow at the given offsets, all aligned to 16 bytes so they
+        // can be uploaded straight from a mapping of the file. indexCount covers the indices of every LOD
+        struct Header
+        {
+            uint32_t magic = c_magic;
+            uint32_t version = c_version;
+            uint64_t sourceHash = 0;
+            uint32_t fields = 0;
+            uint32_t vertexStride = 0;
+            uint32_t vertexCount = 0;
+            uint32_t indexCount = 0;
+            uint32_t indexSize = 4;
+            uint32_t lodCount = 0;
+            uint64_t vertexOffset = 0;
+            uint64_t indexOffset = 0;
+            float boundsMin[3]{};
+            float boundsMax[3]{};
+            uint64_t lodOffset = 0;
+            float sphereCenter[3]{};
+            float sphereRadius = 0.0f;
+        };
+
+        // Triangulated source data, three corners per triangle
+        struct Geometry
+        {
+            struct Corner
+            {
+                int32_t position = -1;
+                int32_t normal = -1;
+                int32_t texcoord = -1;
+            };
+
+            std::vector<float> positions{};
+            std::vector<float> normals{};
+            std::vector<float> texcoords{};
+            // RGB, one per position
+            std::vector<float> colors{};
+            std::vector<Corner> corners{};
+        };
+
+        struct Mesh
+        {
+            uint32_t fields = 0;
+            uint32_t vertexStride = 0;
+            std::vector<float> vertices{};
+            std::vector<uint32_t> indices{};
+            // Finest first, the first one always covers the whole mesh
+            std::vector<Lod> lods{};
+            float boundsMin[3]{};
+            float boundsMax[3]{};
+            float sphereCenter[3]{};
+            float sphereRadius = 0.0f;
+
+            [[nodiscard]] uint32_t getVertexCount() const { return vertexStride == 0 ? 0 : static_cast<uint32_t>(vertices.size() * sizeof(float) / vertexStride); }
+        };
+
+        // Thrown by a cook that was cancelled through its progress
+        struct Cancelled : std::runtime_error
+        {
+            Cancelled() : std::runtime_error("Mesh cook cancelled") {}
+        };
+
+        // Written by the cooking thread, read by whoever wants to report it
+        struct Progress
+        {
+            std::atomic<size_t> processedBytes{ 0 };
+            std::atomic<size_t> totalBytes{ 0 };
+            // Set by whoever gave up on the result. The cook stops at its next check and throws Cancelled
+            std::atomic<bool> cancelled{ false };
+
+            void checkCancelled() const
+            {
+                if (cancelled.load(std::memory_order_relaxed))
+                    throw Cancelled();
+            }
+
+            [[nodiscard]] float get() const
+            {
+                const size_t total = totalBytes.load(std::memory_order_relaxed);
+                return total == 0 ? 0.0f : static_cast<float>(processedBytes.load(std::memory_order_relaxed)) / static_cast<float>(total);
+            }
+        };
+
+        // Returns the path of the cooked file. The source is only cooked if the cache has no entry for its current
+        // contents, the requested fields and the LOD error budgets. Each budget adds a LOD, relative to the radius
+        // of the mesh
+        static std::string cook(const std::string& sourcePath, uint32_t fields, const std::vector<float>& lodErrors, const std::string& cacheDirectory, Progress* progress = nullptr);
+        // Same as cook, on its own thread. The progress is shared so it outlives the job even if the caller drops it
+        [[nodiscard]] static std::future<std::string> cookAsync(const std::string& sourcePath, uint32_t fields, const std::vector<float>& lodErrors, const std::string& cacheDirectory, const std::shared_ptr<Progress>& progress);
+
+        [[nodiscard]] static uint32_t getFieldMask(const std::vector<EnumExport>& fields);
+        [[nodiscard]] static uint32_t getVertexStride(uint32_t fields);
+
+        // Single threaded tinyobjloader path, kept as the reference ObjParser is checked and measured against
+        [[nodiscard]] static Geometry loadObj(const std::string& path);
+        [[nodiscard]] static Mesh build(const Geometry& geometry, uint32_t fields);
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+        static void optimizeVertexFetch(Mesh& mesh);
+        // Appends a simplified level per error budget, each one built from the previous level
+        static void buildLods(Mesh& mesh, const std::vector<float>& lodErrors);
+        // Quadric error edge collapse onto existing vertices, so the vertex buffer stays shared. Vertices on borders
+        // and attribute seams never move. Stops at the target or once a collapse would cost more than maxError
+        [[nodiscard]] static std::vector<uint32_t> simplify(const Mesh& mesh, const std::vector<uint32_t>& indices, size_t targetIndexCount, float maxError, float& resultError);
+        static bool write(const Mesh& mesh, uint64_t sourceHash, const std::string& path);
+
+    private:
+        static constexpr uint32_t c_cacheSize = 32;
+        // Each LOD aims for this fraction of the triangles of the previous one
+        static constexpr float c_lodTriangleRatio = 0.5f;
+        // Levels that don't remove at least this fraction of the previous triangles are dropped
+        static constexpr float c_lodMinReduction = 0.1f;
+    };
+
+    // Read only view of a cooked mesh file
+    class CookedMesh
+    {
+    public:
+        bool open(const std::string& path);
+
+        [[nodiscard]] const MeshCooker::Header& getHeader() const { return *reinterpret_cast<const MeshCooker::Header*>(m_file.data()); }
+        [[nodiscard]] const void* getVertexData() const { return m_file.data() + getHeader().vertexOffset; }
+        [[nodiscard]] size_t getVertexDataSize() const { return static_cast<size_t>(getHeader().vertexCount) * getHeader().vertexStride; }
+        [[nodiscard]] const void* getIndexData() const { return m_file.data() + getHeader().indexOffset; }
+        [[nodiscard]] size_t getIndexDataSize() const { return static_cast<size_t>(getHeader().indexCount) * getHeader().indexSize; }
+        [[nodiscard]] const MeshCooker::Lod* getLods() const { return reinterpret_cast<const MeshCooker::Lod*>(m_file.data() + getHeader().lodOffset); }
+        [[nodiscard]] uint32_t getLodCount() const { return getHeader().lodCount; }
+
+        // Coarsest LOD whose error, projected at the given distance from the bounding sphere center, stays under
+        // maxPixelError. See getProjectionScale
+        [[nodiscard]] uint32_t selectLod(float distance, float projectionScale, float maxPixelError) const;
+        // Pixels per model unit at distance 1 for a perspective projection, fovY in radians
+        [[nodiscard]] static float getProjectionScale(float fovY, float viewportHeight);
+
+    private:
+        MappedFile m_file;
+    };
+}
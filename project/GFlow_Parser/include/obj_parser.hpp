@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh_cooker.hpp"
+
+namespace gflow::parser
+{
+    // OBJ reader for large files. The file is mapped, split into chunks at line boundaries and the chunks are parsed
+    // concurrently, then merged into the same Geometry MeshCooker::loadObj produces. Polygons are fanned into
+    // triangles and only positions, vertex colors, normals, texture coordinates and faces are read
+    class ObjParser
+    {
+    public:
+        // A thread count of 0 uses every hardware thread
+        [[nodiscard]] static MeshCooker::Geometry parse(const std::string& path, uint32_t threadCount = 0, MeshCooker::Progress* progress = nullptr);
+        [[nodiscard]] static MeshCooker::Geometry parse(const char* data, size_t size, uint32_t threadCount = 0, MeshCooker::Progress* progress = nullptr);
+
+    private:
+        struct Chunk
+        {
+            const char* begin = nullptr;
+            const char* end = nullptr;
+
+            std::vector<float> positions{};
+            std::vector<float> normals{};
+            std::vector<float> texcoords{};
+            std::vector<float> colors{};
+            std::vector<MeshCooker::Geometry::Corner> corners{};
+            // Components (corner * 3 + component) given relative to the end of a list. They are stored relative to
+            // the start of the chunk and only become absolute once the sizes of the previous chunks are known
+            std::vector<uint32_t> relative{};
+
+            size_t firstPosition = 0;
+            size_t firstNormal = 0;
+            size_t firstTexcoord = 0;
+            size_t firstCorner = 0;
+        };
+
+        static void parseChunk(Chunk& chunk, MeshCooker::Progress* progress);
+
+        static constexpr size_t c_minChunkSize = 1 << 20;
+        static constexpr size_t c_chunksPerThread = 4;
+        static constexpr size_t c_progressInterval = 1 << 18;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gflow::parser
+{
+    // Byte layout of a push constant block, member offsets follow the same rules the shader compiler applies to the
+    // block so the packed bytes can be handed to vkCmdPushConstants as they are
+    class PushConstantLayout
+    {
+    public:
+        // Matches EnumContexts::PushConstantElement
+        enum ElementType : uint32_t
+        {
+            INT = 0,
+            FLOAT = 1,
+            VEC2 = 2,
+            VEC3 = 3,
+            VEC4 = 4,
+            MAT2 = 5,
+            MAT3 = 6,
+            MAT4 = 7
+        };
+
+        // Push constant blocks are std430 by default. Scalar needs VK_EXT_scalar_block_layout and the scalar layout
+        // qualifier on the block
+        enum class Rules : uint8_t { STD430, SCALAR };
+
+        struct Element
+        {
+            std::string name;
+            ElementType type = FLOAT;
+        };
+
+        struct Member
+        {
+            std::string name;
+            ElementType type = FLOAT;
+            uint32_t offset = 0;
+            uint32_t size = 0;
+            uint32_t alignment = 0;
+            // Matrices are column major, vectors and scalars are a single column
+            uint32_t columns = 1;
+            uint32_t rows = 1;
+            uint32_t columnStride = 0;
+        };
+
+        // A member as the shader declares it, taken from reflection
+        struct ReflectedMember
+        {
+            std::string name;
+            uint32_t offset = 0;
+            uint32_t size = 0;
+        };
+
+        struct Validation
+        {
+            std::vector<std::string> errors{};
+            std::vector<std::string> warnings{};
+
+            [[nodiscard]] bool isValid() const { return errors.empty(); }
+        };
+
+        // Every device supports at least this much
+        static constexpr uint32_t c_guaranteedMaxSize = 128;
+
+        PushConstantLayout() = default;
+
+        [[nodiscard]] static PushConstantLayout compile(const std::vector<Element>& elements, Rules rules = Rules::STD430);
+
+        // An empty reflection only checks the size
+        [[nodiscard]] Validation validate(uint32_t maxPushConstantsSize, const std::vector<ReflectedMember>& reflected = {}) const;
+
+        [[nodiscard]] const std::vector<Member>& getMembers() const { return m_members; }
+        [[nodiscard]] const Member* findMember(std::string_view name) const;
+        [[nodiscard]] Rules getRules() const { return m_rules; }
+        // Rounded up to the 4 bytes vkCmdPushConstants works in
+        [[nodiscard]] uint32_t getSize() const { return m_size; }
+        // Size of the values of all the members with nothing in between, see PushConstantPacker::pack
+        [[nodiscard]] uint32_t getPackedInputSize() const { return m_inputSize; }
+
+        [[nodiscard]] static uint32_t getComponentCount(ElementType type);
+
+    private:
+        std::vector<Member> m_members{};
+        Rules m_rules = Rules::STD430;
+        uint32_t m_size = 0;
+        uint32_t m_inputSize = 0;
+    };
+
+    // Writes member values into the byte block of a layout. The copies are worked out once from the layout, packing
+    // is a fixed sequence of 16 byte moves into a block that is allocated along with the packer.
+    // Nothing feeds it yet: the graph carries no push constant values and the runtime never pushes any, so the bind
+    // push constant path stops at the layout and its validation
+    class PushConstantPacker
+    {
+    public:
+        PushConstantPacker() = default;
+        explicit PushConstantPacker(const PushConstantLayout& layout);
+
+        // The values of every member in order, each one with its components back to back (a mat3 is 9 floats, column
+        // by column), which is how a data decompose node hands them over. Ints and floats are 4 bytes each
+        void pack(const void* values);
+        // The values of a single member, laid out the same way
+        void set(uint32_t member, const void* values);
+
+        [[nodiscard]] const uint8_t* data() const { return m_block.data(); }
+        [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(m_block.size()); }
+
+    private:
+        struct Copy
+        {
+            uint32_t source = 0;
+            uint32_t destination = 0;
+            uint32_t size = 0;
+        };
+
+        // Copies of all members merged where both sides are contiguous, and the copies of each member on their own
+        std::vector<Copy> m_copies{};
+        std::vector<Copy> m_memberCopies{};
+        std::vector<uint32_t> m_firstMemberCopy{};
+        std::vector<uint8_t> m_block{};
+    };
+}
@@ -228,7 +228,7 @@ namespace gflow::parser
 
     public:
         Resource() { setID(0); }
-        virtual ~Resource() = default;
+        virtual ~Resource() { s_ids.erase(m_id); }
 
         struct Ref { std::string path; };
 
@@ -273,6 +273,11 @@ namespace gflow::parser
 
         [[nodiscard]] bool isNull(const std::string& variable);
 
+        // Goes up whenever an export is set through the parser or a list changes its size, so views can cache what
+        // they read from the resource and rebuild it only when this changes
+        [[nodiscard]] uint32_t getRevision() const { return m_revision; }
+        void markChanged() { m_revision++; }
+
         template <typename T>
         static Resource* create(const std::string& path, ExportData* metadata);
 
@@ -290,6 +295,7 @@ namespace gflow::parser
         void setID(uint32_t id = 0);
 
         inline static std::unordered_set<uint32_t> s_ids;
+        uint32_t m_revision = 0;
 
         template <typename T, bool C, bool R>
         friend class Export;
@@ -355,7 +361,7 @@ namespace gflow::parser
     }
 
     template <typename T, bool C, bool R>
-    Export<T, C, R>::Export(const std::string& name, Resource* parent, EnumContext& enumContext) : m_parent(parent)
+    Export<T, C, R>::Export(const std::string& name, Resource* parent, EnumContext& enumContext) : m_data{}, m_parent(parent)
     {
         Resource::ExportData data;
         this->m_name = name;
@@ -378,6 +384,7 @@ namespace gflow::parser
     void Export<T, C, R>::setData(T value)
     {
          m_data = value;
+         m_parent->markChanged();
          m_parent->exportChanged(m_name);
     }
 
@@ -50,6 +50,8 @@ namespace gflow::parser
         void reset();
 
         [[nodiscard]] std::vector<std::string> getOrderedPaths() const;
+        // Goes up every time a path is added, removed or renamed, or the tree is reset
+        [[nodiscard]] uint32_t getRevision() const { return m_revision; }
 
     private:
         struct FileDirectory
@@ -72,6 +74,7 @@ namespace gflow::parser
         };
 
         FileDirectory root;
+        uint32_t m_revision = 0;
     };
 
     class ResourceManager
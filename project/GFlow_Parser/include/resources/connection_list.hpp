@@ -0,0 +1,200 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "list.hpp"
+
+namespace gflow::parser
+{
+    // Node and pin UIDs on both ends of a connection
+    struct ConnectionKey
+    {
+        size_t leftUID = 0;
+        size_t leftPin = 0;
+        size_t rightUID = 0;
+        size_t rightPin = 0;
+
+        bool operator==(const ConnectionKey& other) const = default;
+    };
+
+    struct ConnectionKeyHash
+    {
+        size_t operator()(const ConnectionKey& key) const
+        {
+            size_t hash = std::hash<size_t>{}(key.leftUID);
+            for (const size_t value : { key.leftPin, key.rightUID, key.rightPin })
+                hash ^= std::hash<size_t>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    class Connection final : public Resource
+    {
+    private:
+        EXPORT(size_t, leftUID);
+        EXPORT(size_t, leftPin);
+        EXPORT(size_t, rightUID);
+        EXPORT(size_t, rightPin);
+
+    public:
+        [[nodiscard]] size_t getLeftUID() const { return *leftUID; }
+        [[nodiscard]] size_t getLeftPin() const { return *leftPin; }
+        [[nodiscard]] size_t getRightUID() const { return *rightUID; }
+        [[nodiscard]] size_t getRightPin() const { return *rightPin; }
+        [[nodiscard]] ConnectionKey getKey() const { return { *leftUID, *leftPin, *rightUID, *rightPin }; }
+        void setValues(const size_t leftUID, const size_t leftPin, const size_t rightUID, const size_t rightPin)
+        {
+            *this->leftUID = leftUID;
+            *this->leftPin = leftPin;
+            *this->rightUID = rightUID;
+            *this->rightPin = rightPin;
+        }
+
+        DECLARE_PRIVATE_RESOURCE(Connection)
+
+        template <typename T>
+        friend class List;
+    };
+
+    // Lookup of a graph's connection list by key and by the node on each end. The graph keeps the list as its export
+    // and makes every edit through here, the index is built again whenever the list revision moves behind its back
+    class ConnectionIndex
+    {
+    public:
+        // Does nothing if the same connection is already there
+        void add(List<Connection*>& connections, const ConnectionKey& key);
+        bool remove(List<Connection*>& connections, const ConnectionKey& key);
+        // Drops every connection leaving or entering the node
+        void removeNode(List<Connection*>& connections, size_t uid);
+        void clear(List<Connection*>& connections);
+
+        [[nodiscard]] const std::vector<ConnectionKey>& getOutgoing(List<Connection*>& connections, size_t uid);
+        [[nodiscard]] const std::vector<ConnectionKey>& getIncoming(List<Connection*>& connections, size_t uid);
+
+    private:
+        void sync(List<Connection*>& connections);
+        void insert(const ConnectionKey& key, int index);
+
+        const List<Connection*>* m_list = nullptr;
+        uint32_t m_revision = 0;
+
+        // Position of every connection in the list, and the connections of every node on each side
+        std::unordered_map<ConnectionKey, int, ConnectionKeyHash> m_positions{};
+        std::unordered_map<size_t, std::vector<ConnectionKey>> m_outgoing{};
+        std::unordered_map<size_t, std::vector<ConnectionKey>> m_incoming{};
+    };
+
+    // ********************
+    // Function definitions
+    // ********************
+
+    inline void ConnectionIndex::add(List<Connection*>& connections, const ConnectionKey& key)
+    {
+        sync(connections);
+        if (m_positions.contains(key)) return;
+
+        (*connections.emplace_back())->setValues(key.leftUID, key.leftPin, key.rightUID, key.rightPin);
+        insert(key, connections.size() - 1);
+        m_revision = connections.getRevision();
+    }
+
+    inline bool ConnectionIndex::remove(List<Connection*>& connections, const ConnectionKey& key)
+    {
+        sync(connections);
+        const auto it = m_positions.find(key);
+        if (it == m_positions.end()) return false;
+
+        // The last connection takes the place of the removed one so nothing is shifted
+        const int index = it->second;
+        const int last = connections.size() - 1;
+        m_positions.erase(it);
+        if (index != last)
+        {
+            std::swap(connections[index], connections[last]);
+            m_positions[connections[index]->getKey()] = index;
+        }
+        connections.remove(last);
+        m_revision = connections.getRevision();
+
+        for (auto& [adjacency, uid] : { std::pair{ &m_outgoing, key.leftUID }, std::pair{ &m_incoming, key.rightUID } })
+        {
+            const auto node = adjacency->find(uid);
+            if (node == adjacency->end()) continue;
+            std::erase(node->second, key);
+            if (node->second.empty())
+                adjacency->erase(node);
+        }
+        return true;
+    }
+
+    inline void ConnectionIndex::removeNode(List<Connection*>& connections, const size_t uid)
+    {
+        sync(connections);
+        for (std::unordered_map<size_t, std::vector<ConnectionKey>>* adjacency : { &m_outgoing, &m_incoming })
+        {
+            const auto it = adjacency->find(uid);
+            if (it == adjacency->end()) continue;
+            const std::vector<ConnectionKey> keys = it->second;
+            for (const ConnectionKey& key : keys)
+                remove(connections, key);
+        }
+    }
+
+    inline void ConnectionIndex::clear(List<Connection*>& connections)
+    {
+        connections.clear();
+        m_positions.clear();
+        m_outgoing.clear();
+        m_incoming.clear();
+        m_list = &connections;
+        m_revision = connections.getRevision();
+    }
+
+    inline const std::vector<ConnectionKey>& ConnectionIndex::getOutgoing(List<Connection*>& connections, const size_t uid)
+    {
+        static const std::vector<ConnectionKey> empty{};
+        sync(connections);
+        const auto it = m_outgoing.find(uid);
+        return it == m_outgoing.end() ? empty : it->second;
+    }
+
+    inline const std::vector<ConnectionKey>& ConnectionIndex::getIncoming(List<Connection*>& connections, const size_t uid)
+    {
+        static const std::vector<ConnectionKey> empty{};
+        sync(connections);
+        const auto it = m_incoming.find(uid);
+        return it == m_incoming.end() ? empty : it->second;
+    }
+
+    inline void ConnectionIndex::sync(List<Connection*>& connections)
+    {
+        if (m_list == &connections && m_revision == connections.getRevision()) return;
+
+        m_positions.clear();
+        m_outgoing.clear();
+        m_incoming.clear();
+        m_positions.reserve(connections.size());
+        for (int i = 0; i < connections.size(); i++)
+        {
+            const ConnectionKey key = connections[i]->getKey();
+            // Duplicates in the file are dropped, the index needs every connection to be unique
+            if (m_positions.contains(key))
+            {
+                connections.remove(i);
+                i--;
+                continue;
+            }
+            insert(key, i);
+        }
+        m_list = &connections;
+        m_revision = connections.getRevision();
+    }
+
+    inline void ConnectionIndex::insert(const ConnectionKey& key, const int index)
+    {
+        m_positions[key] = index;
+        m_outgoing[key.leftUID].push_back(key);
+        m_incoming[key.rightUID].push_back(key);
+    }
+}
@@ -38,7 +38,7 @@ namespace gflow::parser
 
         void remove(int index);
         void erase(T value);
-        void push_back(T value) { m_data.push_back(value); m_size++; }
+        void push_back(T value) { m_data.push_back(value); m_size++; markChanged(); }
         void clear();
 
         T* emplace_back();
@@ -76,6 +76,7 @@ namespace gflow::parser
         if (variable == "size")
         {
             m_size = std::stoi(value);
+            markChanged();
             exportChanged("size");
             return true;
         }
@@ -87,6 +88,7 @@ namespace gflow::parser
             if (index >= m_size)
             {
                 m_size = index + 1;
+                markChanged();
                 exportChanged("size");
             }
         }
@@ -153,6 +155,7 @@ namespace gflow::parser
 
         m_data.erase(m_data.begin() + index);
         m_size--;
+        markChanged();
     }
 
     template <typename T>
@@ -175,6 +178,7 @@ namespace gflow::parser
         }
         m_data.clear();
         m_size = 0;
+        markChanged();
     }
 
     template <typename T>
@@ -193,6 +197,7 @@ namespace gflow::parser
             m_data.push_back(T{});
         }
         m_size++;
+        markChanged();
         return &m_data.back();
     }
 
@@ -209,6 +214,7 @@ namespace gflow::parser
         U* data = ResourceManager::createResource<U>("", &elem);
         m_data.push_back(dynamic_cast<T>(data));
         m_size++;
+        markChanged();
         return dynamic_cast<U*>(m_data.back());
     }
 
@@ -225,6 +231,13 @@ namespace gflow::parser
         else if constexpr (std::is_same_v<T, size_t>) data.type = BIGINT;
         else if constexpr (std::is_same_v<T, float>) data.type = FLOAT;
         else if constexpr (std::is_same_v<T, bool>) data.type = BOOL;
+        else if constexpr (std::is_same_v<T, Vec2>) data.type = VEC2;
+        else if constexpr (std::is_same_v<T, Vec3>) data.type = VEC3;
+        else if constexpr (std::is_same_v<T, Vec4>) data.type = VEC4;
+        else if constexpr (std::is_same_v<T, Mat3>) data.type = MAT3;
+        else if constexpr (std::is_same_v<T, Mat4>) data.type = MAT4;
+        else if constexpr (std::is_same_v<T, Color>) data.type = COLOR;
+        else if constexpr (std::is_same_v<T, UColor>) data.type = UCOLOR;
         else if constexpr (std::is_same_v<T, EnumExport>) data.type = ENUM;
         else if constexpr (std::is_pointer_v<T> && std::is_base_of_v<Resource, std::remove_pointer_t<T>>)
         {
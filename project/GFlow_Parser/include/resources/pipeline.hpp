@@ -2,6 +2,7 @@
 #include "../resource_manager.hpp"
 
 #include "list.hpp"
+#include "profiler.hpp"
 #include "vulkan_shader.hpp"
 #include "utils/shader_reflection.hpp"
 
@@ -148,6 +149,7 @@ namespace gflow::parser
                 }
                 if (m_VertexShader.getStatus().status != VulkanShader::Result::COMPILED || p_ForceRecalculation)
                 {
+                    GFLOW_PROFILE_ZONE("Shader compile");
                     VulkanShader::reinit(m_VertexShader, 0, false);
                     m_VertexShader.loadModule(ResourceManager::makePathAbsolute((*vertex).path), "main");
                     m_VertexShader.linkAndFinalize();
@@ -165,6 +167,7 @@ namespace gflow::parser
                 }
                 if (m_FragmentShader.getStatus().status != VulkanShader::Result::COMPILED || p_ForceRecalculation)
                 {
+                    GFLOW_PROFILE_ZONE("Shader compile");
                     VulkanShader::reinit(m_FragmentShader, 0, false);
                     m_FragmentShader.loadModule(ResourceManager::makePathAbsolute((*fragment).path), "main");
                     m_FragmentShader.linkAndFinalize();
@@ -5,6 +5,7 @@
 
 #include "list.hpp"
 #include "renderpass.hpp"
+#include "texture_cooker.hpp"
 
 namespace gflow::parser
 {
@@ -16,9 +17,15 @@ namespace gflow::parser
         EXPORT(gflow::parser::Color, color);
         EXPORT(bool, matchScreen);
         EXPORT(gflow::parser::Vec2, size);
+        EXPORT_ENUM(format, gflow::parser::EnumContexts::format);
+        EXPORT_ENUM(mipFilter, gflow::parser::EnumContexts::MipFilter);
+        EXPORT(bool, linearSource);
         gflow::parser::DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
 
     public:
+        // Cooks the file into the project cache if needed and returns the cooked path. An undefined format picks RGBA8
+        [[nodiscard]] std::string getCookedPath();
+
         DECLARE_PRIVATE_RESOURCE(ProjectImageSource)
 
         template <typename T>
@@ -33,6 +40,8 @@ namespace gflow::parser
     public:
         Pipeline* getPipeline() { return *pipeline; }
         void setPipeline(Pipeline* pipeline) { this->pipeline.setData(pipeline); }
+        [[nodiscard]] int getVertexCount() { return *vertexCount; }
+        void setVertexCount(const int count) { *vertexCount = count; }
 
         DECLARE_PRIVATE_RESOURCE(ProjectRenderpassDrawCall);
 
@@ -46,6 +55,7 @@ namespace gflow::parser
 
     public:
         ProjectRenderpassDrawCall* addDrawCall() { return *(*drawcalls).emplace_back(); }
+        [[nodiscard]] const std::vector<ProjectRenderpassDrawCall*>& getDrawCalls() const { return (*drawcalls).data(); }
 
         DECLARE_PRIVATE_RESOURCE(ProjectRenderpassSubpass)
 
@@ -65,6 +75,8 @@ namespace gflow::parser
         void setRenderpass(RenderPass* renderpass) { this->renderpass.setData(renderpass); }
 
         ProjectRenderpassSubpass* addSubpass() { return *(*subpasses).emplace_back(); }
+        [[nodiscard]] const std::vector<ProjectRenderpassSubpass*>& getSubpasses() const { return (*subpasses).data(); }
+        void clearSubpasses() { (*subpasses).clear(); }
 
         DECLARE_PRIVATE_RESOURCE(ProjectRenderpass)
 
@@ -81,8 +93,11 @@ namespace gflow::parser
         DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
     public:
         [[nodiscard]] std::string getName() const { return *name; }
+        [[nodiscard]] const std::vector<ProjectImageSource*>& getImages() const { return (*images).data(); }
 
         ProjectRenderpass* addRenderpass() { return *(*renderpasses).emplace_back(); }
+        [[nodiscard]] const std::vector<ProjectRenderpass*>& getRenderpasses() const { return (*renderpasses).data(); }
+        void removeRenderpass(const int index) { (*renderpasses).remove(index); }
 
         void clear() { (*renderpasses).clear(); }
 
@@ -105,13 +120,22 @@ namespace gflow::parser
                 return gflow::parser::USED;
             break;
         case 1: // ImageSource::Flat Color
-            if (variable == "path")
+            if (variable == "path" || variable == "format" || variable == "mipFilter" || variable == "linearSource")
                 return gflow::parser::USED;
             break;
         }
         return NOT_USED;
     }
 
+    inline std::string ProjectImageSource::getCookedPath()
+    {
+        TextureCooker::Settings settings{};
+        settings.format = (*format).id != 0 ? (*format).id : TextureCooker::getDefaultFormat(*linearSource);
+        settings.filter = static_cast<TextureCooker::Filter>((*mipFilter).id);
+        settings.linearSource = *linearSource;
+        return TextureCooker::cook(ResourceManager::makePathAbsolute((*path).path), settings, ResourceManager::getWorkingDir() + ".cache/textures");
+    }
+
     inline DataUsage Project::isUsed(const std::string& variable, const std::vector<Resource*>& parentPath)
     {
         if (variable == "name")
@@ -3,6 +3,7 @@
 
 #include "pair.hpp"
 #include "pipeline.hpp"
+#include "../push_constant_layout.hpp"
 
 namespace gflow::parser
 {
@@ -67,6 +68,7 @@ namespace gflow::parser
 
         [[nodiscard]] bool hasDepthAttachment() const;
         const std::vector<RenderPassPipeline*>& getPipelines() { return (*pipelines).data(); }
+        [[nodiscard]] const std::vector<SubpassAttachment*>& getAttachments() const { return (*attachments).data(); }
 
         DECLARE_PRIVATE_RESOURCE(RenderPassSubpass)
 
@@ -92,6 +94,9 @@ namespace gflow::parser
         EXPORT_ENUM(type, EnumContexts::PushConstantElement);
 
     public:
+        [[nodiscard]] const std::string& getName() const { return *name; }
+        [[nodiscard]] PushConstantLayout::ElementType getElementType() const { return static_cast<PushConstantLayout::ElementType>((*type).id); }
+
         DECLARE_PRIVATE_RESOURCE(PushConstantElement)
 
         template <typename T>
@@ -110,11 +115,18 @@ namespace gflow::parser
         DataUsage isUsed(const std::string& variable, const std::vector<Resource*>& parentPath) override;
     public:
         std::vector<std::string> getElementNames() const;
+        // Compiled on first use and again whenever the elements or the rules change
+        const PushConstantLayout& getLayout(PushConstantLayout::Rules rules = PushConstantLayout::Rules::STD430);
 
         DECLARE_PRIVATE_RESOURCE(PushConstantStructure)
 
         template <typename T>
         friend class List;
+
+    private:
+        PushConstantLayout m_layout{};
+        std::vector<PushConstantLayout::Element> m_layoutElements{};
+        bool m_layoutCompiled = false;
     };
 
     class ImageAttachment final : public Resource
@@ -123,6 +135,9 @@ namespace gflow::parser
         EXPORT(bool, clear);
 
     public:
+        [[nodiscard]] const std::string& getImageID() const { return *imageID; }
+        [[nodiscard]] bool isClear() const { return *clear; }
+
         DECLARE_PUBLIC_RESOURCE(ImageAttachment)
 
         template <typename T>
@@ -142,6 +157,8 @@ namespace gflow::parser
     public:
         void clearSubpasses() { (*subpasses).clear(); }
         RenderPassSubpass* addSubpass() { return *(*subpasses).emplace_back(); }
+        [[nodiscard]] const std::vector<RenderPassSubpass*>& getSubpasses() const { return (*subpasses).data(); }
+        [[nodiscard]] const std::vector<ImageAttachment*>& getAttachments() const { return (*attachments).data(); }
 
         std::vector<std::string> getAttachmentIDs() const;
         std::vector<std::string> getPushConstantIDs(bool includeInternal) const;
@@ -182,6 +199,22 @@ namespace gflow::parser
         return names;
     }
 
+    inline const PushConstantLayout& PushConstantStructure::getLayout(const PushConstantLayout::Rules rules)
+    {
+        const std::vector<PushConstantElement*>& current = (*elements).data();
+        bool upToDate = m_layoutCompiled && m_layout.getRules() == rules && current.size() == m_layoutElements.size();
+        for (size_t i = 0; upToDate && i < current.size(); ++i)
+            upToDate = current[i]->getName() == m_layoutElements[i].name && current[i]->getElementType() == m_layoutElements[i].type;
+        if (upToDate) return m_layout;
+
+        m_layoutElements.clear();
+        for (const PushConstantElement* element : current)
+            m_layoutElements.push_back({ element->getName(), element->getElementType() });
+        m_layout = PushConstantLayout::compile(m_layoutElements, rules);
+        m_layoutCompiled = true;
+        return m_layout;
+    }
+
     inline DataUsage RenderPass::isUsed(const std::string& variable, const std::vector<Resource*>& parentPath)
     {
         if (variable == "subpasses")
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace gflow::parser
+{
+    // Decodes image files once, builds their mip chain and stores it converted to the target format, so loading a
+    // cooked texture is a mapping and a copy per mip
+    class TextureCooker
+    {
+    public:
+        // Matches EnumContexts::MipFilter
+        enum Filter : uint32_t
+        {
+            BOX = 0,
+            KAISER = 1
+        };
+
+        struct Settings
+        {
+            // A VkFormat, see isFormatSupported
+            uint32_t format = 0;
+            Filter filter = KAISER;
+            // Sources are taken as sRGB encoded color unless this is set. Filtering always happens on linear values
+            bool linearSource = false;
+            bool generateMips = true;
+        };
+
+        static constexpr uint32_t c_magic = 0x58544647; // GFTX
+        static constexpr uint32_t c_version = 1;
+
+        // The mip table follows the header, every mip is aligned to 16 bytes, which satisfies the buffer offset
+        // alignment of a buffer to image copy for every supported format
+        struct Header
+        {
+            uint32_t magic = c_magic;
+            uint32_t version = c_version;
+            uint64_t sourceHash = 0;
+            uint32_t format = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mipCount = 0;
+            uint32_t texelSize = 0;
+            uint32_t filter = 0;
+            uint64_t mipOffset = 0;
+        };
+
+        struct Mip
+        {
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        // Linear RGBA floats, one texel fills a SIMD register
+        struct Image
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<float> texels{};
+
+            [[nodiscard]] float* at(const uint32_t x, const uint32_t y) { return &texels[(static_cast<size_t>(y) * width + x) * 4]; }
+            [[nodiscard]] const float* at(const uint32_t x, const uint32_t y) const { return &texels[(static_cast<size_t>(y) * width + x) * 4]; }
+        };
+
+        // Returns the path of the cooked file. The source is only cooked if the cache has no entry for its current
+        // contents and the settings
+        static std::string cook(const std::string& sourcePath, const Settings& settings, const std::string& cacheDirectory);
+        // Cooks every image file directly inside the directory, one file per thread. Files that fail are logged and
+        // left out of the result. A thread count of 0 uses every hardware thread
+        static std::vector<std::string> cookDirectory(const std::string& directory, const Settings& settings, const std::string& cacheDirectory, uint32_t threadCount = 0);
+
+        [[nodiscard]] static bool isFormatSupported(uint32_t format);
+        [[nodiscard]] static bool isImageFile(const std::string& path);
+
+        [[nodiscard]] static Image decode(const std::string& path, bool linearSource);
+        [[nodiscard]] static Image downsample(const Image& image, Filter filter);
+        [[nodiscard]] static std::vector<uint8_t> encode(const Image& image, uint32_t format);
+        static bool write(const std::vector<Image>& mips, const Settings& settings, uint64_t sourceHash, const std::string& path);
+
+        [[nodiscard]] static uint32_t getTexelSize(uint32_t format);
+        // RGBA8, sRGB encoded unless the source holds linear data
+        [[nodiscard]] static uint32_t getDefaultFormat(bool linearSource);
+
+    private:
+        // Kaiser windowed sinc, in destination texels
+        static constexpr float c_kaiserRadius = 3.0f;
+        static constexpr float c_kaiserAlpha = 4.0f;
+    };
+
+    // Read only view of a cooked texture file
+    class CookedTexture
+    {
+    public:
+        bool open(const std::string& path);
+
+        [[nodiscard]] const TextureCooker::Header& getHeader() const { return *reinterpret_cast<const TextureCooker::Header*>(m_file.data()); }
+        [[nodiscard]] const TextureCooker::Mip& getMip(const uint32_t level) const { return reinterpret_cast<const TextureCooker::Mip*>(m_file.data() + getHeader().mipOffset)[level]; }
+        [[nodiscard]] const void* getMipData(const uint32_t level) const { return m_file.data() + getMip(level).offset; }
+
+    private:
+        MappedFile m_file;
+    };
+}
@@ -0,0 +1,44 @@
+#include "cook_cache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace gflow::parser
+{
+    uint64_t CookCache::hash(const void* data, const size_t size, uint64_t seed)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            seed ^= bytes[i];
+            seed *= c_hashPrime;
+        }
+        return seed;
+    }
+
+    uint64_t CookCache::hashFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Failed to open cook source " + path);
+
+        uint64_t result = c_hashSeed;
+        std::vector<char> buffer(1 << 16);
+        while (file)
+        {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            result = hash(buffer.data(), static_cast<size_t>(file.gcount()), result);
+        }
+        return result;
+    }
+
+    std::string CookCache::getEntryPath(const std::string& directory, const uint64_t key, const std::string& extension)
+    {
+        char name[20];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(directory) / (name + extension)).generic_string();
+    }
+}
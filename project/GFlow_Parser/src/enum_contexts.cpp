@@ -984,4 +984,16 @@ namespace gflow::parser
             1
         }
     };
+
+    EnumContext EnumContexts::MipFilter = 
+    {
+        {
+            "Box",
+            "Kaiser"
+        },
+        {
+            0,
+            1
+        }
+    };
 }
@@ -0,0 +1,870 @@
+#include "mesh_cooker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+#include "cook_cache.hpp"
+#include "obj_parser.hpp"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+namespace gflow::parser
+{
+    // Floats per vertex of each field, in the order they are interleaved
+    static constexpr std::array<uint32_t, 7> c_fieldComponents = { 3, 3, 2, 4, 4, 4, 3 };
+
+    struct CornerHash
+    {
+        size_t operator()(const MeshCooker::Geometry::Corner& corner) const
+        {
+            return CookCache::hash(&corner, sizeof(corner));
+        }
+    };
+
+    struct CornerEqual
+    {
+        bool operator()(const MeshCooker::Geometry::Corner& a, const MeshCooker::Geometry::Corner& b) const
+        {
+            return a.position == b.position && a.normal == b.normal && a.texcoord == b.texcoord;
+        }
+    };
+
+    struct FullVertex
+    {
+        float position[3]{};
+        float normal[3]{};
+        float texcoord[2]{};
+        float color[3]{ 1.0f, 1.0f, 1.0f };
+        float tangent[3]{};
+        float bitangent[3]{};
+        float handedness = 1.0f;
+    };
+
+    static void cross(const float* a, const float* b, float* out)
+    {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    static float dot(const float* a, const float* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    static void normalize(float* v)
+    {
+        const float length = std::sqrt(dot(v, v));
+        if (length <= 0.0f) return;
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+
+    uint32_t MeshCooker::getFieldMask(const std::vector<EnumExport>& fields)
+    {
+        uint32_t mask = 0;
+        for (const EnumExport& field : fields)
+            mask |= 1U << field.id;
+        return mask;
+    }
+
+    uint32_t MeshCooker::getVertexStride(const uint32_t fields)
+    {
+        uint32_t stride = 0;
+        for (uint32_t i = 0; i < c_fieldComponents.size(); ++i)
+        {
+            if (fields & (1U << i))
+                stride += c_fieldComponents[i] * sizeof(float);
+        }
+        return stride;
+    }
+
+    MeshCooker::Geometry MeshCooker::loadObj(const std::string& path)
+    {
+        tinyobj::ObjReaderConfig config{};
+        config.triangulate = true;
+        config.vertex_color = true;
+
+        tinyobj::ObjReader reader;
+        if (!reader.ParseFromFile(path, config))
+            throw std::runtime_error("Failed to load model " + path + ": " + reader.Error());
+        if (!reader.Warning().empty())
+            Logger::print(Logger::WARN, "Loading model ", path, ": ", reader.Warning());
+
+        const tinyobj::attrib_t& attrib = reader.GetAttrib();
+        Geometry geometry{};
+        geometry.positions = attrib.vertices;
+        geometry.normals = attrib.normals;
+        geometry.texcoords = attrib.texcoords;
+        geometry.colors = attrib.colors;
+
+        for (const tinyobj::shape_t& shape : reader.GetShapes())
+        {
+            size_t offset = 0;
+            for (const unsigned char faceVertices : shape.mesh.num_face_vertices)
+            {
+                // Only faces the triangulation couldn't handle are left with more corners
+                if (faceVertices == 3)
+                {
+                    for (size_t i = 0; i < 3; ++i)
+                    {
+                        const tinyobj::index_t& index = shape.mesh.indices[offset + i];
+                        geometry.corners.push_back({ index.vertex_index, index.normal_index, index.texcoord_index });
+                    }
+                }
+                offset += faceVertices;
+            }
+        }
+        return geometry;
+    }
+
+    MeshCooker::Mesh MeshCooker::build(const Geometry& geometry, const uint32_t fields)
+    {
+        if (!(fields & POSITION))
+            throw std::runtime_error("Meshes can't be cooked without positions");
+
+        // Unique source corners first, tangent frames are accumulated over the triangles that share them
+        std::vector<FullVertex> full{};
+        std::vector<uint32_t> triangles{};
+        triangles.reserve(geometry.corners.size());
+        {
+            std::unordered_map<Geometry::Corner, uint32_t, CornerHash, CornerEqual> unique{};
+            unique.reserve(geometry.corners.size());
+            for (const Geometry::Corner& corner : geometry.corners)
+            {
+                const auto [it, inserted] = unique.try_emplace(corner, static_cast<uint32_t>(full.size()));
+                triangles.push_back(it->second);
+                if (!inserted) continue;
+
+                FullVertex& vertex = full.emplace_back();
+                std::memcpy(vertex.position, &geometry.positions[corner.position * 3], sizeof(vertex.position));
+                if (corner.normal >= 0)
+                    std::memcpy(vertex.normal, &geometry.normals[corner.normal * 3], sizeof(vertex.normal));
+                if (corner.texcoord >= 0)
+                    std::memcpy(vertex.texcoord, &geometry.texcoords[corner.texcoord * 2], sizeof(vertex.texcoord));
+                if (corner.position * 3 + 2 < static_cast<int32_t>(geometry.colors.size()))
+                    std::memcpy(vertex.color, &geometry.colors[corner.position * 3], sizeof(vertex.color));
+            }
+
+            // Smooth normals for sources that don't have them, weighted by triangle area
+            const bool needsNormals = fields & (NORMAL | TANGENT | BITANGENT);
+            if (needsNormals && std::ranges::any_of(geometry.corners, [](const Geometry::Corner& corner) { return corner.normal < 0; }))
+            {
+                std::vector<float> accumulated(geometry.positions.size(), 0.0f);
+                for (size_t i = 0; i + 2 < geometry.corners.size(); i += 3)
+                {
+                    const float* p0 = full[triangles[i]].position;
+                    const float* p1 = full[triangles[i + 1]].position;
+                    const float* p2 = full[triangles[i + 2]].position;
+                    const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                    const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+                    float normal[3];
+                    cross(e1, e2, normal);
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        float* target = &accumulated[geometry.corners[i + k].position * 3];
+                        target[0] += normal[0];
+                        target[1] += normal[1];
+                        target[2] += normal[2];
+                    }
+                }
+                for (const auto& [corner, index] : unique)
+                {
+                    if (corner.normal >= 0) continue;
+                    std::memcpy(full[index].normal, &accumulated[corner.position * 3], sizeof(full[index].normal));
+                    normalize(full[index].normal);
+                }
+            }
+        }
+
+        if (fields & (TANGENT | BITANGENT))
+        {
+            for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+            {
+                FullVertex& v0 = full[triangles[i]];
+                const FullVertex& v1 = full[triangles[i + 1]];
+                const FullVertex& v2 = full[triangles[i + 2]];
+                const float e1[3] = { v1.position[0] - v0.position[0], v1.position[1] - v0.position[1], v1.position[2] - v0.position[2] };
+                const float e2[3] = { v2.position[0] - v0.position[0], v2.position[1] - v0.position[1], v2.position[2] - v0.position[2] };
+                const float du1 = v1.texcoord[0] - v0.texcoord[0];
+                const float dv1 = v1.texcoord[1] - v0.texcoord[1];
+                const float du2 = v2.texcoord[0] - v0.texcoord[0];
+                const float dv2 = v2.texcoord[1] - v0.texcoord[1];
+                const float det = du1 * dv2 - du2 * dv1;
+                if (std::abs(det) < 1e-12f) continue;
+
+                const float r = 1.0f / det;
+                const float tangent[3] = { (e1[0] * dv2 - e2[0] * dv1) * r, (e1[1] * dv2 - e2[1] * dv1) * r, (e1[2] * dv2 - e2[2] * dv1) * r };
+                const float bitangent[3] = { (e2[0] * du1 - e1[0] * du2) * r, (e2[1] * du1 - e1[1] * du2) * r, (e2[2] * du1 - e1[2] * du2) * r };
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    FullVertex& vertex = full[triangles[i + k]];
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        vertex.tangent[c] += tangent[c];
+                        vertex.bitangent[c] += bitangent[c];
+                    }
+                }
+            }
+
+            // Gram-Schmidt against the normal, the sign of the bitangent is kept as handedness
+            for (FullVertex& vertex : full)
+            {
+                const float d = dot(vertex.normal, vertex.tangent);
+                for (size_t c = 0; c < 3; ++c)
+                    vertex.tangent[c] -= vertex.normal[c] * d;
+                if (dot(vertex.tangent, vertex.tangent) < 1e-12f)
+                {
+                    // No usable texture coordinates, any direction perpendicular to the normal will do
+                    const float axis[3] = { std::abs(vertex.normal[0]) < 0.9f ? 1.0f : 0.0f, std::abs(vertex.normal[0]) < 0.9f ? 0.0f : 1.0f, 0.0f };
+                    cross(vertex.normal, axis, vertex.tangent);
+                }
+                normalize(vertex.tangent);
+
+                float computed[3];
+                cross(vertex.normal, vertex.tangent, computed);
+                vertex.handedness = dot(computed, vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+                for (size_t c = 0; c < 3; ++c)
+                    vertex.bitangent[c] = computed[c] * vertex.handedness;
+            }
+        }
+
+        // Pack the requested fields and deduplicate again, corners that only differed in dropped fields merge here
+        Mesh mesh{};
+        mesh.fields = fields;
+        mesh.vertexStride = getVertexStride(fields);
+        const uint32_t floatsPerVertex = mesh.vertexStride / sizeof(float);
+
+        std::vector<float> packed(full.size() * floatsPerVertex);
+        for (size_t i = 0; i < full.size(); ++i)
+        {
+            const FullVertex& vertex = full[i];
+            float* out = &packed[i * floatsPerVertex];
+            if (fields & POSITION) { std::memcpy(out, vertex.position, 12); out += 3; }
+            if (fields & NORMAL) { std::memcpy(out, vertex.normal, 12); out += 3; }
+            if (fields & TEXCOORD) { std::memcpy(out, vertex.texcoord, 8); out += 2; }
+            if (fields & COLOR_0) { std::memcpy(out, vertex.color, 12); out[3] = 1.0f; out += 4; }
+            // OBJ files only carry one color set
+            if (fields & COLOR_1) { out[0] = out[1] = out[2] = out[3] = 1.0f; out += 4; }
+            if (fields & TANGENT) { std::memcpy(out, vertex.tangent, 12); out[3] = vertex.handedness; out += 4; }
+            if (fields & BITANGENT) { std::memcpy(out, vertex.bitangent, 12); }
+        }
+
+        // Open addressing on the packed bytes, so ties resolve the same way on every run
+        std::vector<uint32_t> remap(full.size());
+        {
+            size_t tableSize = 1;
+            while (tableSize < full.size() * 2) tableSize <<= 1;
+            std::vector<uint32_t> table(tableSize, UINT32_MAX);
+            uint32_t vertexCount = 0;
+            for (size_t i = 0; i < full.size(); ++i)
+            {
+                const float* vertex = &packed[i * floatsPerVertex];
+                size_t slot = CookCache::hash(vertex, mesh.vertexStride) & (tableSize - 1);
+                while (table[slot] != UINT32_MAX && std::memcmp(&mesh.vertices[table[slot] * floatsPerVertex], vertex, mesh.vertexStride) != 0)
+                    slot = (slot + 1) & (tableSize - 1);
+
+                if (table[slot] == UINT32_MAX)
+                {
+                    table[slot] = vertexCount++;
+                    mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + floatsPerVertex);
+                }
+                remap[i] = table[slot];
+            }
+        }
+
+        mesh.indices.reserve(triangles.size());
+        for (const uint32_t index : triangles)
+            mesh.indices.push_back(remap[index]);
+
+        for (size_t c = 0; c < 3; ++c)
+        {
+            mesh.boundsMin[c] = full.empty() ? 0.0f : std::numeric_limits<float>::max();
+            mesh.boundsMax[c] = full.empty() ? 0.0f : std::numeric_limits<float>::lowest();
+        }
+        for (const FullVertex& vertex : full)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                mesh.boundsMin[c] = std::min(mesh.boundsMin[c], vertex.position[c]);
+                mesh.boundsMax[c] = std::max(mesh.boundsMax[c], vertex.position[c]);
+            }
+        }
+
+        // Centered on the box, not the tightest sphere but stable and cheap
+        for (size_t c = 0; c < 3; ++c)
+            mesh.sphereCenter[c] = (mesh.boundsMin[c] + mesh.boundsMax[c]) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (const FullVertex& vertex : full)
+        {
+            const float offset[3] = { vertex.position[0] - mesh.sphereCenter[0], vertex.position[1] - mesh.sphereCenter[1], vertex.position[2] - mesh.sphereCenter[2] };
+            radiusSquared = std::max(radiusSquared, dot(offset, offset));
+        }
+        mesh.sphereRadius = std::sqrt(radiusSquared);
+
+        optimizeVertexCache(mesh.indices, mesh.getVertexCount());
+        optimizeVertexFetch(mesh);
+        mesh.lods = { { 0, static_cast<uint32_t>(mesh.indices.size()), 0.0f } };
+        return mesh;
+    }
+
+    // Forsyth's linear speed vertex cache optimization
+    static float vertexScore(const int32_t cachePosition, const uint32_t remainingTriangles, const uint32_t cacheSize)
+    {
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            // The vertices of the last triangle get a fixed score so its neighbours aren't favoured too much
+            if (cachePosition < 3)
+                score = 0.75f;
+            else
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(cacheSize - 3), 1.5f);
+        }
+        // Vertices with few triangles left are finished first, so they can leave the cache
+        score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        return score;
+    }
+
+    void MeshCooker::optimizeVertexCache(std::vector<uint32_t>& indices, const uint32_t vertexCount)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (triangleCount == 0) return;
+
+        // Triangles around each vertex, the live ones are the first `remaining` entries of each range
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (const uint32_t index : indices)
+            remaining[index]++;
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] = offsets[v] + remaining[v];
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (uint32_t t = 0; t < triangleCount; ++t)
+            {
+                for (uint32_t k = 0; k < 3; ++k)
+                    adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        std::vector<int32_t> cachePosition(vertexCount, -1);
+        std::vector<float> scores(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            scores[v] = vertexScore(-1, remaining[v], c_cacheSize);
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        uint32_t best = 0;
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+            if (triangleScores[t] > triangleScores[best])
+                best = t;
+        }
+
+        std::vector<uint32_t> result{};
+        result.reserve(indices.size());
+        std::vector<uint32_t> cache{};
+        std::vector<uint32_t> nextCache{};
+        cache.reserve(c_cacheSize + 3);
+        nextCache.reserve(c_cacheSize + 3);
+        uint32_t scanCursor = 0;
+        while (result.size() < indices.size())
+        {
+            if (best == UINT32_MAX)
+            {
+                // Nothing in the cache touches a triangle that is left, continue in the original order
+                while (emitted[scanCursor]) scanCursor++;
+                best = scanCursor;
+            }
+
+            emitted[best] = true;
+            const uint32_t* triangle = &indices[best * 3];
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const uint32_t v = triangle[k];
+                result.push_back(v);
+
+                uint32_t* begin = &adjacency[offsets[v]];
+                uint32_t* end = begin + remaining[v];
+                std::iter_swap(std::find(begin, end, best), end - 1);
+                remaining[v]--;
+            }
+
+            nextCache.assign(triangle, triangle + 3);
+            for (const uint32_t v : cache)
+            {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    nextCache.push_back(v);
+            }
+            for (uint32_t i = 0; i < nextCache.size(); ++i)
+                cachePosition[nextCache[i]] = i < c_cacheSize ? static_cast<int32_t>(i) : -1;
+
+            // Only the triangles around vertices whose score changed need to be looked at for the next pick
+            for (const uint32_t v : nextCache)
+                scores[v] = vertexScore(cachePosition[v], remaining[v], c_cacheSize);
+
+            best = UINT32_MAX;
+            float bestScore = -1.0f;
+            for (const uint32_t v : nextCache)
+            {
+                for (uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; ++i)
+                {
+                    const uint32_t t = adjacency[i];
+                    triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+                    if (triangleScores[t] > bestScore || (triangleScores[t] == bestScore && t < best))
+                    {
+                        bestScore = triangleScores[t];
+                        best = t;
+                    }
+                }
+            }
+
+            if (nextCache.size() > c_cacheSize)
+                nextCache.resize(c_cacheSize);
+            std::swap(cache, nextCache);
+        }
+        indices = std::move(result);
+    }
+
+    void MeshCooker::optimizeVertexFetch(Mesh& mesh)
+    {
+        // Vertices are laid out in the order the index buffer first touches them
+        const uint32_t floatsPerVertex = mesh.vertexStride / sizeof(float);
+        std::vector<uint32_t> remap(mesh.getVertexCount(), UINT32_MAX);
+        std::vector<float> vertices{};
+        vertices.reserve(mesh.vertices.size());
+        uint32_t next = 0;
+        for (uint32_t& index : mesh.indices)
+        {
+            if (remap[index] == UINT32_MAX)
+            {
+                remap[index] = next++;
+                vertices.insert(vertices.end(), mesh.vertices.begin() + index * floatsPerVertex, mesh.vertices.begin() + (index + 1) * floatsPerVertex);
+            }
+            index = remap[index];
+        }
+        mesh.vertices = std::move(vertices);
+    }
+
+    // Sum of squared distances to a set of planes, weighted by the area of the triangles they come from
+    struct Quadric
+    {
+        // xx, xy, xz, xw, yy, yz, yw, zz, zw, ww
+        double a[10]{};
+        double weight = 0.0;
+
+        void addPlane(const double nx, const double ny, const double nz, const double d, const double w)
+        {
+            a[0] += w * nx * nx; a[1] += w * nx * ny; a[2] += w * nx * nz; a[3] += w * nx * d;
+            a[4] += w * ny * ny; a[5] += w * ny * nz; a[6] += w * ny * d;
+            a[7] += w * nz * nz; a[8] += w * nz * d;
+            a[9] += w * d * d;
+            weight += w;
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            for (size_t i = 0; i < 10; ++i)
+                a[i] += other.a[i];
+            weight += other.weight;
+            return *this;
+        }
+
+        // Weighted mean squared distance, so the result is comparable across differently sized meshes
+        [[nodiscard]] double evaluate(const float* p) const
+        {
+            if (weight <= 0.0) return 0.0;
+            const double x = p[0], y = p[1], z = p[2];
+            const double error = a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+                + a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+                + a[7] * z * z + 2.0 * a[8] * z
+                + a[9];
+            return std::max(error, 0.0) / weight;
+        }
+    };
+
+    void MeshCooker::buildLods(Mesh& mesh, const std::vector<float>& lodErrors)
+    {
+        for (const float lodError : lodErrors)
+        {
+            const Lod previous = mesh.lods.back();
+            const std::vector<uint32_t> source(mesh.indices.begin() + previous.firstIndex, mesh.indices.begin() + previous.firstIndex + previous.indexCount);
+            const size_t target = static_cast<size_t>(static_cast<float>(source.size() / 3) * c_lodTriangleRatio) * 3;
+
+            float error = 0.0f;
+            std::vector<uint32_t> indices = simplify(mesh, source, target, lodError * mesh.sphereRadius, error);
+            // A tighter budget than the last level or a mesh that is already as coarse as its borders allow
+            if (static_cast<float>(indices.size()) > static_cast<float>(source.size()) * (1.0f - c_lodMinReduction))
+                continue;
+
+            optimizeVertexCache(indices, mesh.getVertexCount());
+            // Each level is simplified from the previous one, so the errors add up
+            mesh.lods.push_back({ static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(indices.size()), previous.error + error });
+            mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+        }
+    }
+
+    std::vector<uint32_t> MeshCooker::simplify(const Mesh& mesh, const std::vector<uint32_t>& indices, const size_t targetIndexCount, const float maxError, float& resultError)
+    {
+        const uint32_t floatsPerVertex = mesh.vertexStride / sizeof(float);
+        const uint32_t vertexCount = mesh.getVertexCount();
+        const auto position = [&](const uint32_t vertex) { return &mesh.vertices[static_cast<size_t>(vertex) * floatsPerVertex]; };
+        resultError = 0.0f;
+
+        // Vertices that share a position are one point of the surface, the first of them stands for all
+        std::vector<uint32_t> canonical(vertexCount);
+        std::vector<uint32_t> wedges(vertexCount, 0);
+        {
+            size_t tableSize = 1;
+            while (tableSize < static_cast<size_t>(vertexCount) * 2) tableSize <<= 1;
+            std::vector<uint32_t> table(tableSize, UINT32_MAX);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                size_t slot = CookCache::hash(position(v), 3 * sizeof(float)) & (tableSize - 1);
+                while (table[slot] != UINT32_MAX && std::memcmp(position(table[slot]), position(v), 3 * sizeof(float)) != 0)
+                    slot = (slot + 1) & (tableSize - 1);
+                if (table[slot] == UINT32_MAX)
+                    table[slot] = v;
+                canonical[v] = table[slot];
+                wedges[canonical[v]]++;
+            }
+        }
+
+        std::vector<uint32_t> triangles = indices;
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+        {
+            const float* p0 = position(triangles[i]);
+            const float* p1 = position(triangles[i + 1]);
+            const float* p2 = position(triangles[i + 2]);
+            const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            float normal[3];
+            cross(e1, e2, normal);
+            const float doubleArea = std::sqrt(dot(normal, normal));
+            if (doubleArea <= 0.0f) continue;
+
+            normalize(normal);
+            Quadric quadric{};
+            quadric.addPlane(normal[0], normal[1], normal[2], -dot(normal, p0), doubleArea * 0.5);
+            for (size_t k = 0; k < 3; ++k)
+                quadrics[canonical[triangles[i + k]]] += quadric;
+        }
+
+        // Border and non manifold edges are the ones without exactly one twin running the other way
+        std::vector<bool> locked(vertexCount, false);
+        {
+            std::vector<std::pair<uint32_t, uint32_t>> edges{};
+            edges.reserve(triangles.size());
+            for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                    edges.emplace_back(canonical[triangles[i + k]], canonical[triangles[i + (k + 1) % 3]]);
+            }
+            std::ranges::sort(edges);
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                const auto [a, b] = edges[i];
+                const bool duplicated = (i > 0 && edges[i - 1] == edges[i]) || (i + 1 < edges.size() && edges[i + 1] == edges[i]);
+                const auto [first, last] = std::ranges::equal_range(edges, std::pair{ b, a });
+                if (duplicated || last - first != 1)
+                    locked[a] = locked[b] = true;
+            }
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (wedges[canonical[v]] > 1)
+                    locked[canonical[v]] = true;
+            }
+        }
+
+        const double errorLimit = static_cast<double>(maxError) * maxError;
+        double maxCost = 0.0;
+        std::vector<uint32_t> collapseTarget(vertexCount, UINT32_MAX);
+        std::vector<bool> touched(vertexCount);
+        std::vector<uint32_t> offsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency{};
+        std::vector<double> bestCost(vertexCount);
+        std::vector<uint32_t> bestTarget(vertexCount);
+        std::vector<uint32_t> order{};
+        std::vector<uint32_t> neighboursU{};
+        std::vector<uint32_t> neighboursV{};
+        const auto gatherNeighbours = [&](const uint32_t vertex, std::vector<uint32_t>& neighbours)
+        {
+            neighbours.clear();
+            for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const uint32_t other = canonical[triangles[adjacency[i] * 3 + k]];
+                    if (other != vertex) neighbours.push_back(other);
+                }
+            }
+            std::ranges::sort(neighbours);
+            neighbours.erase(std::ranges::unique(neighbours).begin(), neighbours.end());
+        };
+
+        // Passes of independent collapses, every collapse only looks at triangles no other collapse in the same pass
+        // has changed. Candidates are taken cheapest first with ties broken by index, so the result is deterministic
+        while (triangles.size() > targetIndexCount)
+        {
+            const uint32_t triangleCount = static_cast<uint32_t>(triangles.size() / 3);
+            std::ranges::fill(offsets, 0);
+            for (const uint32_t index : triangles)
+                offsets[canonical[index] + 1]++;
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1] += offsets[v];
+            adjacency.resize(triangles.size());
+            {
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (uint32_t t = 0; t < triangleCount; ++t)
+                {
+                    for (size_t k = 0; k < 3; ++k)
+                        adjacency[fill[canonical[triangles[t * 3 + k]]]++] = t;
+                }
+            }
+
+            std::ranges::fill(bestCost, std::numeric_limits<double>::max());
+            for (size_t i = 0; i < triangles.size(); ++i)
+            {
+                const uint32_t u = canonical[triangles[i]];
+                if (locked[u]) continue;
+                for (const size_t k : { size_t{ 1 }, size_t{ 2 } })
+                {
+                    const uint32_t target = triangles[i - i % 3 + (i % 3 + k) % 3];
+                    Quadric combined = quadrics[u];
+                    combined += quadrics[canonical[target]];
+                    const double cost = combined.evaluate(position(target));
+                    if (cost < bestCost[u] || (cost == bestCost[u] && canonical[target] < canonical[bestTarget[u]]))
+                    {
+                        bestCost[u] = cost;
+                        bestTarget[u] = target;
+                    }
+                }
+            }
+
+            order.clear();
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (bestCost[v] <= errorLimit)
+                    order.push_back(v);
+            }
+            std::ranges::sort(order, [&](const uint32_t a, const uint32_t b) { return bestCost[a] != bestCost[b] ? bestCost[a] < bestCost[b] : a < b; });
+
+            std::fill(touched.begin(), touched.end(), false);
+            size_t remaining = triangles.size();
+            size_t collapses = 0;
+            for (const uint32_t u : order)
+            {
+                if (remaining <= targetIndexCount) break;
+                const uint32_t target = bestTarget[u];
+                const uint32_t v = canonical[target];
+                if (touched[u] || touched[v]) continue;
+
+                // Interior edges have exactly two common neighbours, anything else would fold the surface
+                gatherNeighbours(u, neighboursU);
+                gatherNeighbours(v, neighboursV);
+                size_t common = 0;
+                for (size_t a = 0, b = 0; a < neighboursU.size() && b < neighboursV.size();)
+                {
+                    if (neighboursU[a] < neighboursV[b]) ++a;
+                    else if (neighboursU[a] > neighboursV[b]) ++b;
+                    else { ++common; ++a; ++b; }
+                }
+                if (common != 2) continue;
+
+                // Triangles that stay must not flip
+                bool flips = false;
+                for (uint32_t i = offsets[u]; i < offsets[u + 1] && !flips; ++i)
+                {
+                    const uint32_t* triangle = &triangles[adjacency[i] * 3];
+                    if (canonical[triangle[0]] == v || canonical[triangle[1]] == v || canonical[triangle[2]] == v) continue;
+
+                    const float* before[3] = { position(triangle[0]), position(triangle[1]), position(triangle[2]) };
+                    const float* after[3] = { before[0], before[1], before[2] };
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        if (canonical[triangle[k]] == u) after[k] = position(target);
+                    }
+                    float normalBefore[3], normalAfter[3];
+                    const float b1[3] = { before[1][0] - before[0][0], before[1][1] - before[0][1], before[1][2] - before[0][2] };
+                    const float b2[3] = { before[2][0] - before[0][0], before[2][1] - before[0][1], before[2][2] - before[0][2] };
+                    const float a1[3] = { after[1][0] - after[0][0], after[1][1] - after[0][1], after[1][2] - after[0][2] };
+                    const float a2[3] = { after[2][0] - after[0][0], after[2][1] - after[0][1], after[2][2] - after[0][2] };
+                    cross(b1, b2, normalBefore);
+                    cross(a1, a2, normalAfter);
+                    flips = dot(normalBefore, normalAfter) <= 0.0f;
+                }
+                if (flips) continue;
+
+                collapseTarget[u] = target;
+                quadrics[v] += quadrics[u];
+                maxCost = std::max(maxCost, bestCost[u]);
+                touched[u] = touched[v] = true;
+                for (const uint32_t neighbour : neighboursU)
+                    touched[neighbour] = true;
+                remaining -= 6;
+                collapses++;
+            }
+            if (collapses == 0) break;
+
+            // Only unlocked vertices move and those have a single wedge, so the vertex is its own canonical one
+            size_t write = 0;
+            for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+            {
+                uint32_t triangle[3];
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const uint32_t vertex = triangles[i + k];
+                    triangle[k] = collapseTarget[vertex] != UINT32_MAX ? collapseTarget[vertex] : vertex;
+                }
+                if (canonical[triangle[0]] == canonical[triangle[1]] || canonical[triangle[1]] == canonical[triangle[2]] || canonical[triangle[0]] == canonical[triangle[2]])
+                    continue;
+                std::copy_n(triangle, 3, triangles.begin() + write);
+                write += 3;
+            }
+            triangles.resize(write);
+            std::ranges::fill(collapseTarget, UINT32_MAX);
+        }
+
+        resultError = static_cast<float>(std::sqrt(maxCost));
+        return triangles;
+    }
+
+    bool MeshCooker::write(const Mesh& mesh, const uint64_t sourceHash, const std::string& path)
+    {
+        Header header{};
+        header.sourceHash = sourceHash;
+        header.fields = mesh.fields;
+        header.vertexStride = mesh.vertexStride;
+        header.vertexCount = mesh.getVertexCount();
+        header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        // 0xFFFF is left out so primitive restart never turns a real index into a strip cut
+        header.indexSize = header.vertexCount < 0xFFFF ? 2 : 4;
+        header.vertexOffset = (sizeof(Header) + 15) & ~15ULL;
+        header.indexOffset = (header.vertexOffset + static_cast<uint64_t>(header.vertexCount) * header.vertexStride + 15) & ~15ULL;
+        header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+        header.lodOffset = (header.indexOffset + static_cast<uint64_t>(header.indexCount) * header.indexSize + 15) & ~15ULL;
+        std::memcpy(header.boundsMin, mesh.boundsMin, sizeof(header.boundsMin));
+        std::memcpy(header.boundsMax, mesh.boundsMax, sizeof(header.boundsMax));
+        std::memcpy(header.sphereCenter, mesh.sphereCenter, sizeof(header.sphereCenter));
+        header.sphereRadius = mesh.sphereRadius;
+
+        // Written next to the destination and moved over it, so a cache entry is never seen half written
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                Logger::print(Logger::ERR, "Failed to open cooked mesh output file: ", tempPath);
+                return false;
+            }
+
+            const char padding[16]{};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            file.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(Header)));
+            file.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size() * sizeof(float)));
+            file.write(padding, static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - static_cast<uint64_t>(header.vertexCount) * header.vertexStride));
+            if (header.indexSize == 2)
+            {
+                std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+                file.write(reinterpret_cast<const char*>(shortIndices.data()), static_cast<std::streamsize>(shortIndices.size() * sizeof(uint16_t)));
+            }
+            else
+            {
+                file.write(reinterpret_cast<const char*>(mesh.indices.data()), static_cast<std::streamsize>(mesh.indices.size() * sizeof(uint32_t)));
+            }
+            file.write(padding, static_cast<std::streamsize>(header.lodOffset - header.indexOffset - static_cast<uint64_t>(header.indexCount) * header.indexSize));
+            file.write(reinterpret_cast<const char*>(mesh.lods.data()), static_cast<std::streamsize>(mesh.lods.size() * sizeof(Lod)));
+            if (!file.good()) return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        return !error;
+    }
+
+    std::string MeshCooker::cook(const std::string& sourcePath, const uint32_t fields, const std::vector<float>& lodErrors, const std::string& cacheDirectory, Progress* progress)
+    {
+        const uint64_t sourceHash = CookCache::hashFile(sourcePath);
+
+        // The field set, the LOD budgets and the format version are part of the key, changing any cooks a new entry
+        uint64_t key = CookCache::hash(&fields, sizeof(fields), sourceHash);
+        key = CookCache::hash(lodErrors.data(), lodErrors.size() * sizeof(float), key);
+        key = CookCache::hash(&c_version, sizeof(c_version), key);
+        const std::string path = CookCache::getEntryPath(cacheDirectory, key, ".gfmesh");
+
+        CookedMesh cached{};
+        if (cached.open(path) && cached.getHeader().sourceHash == sourceHash && cached.getHeader().fields == fields)
+            return path;
+
+        std::filesystem::create_directories(cacheDirectory);
+        Mesh mesh = build(ObjParser::parse(sourcePath, 0, progress), fields);
+        if (progress != nullptr)
+            progress->checkCancelled();
+        buildLods(mesh, lodErrors);
+        if (progress != nullptr)
+            progress->checkCancelled();
+        if (!write(mesh, sourceHash, path))
+            throw std::runtime_error("Failed to write cooked mesh " + path);
+
+        Logger::print(Logger::INFO, "Cooked ", sourcePath, ": ", mesh.getVertexCount(), " vertices, ", mesh.lods.front().indexCount / 3, " triangles, ", mesh.lods.size(), " LODs");
+        return path;
+    }
+
+    std::future<std::string> MeshCooker::cookAsync(const std::string& sourcePath, const uint32_t fields, const std::vector<float>& lodErrors, const std::string& cacheDirectory, const std::shared_ptr<Progress>& progress)
+    {
+        return std::async(std::launch::async, [sourcePath, fields, lodErrors, cacheDirectory, progress]()
+        {
+            return cook(sourcePath, fields, lodErrors, cacheDirectory, progress.get());
+        });
+    }
+
+    bool CookedMesh::open(const std::string& path)
+    {
+        if (!m_file.open(path)) return false;
+
+        // Anything that doesn't look like a complete file of the current version is treated as missing
+        if (m_file.size() < sizeof(MeshCooker::Header))
+        {
+            m_file.close();
+            return false;
+        }
+        const MeshCooker::Header& header = getHeader();
+        const bool valid = header.magic == MeshCooker::c_magic && header.version == MeshCooker::c_version
+            && header.vertexOffset + getVertexDataSize() <= m_file.size()
+            && header.indexOffset + getIndexDataSize() <= m_file.size()
+            && header.lodCount > 0 && header.lodOffset + header.lodCount * sizeof(MeshCooker::Lod) <= m_file.size();
+        if (!valid)
+            m_file.close();
+        return valid;
+    }
+
+    uint32_t CookedMesh::selectLod(const float distance, const float projectionScale, const float maxPixelError) const
+    {
+        // Measured from the closest point of the bounding sphere, so nothing is coarser than it should be up close
+        const float surfaceDistance = std::max(distance - getHeader().sphereRadius, std::numeric_limits<float>::epsilon());
+        const MeshCooker::Lod* lods = getLods();
+        for (uint32_t i = getLodCount() - 1; i > 0; --i)
+        {
+            if (lods[i].error * projectionScale / surfaceDistance <= maxPixelError)
+                return i;
+        }
+        return 0;
+    }
+
+    float CookedMesh::getProjectionScale(const float fovY, const float viewportHeight)
+    {
+        return viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+    }
+}
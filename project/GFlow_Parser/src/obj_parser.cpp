@@ -0,0 +1,286 @@
+#include "obj_parser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+#include "mapped_file.hpp"
+#include "worker_pool.hpp"
+
+namespace gflow::parser
+{
+    using Corner = MeshCooker::Geometry::Corner;
+
+    static const char* skipSpaces(const char* it, const char* end)
+    {
+        while (it < end && (*it == ' ' || *it == '\t')) ++it;
+        return it;
+    }
+
+    static bool parseFloat(const char*& it, const char* end, float& value)
+    {
+        it = skipSpaces(it, end);
+        // from_chars doesn't take an explicit plus sign
+        if (it < end && *it == '+') ++it;
+        value = 0.0f;
+        const auto [ptr, error] = std::from_chars(it, end, value);
+        // Out of range values still consume their characters, they are left at zero
+        if (ptr == it) return false;
+        it = ptr;
+        return true;
+    }
+
+    static bool parseInt(const char*& it, const char* end, int32_t& value)
+    {
+        const auto [ptr, error] = std::from_chars(it, end, value);
+        if (error != std::errc()) return false;
+        it = ptr;
+        return true;
+    }
+
+    // The keyword has to be followed by whitespace, "v" must not match "vn"
+    static bool isKeyword(const char* line, const char* end, const std::string_view keyword)
+    {
+        if (static_cast<size_t>(end - line) <= keyword.size()) return false;
+        return std::string_view(line, keyword.size()) == keyword && (line[keyword.size()] == ' ' || line[keyword.size()] == '\t');
+    }
+
+    static int32_t& getComponent(Corner& corner, const uint32_t component)
+    {
+        switch (component)
+        {
+        case 0: return corner.position;
+        case 1: return corner.normal;
+        default: return corner.texcoord;
+        }
+    }
+
+    MeshCooker::Geometry ObjParser::parse(const std::string& path, const uint32_t threadCount, MeshCooker::Progress* progress)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            throw std::runtime_error("Failed to open model " + path);
+        return parse(reinterpret_cast<const char*>(file.data()), file.size(), threadCount, progress);
+    }
+
+    MeshCooker::Geometry ObjParser::parse(const char* data, const size_t size, const uint32_t threadCount, MeshCooker::Progress* progress)
+    {
+        const uint32_t threads = threadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1U) : threadCount;
+        if (progress != nullptr)
+        {
+            progress->processedBytes = 0;
+            progress->totalBytes = size;
+        }
+
+        // More chunks than threads so that the face heavy end of a file doesn't all land on the same thread
+        const size_t chunkCount = std::clamp<size_t>(size / c_minChunkSize, 1, static_cast<size_t>(threads) * c_chunksPerThread);
+        std::vector<Chunk> chunks{};
+        chunks.reserve(chunkCount);
+        const char* end = data + size;
+        const char* begin = data;
+        for (size_t i = 1; i <= chunkCount && begin < end; ++i)
+        {
+            const char* chunkEnd = end;
+            if (i < chunkCount)
+            {
+                const char* newline = static_cast<const char*>(std::memchr(data + size * i / chunkCount, '\n', end - (data + size * i / chunkCount)));
+                chunkEnd = newline == nullptr ? end : newline + 1;
+            }
+            if (chunkEnd <= begin) continue;
+
+            Chunk& chunk = chunks.emplace_back();
+            chunk.begin = begin;
+            chunk.end = chunkEnd;
+            begin = chunkEnd;
+        }
+
+        // Both passes run on the same workers
+        WorkerPool workers{ static_cast<uint32_t>(std::min<size_t>(threads, chunks.size())) };
+        workers.parallelFor(static_cast<uint32_t>(chunks.size()), [&](const uint32_t i, uint32_t) { parseChunk(chunks[i], progress); });
+        if (progress != nullptr)
+            progress->checkCancelled();
+
+        // Every chunk now knows how much it holds, so each one can be copied into place and resolved independently
+        size_t positionCount = 0, normalCount = 0, texcoordCount = 0, cornerCount = 0;
+        for (Chunk& chunk : chunks)
+        {
+            chunk.firstPosition = positionCount;
+            chunk.firstNormal = normalCount;
+            chunk.firstTexcoord = texcoordCount;
+            chunk.firstCorner = cornerCount;
+            positionCount += chunk.positions.size() / 3;
+            normalCount += chunk.normals.size() / 3;
+            texcoordCount += chunk.texcoords.size() / 2;
+            cornerCount += chunk.corners.size();
+        }
+
+        MeshCooker::Geometry geometry{};
+        geometry.positions.resize(positionCount * 3);
+        geometry.colors.resize(positionCount * 3);
+        geometry.normals.resize(normalCount * 3);
+        geometry.texcoords.resize(texcoordCount * 2);
+        geometry.corners.resize(cornerCount);
+
+        workers.parallelFor(static_cast<uint32_t>(chunks.size()), [&](const uint32_t i, uint32_t)
+        {
+            Chunk& chunk = chunks[i];
+            std::ranges::copy(chunk.positions, geometry.positions.begin() + chunk.firstPosition * 3);
+            std::ranges::copy(chunk.colors, geometry.colors.begin() + chunk.firstPosition * 3);
+            std::ranges::copy(chunk.normals, geometry.normals.begin() + chunk.firstNormal * 3);
+            std::ranges::copy(chunk.texcoords, geometry.texcoords.begin() + chunk.firstTexcoord * 2);
+
+            const size_t firsts[3] = { chunk.firstPosition, chunk.firstNormal, chunk.firstTexcoord };
+            for (const uint32_t slot : chunk.relative)
+                getComponent(chunk.corners[slot / 3], slot % 3) += static_cast<int32_t>(firsts[slot % 3]);
+
+            const size_t counts[3] = { positionCount, normalCount, texcoordCount };
+            for (Corner& corner : chunk.corners)
+            {
+                // Optional components are -1 when missing, positions are always there
+                if (corner.position < 0 || corner.position >= static_cast<int32_t>(counts[0])
+                    || corner.normal < -1 || corner.normal >= static_cast<int32_t>(counts[1])
+                    || corner.texcoord < -1 || corner.texcoord >= static_cast<int32_t>(counts[2]))
+                    throw std::runtime_error("Face index out of range in OBJ file");
+            }
+            std::ranges::copy(chunk.corners, geometry.corners.begin() + chunk.firstCorner);
+
+            // The chunk is done with, its memory can go before the other chunks finish
+            chunk = Chunk{};
+        });
+        return geometry;
+    }
+
+    void ObjParser::parseChunk(Chunk& chunk, MeshCooker::Progress* progress)
+    {
+        std::vector<std::pair<Corner, uint8_t>> polygon{};
+        const char* reported = chunk.begin;
+        const char* it = chunk.begin;
+        while (it < chunk.end)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(it, '\n', chunk.end - it));
+            const char* next = newline == nullptr ? chunk.end : newline + 1;
+            const char* lineEnd = newline == nullptr ? chunk.end : newline;
+            if (lineEnd > it && lineEnd[-1] == '\r') --lineEnd;
+            const char* line = skipSpaces(it, lineEnd);
+            it = next;
+
+            if (isKeyword(line, lineEnd, "v"))
+            {
+                // Up to x y z r g b, a fourth value alone is a w and is dropped
+                float values[6]{};
+                const char* cursor = line + 1;
+                size_t count = 0;
+                while (count < 6 && parseFloat(cursor, lineEnd, values[count])) ++count;
+                if (count < 3)
+                    throw std::runtime_error("Malformed vertex position in OBJ file");
+
+                chunk.positions.insert(chunk.positions.end(), values, values + 3);
+                if (count == 6)
+                    chunk.colors.insert(chunk.colors.end(), values + 3, values + 6);
+                else
+                    chunk.colors.insert(chunk.colors.end(), { 1.0f, 1.0f, 1.0f });
+            }
+            else if (isKeyword(line, lineEnd, "vn"))
+            {
+                float values[3]{};
+                const char* cursor = line + 2;
+                for (float& value : values)
+                {
+                    if (!parseFloat(cursor, lineEnd, value))
+                        throw std::runtime_error("Malformed vertex normal in OBJ file");
+                }
+                chunk.normals.insert(chunk.normals.end(), values, values + 3);
+            }
+            else if (isKeyword(line, lineEnd, "vt"))
+            {
+                // A missing v is taken as 0, like tinyobjloader does
+                float values[2]{};
+                const char* cursor = line + 2;
+                if (!parseFloat(cursor, lineEnd, values[0]))
+                    throw std::runtime_error("Malformed texture coordinate in OBJ file");
+                parseFloat(cursor, lineEnd, values[1]);
+                chunk.texcoords.insert(chunk.texcoords.end(), values, values + 2);
+            }
+            else if (isKeyword(line, lineEnd, "f"))
+            {
+                const int32_t localCounts[3] = {
+                    static_cast<int32_t>(chunk.positions.size() / 3),
+                    static_cast<int32_t>(chunk.normals.size() / 3),
+                    static_cast<int32_t>(chunk.texcoords.size() / 2)
+                };
+
+                polygon.clear();
+                const char* cursor = line + 1;
+                while (true)
+                {
+                    cursor = skipSpaces(cursor, lineEnd);
+                    if (cursor >= lineEnd || *cursor == '#') break;
+
+                    Corner corner{};
+                    uint8_t relative = 0;
+                    // v, v/t, v//n or v/t/n. Positive indices are absolute and one based, negative ones count back
+                    // from the last element read so far
+                    const auto readIndex = [&](const uint32_t component)
+                    {
+                        int32_t value = 0;
+                        if (!parseInt(cursor, lineEnd, value) || value == 0)
+                            throw std::runtime_error("Malformed face in OBJ file");
+                        if (value > 0)
+                        {
+                            getComponent(corner, component) = value - 1;
+                        }
+                        else
+                        {
+                            getComponent(corner, component) = localCounts[component] + value;
+                            relative |= 1 << component;
+                        }
+                    };
+
+                    readIndex(0);
+                    if (cursor < lineEnd && *cursor == '/')
+                    {
+                        ++cursor;
+                        if (cursor < lineEnd && *cursor != '/')
+                            readIndex(2);
+                        if (cursor < lineEnd && *cursor == '/')
+                        {
+                            ++cursor;
+                            readIndex(1);
+                        }
+                    }
+                    polygon.emplace_back(corner, relative);
+                }
+
+                // Fan triangulation
+                for (size_t i = 1; i + 1 < polygon.size(); ++i)
+                {
+                    for (const size_t k : { size_t{ 0 }, i, i + 1 })
+                    {
+                        const auto& [corner, relative] = polygon[k];
+                        for (uint32_t component = 0; component < 3; ++component)
+                        {
+                            if (relative & (1 << component))
+                                chunk.relative.push_back(static_cast<uint32_t>(chunk.corners.size() * 3 + component));
+                        }
+                        chunk.corners.push_back(corner);
+                    }
+                }
+            }
+
+            if (progress != nullptr && static_cast<size_t>(it - reported) >= c_progressInterval)
+            {
+                progress->processedBytes.fetch_add(it - reported, std::memory_order_relaxed);
+                reported = it;
+                // The chunk is left half parsed, parse throws once every chunk has returned
+                if (progress->cancelled.load(std::memory_order_relaxed))
+                    return;
+            }
+        }
+
+        if (progress != nullptr)
+            progress->processedBytes.fetch_add(chunk.end - reported, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,172 @@
+#include "push_constant_layout.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <emmintrin.h>
+
+namespace gflow::parser
+{
+    static uint32_t alignUp(const uint32_t value, const uint32_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Moves up to 16 bytes at a time. Sizes are always a multiple of 4 here
+    static void copyBytes(uint8_t* destination, const uint8_t* source, uint32_t size)
+    {
+        while (size >= 16)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+            destination += 16;
+            source += 16;
+            size -= 16;
+        }
+        if (size >= 8)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+            destination += 8;
+            source += 8;
+            size -= 8;
+        }
+        if (size >= 4)
+            std::memcpy(destination, source, 4);
+    }
+
+    uint32_t PushConstantLayout::getComponentCount(const ElementType type)
+    {
+        switch (type)
+        {
+        case INT:
+        case FLOAT: return 1;
+        case VEC2: return 2;
+        case VEC3: return 3;
+        case VEC4: return 4;
+        case MAT2: return 4;
+        case MAT3: return 9;
+        case MAT4: return 16;
+        }
+        throw std::runtime_error("Unknown push constant element type " + std::to_string(static_cast<uint32_t>(type)));
+    }
+
+    PushConstantLayout PushConstantLayout::compile(const std::vector<Element>& elements, const Rules rules)
+    {
+        PushConstantLayout layout{};
+        layout.m_rules = rules;
+        layout.m_members.reserve(elements.size());
+
+        uint32_t offset = 0;
+        for (const Element& element : elements)
+        {
+            Member& member = layout.m_members.emplace_back();
+            member.name = element.name;
+            member.type = element.type;
+
+            switch (element.type)
+            {
+            case MAT2: member.columns = 2; member.rows = 2; break;
+            case MAT3: member.columns = 3; member.rows = 3; break;
+            case MAT4: member.columns = 4; member.rows = 4; break;
+            default: member.rows = getComponentCount(element.type); break;
+            }
+
+            // std430: scalars align to 4, two component vectors to 8 and three and four component ones to 16. A
+            // matrix is an array of its columns, so columns are strided by their alignment and the padding after the
+            // last one belongs to the matrix. Scalar: everything aligns to 4 and nothing is padded
+            const uint32_t columnAlignment = rules == Rules::SCALAR ? 4 : member.rows == 1 ? 4 : member.rows == 2 ? 8 : 16;
+            member.alignment = columnAlignment;
+            member.columnStride = rules == Rules::SCALAR || member.columns == 1 ? member.rows * 4 : columnAlignment;
+            member.size = member.columns == 1 ? member.rows * 4 : member.columnStride * member.columns;
+            member.offset = alignUp(offset, member.alignment);
+            offset = member.offset + member.size;
+        }
+
+        layout.m_size = alignUp(offset, 4);
+        for (const Member& member : layout.m_members)
+            layout.m_inputSize += member.columns * member.rows * 4;
+        return layout;
+    }
+
+    PushConstantLayout::Validation PushConstantLayout::validate(const uint32_t maxPushConstantsSize, const std::vector<ReflectedMember>& reflected) const
+    {
+        Validation result{};
+        if (m_size > maxPushConstantsSize)
+            result.errors.push_back("Push constant block takes " + std::to_string(m_size) + " bytes, the device allows " + std::to_string(maxPushConstantsSize));
+
+        std::vector<bool> matched(m_members.size(), false);
+        for (const ReflectedMember& shaderMember : reflected)
+        {
+            const Member* member = findMember(shaderMember.name);
+            if (member == nullptr)
+            {
+                result.errors.push_back("Shader member " + shaderMember.name + " has no matching element");
+                continue;
+            }
+            matched[member - m_members.data()] = true;
+            if (member->offset != shaderMember.offset)
+                result.errors.push_back("Element " + member->name + " is at offset " + std::to_string(member->offset) + ", the shader reads it at " + std::to_string(shaderMember.offset));
+            if (member->size != shaderMember.size)
+                result.errors.push_back("Element " + member->name + " takes " + std::to_string(member->size) + " bytes, the shader reads " + std::to_string(shaderMember.size));
+        }
+
+        if (!reflected.empty())
+        {
+            for (size_t i = 0; i < m_members.size(); ++i)
+            {
+                if (!matched[i])
+                    result.warnings.push_back("Element " + m_members[i].name + " is not read by the shader");
+            }
+        }
+        return result;
+    }
+
+    const PushConstantLayout::Member* PushConstantLayout::findMember(const std::string_view name) const
+    {
+        const auto it = std::ranges::find(m_members, name, &Member::name);
+        return it == m_members.end() ? nullptr : &*it;
+    }
+
+    PushConstantPacker::PushConstantPacker(const PushConstantLayout& layout)
+    {
+        m_block.resize(layout.getSize());
+        uint32_t source = 0;
+        for (const PushConstantLayout::Member& member : layout.getMembers())
+        {
+            m_firstMemberCopy.push_back(static_cast<uint32_t>(m_memberCopies.size()));
+
+            // Columns with no padding after them are a single copy
+            const uint32_t columnSize = member.rows * 4;
+            const bool tight = member.columnStride == columnSize;
+            for (uint32_t column = 0; column < (tight ? 1 : member.columns); ++column)
+            {
+                const uint32_t size = tight ? columnSize * member.columns : columnSize;
+                m_memberCopies.push_back({ column * columnSize, member.offset + column * member.columnStride, size });
+
+                Copy copy{ source + column * columnSize, member.offset + column * member.columnStride, size };
+                if (!m_copies.empty() && m_copies.back().source + m_copies.back().size == copy.source && m_copies.back().destination + m_copies.back().size == copy.destination)
+                    m_copies.back().size += copy.size;
+                else
+                    m_copies.push_back(copy);
+            }
+            source += columnSize * member.columns;
+        }
+        m_firstMemberCopy.push_back(static_cast<uint32_t>(m_memberCopies.size()));
+    }
+
+    void PushConstantPacker::pack(const void* values)
+    {
+        const uint8_t* source = static_cast<const uint8_t*>(values);
+        for (const Copy& copy : m_copies)
+            copyBytes(m_block.data() + copy.destination, source + copy.source, copy.size);
+    }
+
+    void PushConstantPacker::set(const uint32_t member, const void* values)
+    {
+        if (member + 1 >= m_firstMemberCopy.size())
+            throw std::runtime_error("Push constant member " + std::to_string(member) + " out of range");
+
+        const uint8_t* source = static_cast<const uint8_t*>(values);
+        for (uint32_t i = m_firstMemberCopy[member]; i < m_firstMemberCopy[member + 1]; ++i)
+            copyBytes(m_block.data() + m_memberCopies[i].destination, source + m_memberCopies[i].source, m_memberCopies[i].size);
+    }
+}
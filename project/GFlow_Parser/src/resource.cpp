@@ -1,7 +1,9 @@
 #include "resource.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <random>
 
 #include "resources/project.hpp"
 #include "resource_manager.hpp"
@@ -291,7 +293,7 @@ namespace gflow::parser
             }
             case ENUM_BITMASK:
             case ENUM:
-                static_cast<EnumExport*>(exportData.data)->id = std::stoi(value);
+                static_cast<EnumExport*>(exportData.data)->id = static_cast<uint32_t>(std::stoul(value));
                 break;
             case RESOURCE:
             {
@@ -340,6 +342,7 @@ namespace gflow::parser
                 Logger::print(Logger::ERR, "Export type not supported for export ", variable);
                 return false;
             }
+            markChanged();
             exportChanged(variable);
             return true;
         }
@@ -358,6 +361,7 @@ namespace gflow::parser
                     if (*resource == nullptr)
                     {
                         *resource = ResourceManager::createResource("", exp.resourceFactory, &exp);
+                        markChanged();
                         exportChanged(name);
                     }
                 }
@@ -401,9 +405,13 @@ namespace gflow::parser
 
     void Resource::setID(const uint32_t id)
     {
+        // rand() stops at 32767 on MSVC, which large workspaces run out of. Ids are parsed back with stoi, so they
+        // stay within the positive int range
+        static std::mt19937 generator{ std::random_device{}() };
+        static std::uniform_int_distribution<uint32_t> distribution{ 1, INT32_MAX };
         m_id = id;
         while (m_id == 0 || s_ids.contains(m_id))
-            m_id = rand();
+            m_id = distribution(generator);
         s_ids.insert(m_id);
     }
 
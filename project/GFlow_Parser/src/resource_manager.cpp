@@ -4,6 +4,7 @@
 #include <fstream>
 #include <ranges>
 
+#include "profiler.hpp"
 #include "resources/project.hpp"
 #include "string_helper.hpp"
 #include "resources/renderpass.hpp"
@@ -77,16 +78,19 @@ namespace gflow::parser
     void FileTree::addPath(const std::string& path)
     {
         root.addPath(path);
+        m_revision++;
     }
 
     void FileTree::removePath(const std::string& path)
     {
         root.removePath(path);
+        m_revision++;
     }
 
     void FileTree::deletePath(const std::string& path, const std::string& workingDir)
     {
         root.removePath(path);
+        m_revision++;
 
         if (!std::filesystem::exists(workingDir + path))
             std::filesystem::remove_all(workingDir + path);
@@ -95,6 +99,7 @@ namespace gflow::parser
     void FileTree::renamePath(const std::string& path, const std::string& newName)
     {
         root.renamePath(path, newName);
+        m_revision++;
     }
 
     void FileTree::FileDirectory::removePath(const std::string& path)
@@ -174,6 +179,7 @@ namespace gflow::parser
     void FileTree::reset()
     {
         root = FileDirectory(root.name);
+        m_revision++;
     }
     
     bool ResourceManager::hasResource(const std::string& path)
@@ -234,6 +240,7 @@ namespace gflow::parser
     {
         for (Resource* resource : m_resources | std::views::values)
         {
+            GFLOW_PROFILE_ZONE("Serialize");
             resource->serialize();
         }
     }
@@ -291,6 +298,7 @@ namespace gflow::parser
 
     Resource* ResourceManager::loadResource(const std::string& path)
     {
+        GFLOW_PROFILE_ZONE("Resource load");
         if (m_resources.contains(path))
             return m_resources[path];
 
@@ -459,7 +467,7 @@ namespace gflow::parser
 
     void ResourceManager::obtainResources(const std::string& current)
     {
-        Logger::pushContext("Populate filesystem");
+        Profiler::pushContext("Populate filesystem");
         for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(current))
         {
             std::string path = std::filesystem::relative(entry.path(), ResourceManager::getWorkingDir()).generic_string();
@@ -479,6 +487,6 @@ namespace gflow::parser
 
             }
         }
-        Logger::popContext();
+        Profiler::popContext();
     }
 }
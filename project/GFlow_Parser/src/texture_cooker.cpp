@@ -0,0 +1,469 @@
+#include "texture_cooker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <emmintrin.h>
+#include <Volk/volk.h>
+
+#include "cook_cache.hpp"
+#include "worker_pool.hpp"
+#include "utils/logger.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace gflow::parser
+{
+    static float srgbToLinear(const float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float linearToSrgb(const float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // 8 bit sRGB encoding through a table, pow per channel dominates encoding otherwise. 16 bits of linear input keep
+    // the dark end, where the curve is steepest, exact to the byte
+    static uint8_t encodeSrgb8(const float value)
+    {
+        static const std::vector<uint8_t> table = []()
+        {
+            std::vector<uint8_t> result(65536);
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = static_cast<uint8_t>(std::lround(linearToSrgb(static_cast<float>(i) / 65535.0f) * 255.0f));
+            return result;
+        }();
+        return table[static_cast<size_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f)];
+    }
+
+    static uint8_t encodeUnorm8(const float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    static uint16_t encodeHalf(const float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        const uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (((bits >> 23) & 0xFF) == 0xFF)
+            return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+        if (exponent >= 31)
+            return static_cast<uint16_t>(sign | 0x7C00);
+        if (exponent <= 0)
+        {
+            if (exponent < -10) return static_cast<uint16_t>(sign);
+            const uint32_t full = mantissa | 0x800000;
+            const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            return static_cast<uint16_t>(sign | ((full + (1U << (shift - 1))) >> shift));
+        }
+        // Rounding can carry into the exponent, which is still the correctly rounded result
+        return static_cast<uint16_t>((sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1));
+    }
+
+    static double besselI0(const double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) break;
+        }
+        return sum;
+    }
+
+    // Source texels and weights that make up one destination texel along one axis
+    struct Taps
+    {
+        uint32_t first = 0;
+        std::vector<float> weights{};
+    };
+
+    static std::vector<Taps> computeTaps(const uint32_t sourceSize, const uint32_t targetSize, const TextureCooker::Filter filter, const float kaiserRadius, const float kaiserAlpha)
+    {
+        const double scale = static_cast<double>(sourceSize) / targetSize;
+        const double support = filter == TextureCooker::BOX ? 0.5 * scale : kaiserRadius * scale;
+        const double windowNormalization = besselI0(kaiserAlpha);
+
+        std::vector<Taps> result(targetSize);
+        for (uint32_t target = 0; target < targetSize; ++target)
+        {
+            const double center = (target + 0.5) * scale;
+            const int64_t low = static_cast<int64_t>(std::floor(center - support));
+            const int64_t high = static_cast<int64_t>(std::ceil(center + support));
+
+            // Taps past the edges are clamped onto the edge texels
+            Taps& taps = result[target];
+            taps.first = static_cast<uint32_t>(std::clamp<int64_t>(low, 0, sourceSize - 1));
+            const uint32_t last = static_cast<uint32_t>(std::clamp<int64_t>(high - 1, 0, sourceSize - 1));
+            taps.weights.assign(last - taps.first + 1, 0.0f);
+
+            double total = 0.0;
+            for (int64_t source = low; source < high; ++source)
+            {
+                double weight;
+                if (filter == TextureCooker::BOX)
+                {
+                    weight = std::max(0.0, std::min<double>(source + 1, center + support) - std::max<double>(source, center - support));
+                }
+                else
+                {
+                    const double x = (source + 0.5 - center) / scale;
+                    if (std::abs(x) >= kaiserRadius) continue;
+                    const double sinc = x == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * x) / (3.14159265358979323846 * x);
+                    const double ratio = x / kaiserRadius;
+                    weight = sinc * besselI0(kaiserAlpha * std::sqrt(1.0 - ratio * ratio)) / windowNormalization;
+                }
+                taps.weights[std::clamp<int64_t>(source, 0, sourceSize - 1) - taps.first] += static_cast<float>(weight);
+                total += weight;
+            }
+            for (float& weight : taps.weights)
+                weight = static_cast<float>(weight / total);
+        }
+        return result;
+    }
+
+    bool TextureCooker::isFormatSupported(const uint32_t format)
+    {
+        return getTexelSize(format) != 0;
+    }
+
+    uint32_t TextureCooker::getTexelSize(const uint32_t format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_SRGB:
+            return 1;
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R8G8_SRGB:
+            return 2;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R32_SFLOAT:
+            return 4;
+        case VK_FORMAT_R16G16B16A16_UNORM:
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return 8;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t TextureCooker::getDefaultFormat(const bool linearSource)
+    {
+        return linearSource ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    bool TextureCooker::isImageFile(const std::string& path)
+    {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::ranges::transform(extension, extension.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        static const std::array<const char*, 9> c_extensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr", ".pic" };
+        return std::ranges::any_of(c_extensions, [&](const char* candidate) { return extension == candidate; });
+    }
+
+    TextureCooker::Image TextureCooker::decode(const std::string& path, const bool linearSource)
+    {
+        int width = 0, height = 0, channels = 0;
+        Image image{};
+        const auto fill = [&](const auto* data, const float scale)
+        {
+            if (data == nullptr)
+                throw std::runtime_error("Failed to decode image " + path + ": " + stbi_failure_reason());
+            image.width = static_cast<uint32_t>(width);
+            image.height = static_cast<uint32_t>(height);
+            image.texels.resize(static_cast<size_t>(width) * height * 4);
+            for (size_t i = 0; i < image.texels.size(); ++i)
+                image.texels[i] = static_cast<float>(data[i]) * scale;
+            stbi_image_free(const_cast<void*>(static_cast<const void*>(data)));
+        };
+
+        // HDR files are linear already, everything else is 8 or 16 bit encoded
+        if (stbi_is_hdr(path.c_str()))
+        {
+            fill(stbi_loadf(path.c_str(), &width, &height, &channels, 4), 1.0f);
+            return image;
+        }
+        const bool is16Bit = stbi_is_16_bit(path.c_str());
+        if (is16Bit)
+            fill(stbi_load_16(path.c_str(), &width, &height, &channels, 4), 1.0f / 65535.0f);
+        else
+            fill(stbi_load(path.c_str(), &width, &height, &channels, 4), 1.0f / 255.0f);
+
+        if (!linearSource)
+        {
+            static const std::vector<float> table = []()
+            {
+                std::vector<float> result(256);
+                for (size_t i = 0; i < result.size(); ++i)
+                    result[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+                return result;
+            }();
+            for (size_t i = 0; i < image.texels.size(); ++i)
+            {
+                // Alpha is always linear
+                if (i % 4 == 3) continue;
+                image.texels[i] = !is16Bit ? table[static_cast<size_t>(image.texels[i] * 255.0f + 0.5f)] : srgbToLinear(image.texels[i]);
+            }
+        }
+        return image;
+    }
+
+    TextureCooker::Image TextureCooker::downsample(const Image& image, const Filter filter)
+    {
+        Image result{};
+        result.width = std::max(image.width / 2, 1U);
+        result.height = std::max(image.height / 2, 1U);
+        result.texels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+        // Even sizes under a box filter are a plain 2x2 average
+        if (filter == BOX && image.width % 2 == 0 && image.height % 2 == 0)
+        {
+            const __m128 quarter = _mm_set1_ps(0.25f);
+            for (uint32_t y = 0; y < result.height; ++y)
+            {
+                for (uint32_t x = 0; x < result.width; ++x)
+                {
+                    __m128 sum = _mm_add_ps(_mm_loadu_ps(image.at(x * 2, y * 2)), _mm_loadu_ps(image.at(x * 2 + 1, y * 2)));
+                    sum = _mm_add_ps(sum, _mm_add_ps(_mm_loadu_ps(image.at(x * 2, y * 2 + 1)), _mm_loadu_ps(image.at(x * 2 + 1, y * 2 + 1))));
+                    _mm_storeu_ps(result.at(x, y), _mm_mul_ps(sum, quarter));
+                }
+            }
+            return result;
+        }
+
+        // Separable, rows first into an intermediate that has the target width and the source height
+        const std::vector<Taps> horizontal = computeTaps(image.width, result.width, filter, c_kaiserRadius, c_kaiserAlpha);
+        const std::vector<Taps> vertical = computeTaps(image.height, result.height, filter, c_kaiserRadius, c_kaiserAlpha);
+
+        Image rows{ result.width, image.height };
+        rows.texels.resize(static_cast<size_t>(rows.width) * rows.height * 4);
+        for (uint32_t y = 0; y < image.height; ++y)
+        {
+            for (uint32_t x = 0; x < result.width; ++x)
+            {
+                const Taps& taps = horizontal[x];
+                __m128 sum = _mm_setzero_ps();
+                for (uint32_t k = 0; k < taps.weights.size(); ++k)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(image.at(taps.first + k, y)), _mm_set1_ps(taps.weights[k])));
+                _mm_storeu_ps(rows.at(x, y), sum);
+            }
+        }
+
+        // Whole rows are accumulated at once, so the inner loop walks memory linearly
+        for (uint32_t y = 0; y < result.height; ++y)
+        {
+            const Taps& taps = vertical[y];
+            float* target = result.at(0, y);
+            for (uint32_t k = 0; k < taps.weights.size(); ++k)
+            {
+                const __m128 weight = _mm_set1_ps(taps.weights[k]);
+                const float* source = rows.at(0, taps.first + k);
+                for (uint32_t x = 0; x < result.width; ++x)
+                    _mm_storeu_ps(target + x * 4, _mm_add_ps(_mm_loadu_ps(target + x * 4), _mm_mul_ps(_mm_loadu_ps(source + x * 4), weight)));
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint8_t> TextureCooker::encode(const Image& image, const uint32_t format)
+    {
+        const uint32_t texelSize = getTexelSize(format);
+        if (texelSize == 0)
+            throw std::runtime_error("Texture format " + std::to_string(format) + " can't be cooked");
+
+        const bool srgb = format == VK_FORMAT_R8_SRGB || format == VK_FORMAT_R8G8_SRGB || format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+        const size_t texelCount = static_cast<size_t>(image.width) * image.height;
+        std::vector<uint8_t> result(texelCount * texelSize);
+        for (size_t i = 0; i < texelCount; ++i)
+        {
+            const float* texel = &image.texels[i * 4];
+            uint8_t* out = &result[i * texelSize];
+            switch (format)
+            {
+            case VK_FORMAT_R8_UNORM:
+            case VK_FORMAT_R8_SRGB:
+            case VK_FORMAT_R8G8_UNORM:
+            case VK_FORMAT_R8G8_SRGB:
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                for (uint32_t c = 0; c < texelSize; ++c)
+                    out[c] = srgb && c < 3 ? encodeSrgb8(texel[c]) : encodeUnorm8(texel[c]);
+                break;
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint32_t source = c == 3 ? 3 : 2 - c;
+                    out[c] = srgb && c < 3 ? encodeSrgb8(texel[source]) : encodeUnorm8(texel[source]);
+                }
+                break;
+            case VK_FORMAT_R16G16B16A16_UNORM:
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint16_t value = static_cast<uint16_t>(std::clamp(texel[c], 0.0f, 1.0f) * 65535.0f + 0.5f);
+                    std::memcpy(out + c * 2, &value, sizeof(value));
+                }
+                break;
+            case VK_FORMAT_R16G16B16A16_SFLOAT:
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint16_t value = encodeHalf(texel[c]);
+                    std::memcpy(out + c * 2, &value, sizeof(value));
+                }
+                break;
+            default:
+                std::memcpy(out, texel, texelSize);
+                break;
+            }
+        }
+        return result;
+    }
+
+    bool TextureCooker::write(const std::vector<Image>& mips, const Settings& settings, const uint64_t sourceHash, const std::string& path)
+    {
+        Header header{};
+        header.sourceHash = sourceHash;
+        header.format = settings.format;
+        header.width = mips.front().width;
+        header.height = mips.front().height;
+        header.mipCount = static_cast<uint32_t>(mips.size());
+        header.texelSize = getTexelSize(settings.format);
+        header.filter = settings.filter;
+        header.mipOffset = (sizeof(Header) + 15) & ~15ULL;
+
+        std::vector<Mip> table(mips.size());
+        uint64_t offset = (header.mipOffset + table.size() * sizeof(Mip) + 15) & ~15ULL;
+        for (size_t i = 0; i < mips.size(); ++i)
+        {
+            table[i] = { offset, static_cast<uint64_t>(mips[i].width) * mips[i].height * header.texelSize, mips[i].width, mips[i].height };
+            offset = (offset + table[i].size + 15) & ~15ULL;
+        }
+
+        // Written next to the destination and moved over it, so a cache entry is never seen half written
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                Logger::print(Logger::ERR, "Failed to open cooked texture output file: ", tempPath);
+                return false;
+            }
+
+            const char padding[16]{};
+            uint64_t written = 0;
+            const auto writeAt = [&](const uint64_t position, const void* data, const size_t size)
+            {
+                file.write(padding, static_cast<std::streamsize>(position - written));
+                file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                written = position + size;
+            };
+            writeAt(0, &header, sizeof(Header));
+            writeAt(header.mipOffset, table.data(), table.size() * sizeof(Mip));
+            for (size_t i = 0; i < mips.size(); ++i)
+            {
+                const std::vector<uint8_t> data = encode(mips[i], settings.format);
+                writeAt(table[i].offset, data.data(), data.size());
+            }
+            if (!file.good()) return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        return !error;
+    }
+
+    std::string TextureCooker::cook(const std::string& sourcePath, const Settings& settings, const std::string& cacheDirectory)
+    {
+        if (!isFormatSupported(settings.format))
+            throw std::runtime_error("Texture format " + std::to_string(settings.format) + " can't be cooked");
+
+        const uint64_t sourceHash = CookCache::hashFile(sourcePath);
+        const uint32_t parameters[4] = { settings.format, settings.filter, settings.linearSource, settings.generateMips };
+        uint64_t key = CookCache::hash(parameters, sizeof(parameters), sourceHash);
+        key = CookCache::hash(&c_version, sizeof(c_version), key);
+        const std::string path = CookCache::getEntryPath(cacheDirectory, key, ".gftex");
+
+        CookedTexture cached{};
+        if (cached.open(path) && cached.getHeader().sourceHash == sourceHash && cached.getHeader().format == settings.format)
+            return path;
+
+        std::vector<Image> mips{};
+        mips.push_back(decode(sourcePath, settings.linearSource));
+        while (settings.generateMips && (mips.back().width > 1 || mips.back().height > 1))
+            mips.push_back(downsample(mips.back(), settings.filter));
+
+        std::filesystem::create_directories(cacheDirectory);
+        if (!write(mips, settings, sourceHash, path))
+            throw std::runtime_error("Failed to write cooked texture " + path);
+
+        Logger::print(Logger::INFO, "Cooked ", sourcePath, ": ", mips.front().width, "x", mips.front().height, ", ", mips.size(), " mips");
+        return path;
+    }
+
+    std::vector<std::string> TextureCooker::cookDirectory(const std::string& directory, const Settings& settings, const std::string& cacheDirectory, const uint32_t threadCount)
+    {
+        std::vector<std::string> sources{};
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && isImageFile(entry.path().string()))
+                sources.push_back(entry.path().generic_string());
+        }
+        // Directory iteration order is unspecified, results come back in a stable one
+        std::ranges::sort(sources);
+
+        std::vector<std::string> results(sources.size());
+        const uint32_t threads = threadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1U) : threadCount;
+        WorkerPool workers{ static_cast<uint32_t>(std::min<size_t>(threads, sources.size())) };
+        workers.parallelFor(static_cast<uint32_t>(sources.size()), [&](const uint32_t i, uint32_t)
+        {
+            try
+            {
+                results[i] = cook(sources[i], settings, cacheDirectory);
+            }
+            catch (const std::exception& e)
+            {
+                Logger::print(Logger::ERR, e.what());
+            }
+        });
+        std::erase_if(results, [](const std::string& result) { return result.empty(); });
+        return results;
+    }
+
+    bool CookedTexture::open(const std::string& path)
+    {
+        if (!m_file.open(path)) return false;
+
+        // Anything that doesn't look like a complete file of the current version is treated as missing
+        if (m_file.size() < sizeof(TextureCooker::Header))
+        {
+            m_file.close();
+            return false;
+        }
+        const TextureCooker::Header& header = getHeader();
+        bool valid = header.magic == TextureCooker::c_magic && header.version == TextureCooker::c_version
+            && header.mipCount > 0 && header.mipOffset + header.mipCount * sizeof(TextureCooker::Mip) <= m_file.size();
+        for (uint32_t i = 0; valid && i < header.mipCount; ++i)
+            valid = getMip(i).offset + getMip(i).size <= m_file.size();
+        if (!valid)
+            m_file.close();
+        return valid;
+    }
+}
@@ -0,0 +1,174 @@
+#include <stdexcept>
+#include <vector>
+
+#include "barrier_solver.hpp"
+#include "tests.hpp"
+
+using gflow::BarrierSolver;
+
+struct ImageUse
+{
+    VkImage image = VK_NULL_HANDLE;
+    VkPipelineStageFlags stages = 0;
+    VkAccessFlags access = 0;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    bool discard = false;
+};
+
+// The solver never touches the handles, any distinct non zero value stands for an image
+static VkImage makeImage(const uint64_t id)
+{
+    return (VkImage)id;
+}
+
+static ImageUse colorWrite(const VkImage image, const bool discard = false)
+{
+    return { image, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, discard };
+}
+
+static ImageUse fragmentRead(const VkImage image)
+{
+    return { image, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+}
+
+// Hands the uses of every pass to the solver in order and keeps the batch each pass boundary resolved to
+static std::vector<BarrierSolver::Batch> solvePasses(BarrierSolver& solver, const std::vector<std::vector<ImageUse>>& passes)
+{
+    std::vector<BarrierSolver::Batch> batches{};
+    for (const std::vector<ImageUse>& pass : passes)
+    {
+        for (const ImageUse& use : pass)
+            solver.useImage(use.image, VK_IMAGE_ASPECT_COLOR_BIT, use.stages, use.access, use.layout, use.discard);
+        batches.push_back(solver.resolve());
+    }
+    return batches;
+}
+
+static const VkImageMemoryBarrier* findBarrier(const BarrierSolver::Batch& batch, const VkImage image)
+{
+    for (const VkImageMemoryBarrier& barrier : batch.images)
+    {
+        if (barrier.image == image)
+            return &barrier;
+    }
+    return nullptr;
+}
+
+TEST(barrierSolverLayoutTransitions)
+{
+    BarrierSolver solver{};
+    const VkImage gbuffer = makeImage(1);
+    const VkImage lighting = makeImage(2);
+
+    const std::vector<BarrierSolver::Batch> batches = solvePasses(solver, {
+        { colorWrite(gbuffer) },
+        { fragmentRead(gbuffer), colorWrite(lighting) },
+        { fragmentRead(lighting) },
+    });
+    CHECK(batches.size() == 3);
+
+    // First use, nothing to wait on
+    CHECK(batches[0].images.size() == 1);
+    const VkImageMemoryBarrier* first = findBarrier(batches[0], gbuffer);
+    CHECK(first != nullptr);
+    if (first != nullptr)
+    {
+        CHECK(first->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+        CHECK(first->newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        CHECK(first->srcAccessMask == 0);
+        CHECK(first->dstAccessMask == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+        CHECK(first->subresourceRange.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+    CHECK(batches[0].srcStages == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+    // Both images of the second pass share a single batch
+    CHECK(batches[1].images.size() == 2);
+    const VkImageMemoryBarrier* sampled = findBarrier(batches[1], gbuffer);
+    CHECK(sampled != nullptr);
+    if (sampled != nullptr)
+    {
+        CHECK(sampled->oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        CHECK(sampled->newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        CHECK(sampled->srcAccessMask == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+        CHECK(sampled->dstAccessMask == VK_ACCESS_SHADER_READ_BIT);
+    }
+    const VkImageMemoryBarrier* target = findBarrier(batches[1], lighting);
+    CHECK(target != nullptr && target->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+    CHECK(batches[1].srcStages == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    CHECK(batches[1].dstStages == (VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT));
+
+    CHECK(batches[2].images.size() == 1 && findBarrier(batches[2], lighting) != nullptr);
+    CHECK(solver.getLayout(gbuffer) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    CHECK(solver.getFrameStats().batches == 3);
+    CHECK(solver.getFrameStats().layoutTransitions == 4);
+}
+
+TEST(barrierSolverDiscard)
+{
+    BarrierSolver solver{};
+    const VkImage discarded = makeImage(1);
+    const VkImage kept = makeImage(2);
+
+    const std::vector<BarrierSolver::Batch> batches = solvePasses(solver, {
+        { colorWrite(discarded), colorWrite(kept) },
+        { fragmentRead(discarded), fragmentRead(kept) },
+        { colorWrite(discarded, true), colorWrite(kept) },
+    });
+
+    // Overwritten without caring about the old contents, the transition starts from UNDEFINED. It still has to wait
+    // for the reads of the previous pass, which only needs an execution dependency
+    const VkImageMemoryBarrier* overwrite = findBarrier(batches[2], discarded);
+    CHECK(overwrite != nullptr);
+    if (overwrite != nullptr)
+    {
+        CHECK(overwrite->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+        CHECK(overwrite->newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        CHECK(overwrite->srcAccessMask == 0);
+    }
+    const VkImageMemoryBarrier* preserved = findBarrier(batches[2], kept);
+    CHECK(preserved != nullptr && preserved->oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    CHECK(batches[2].srcStages == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+}
+
+TEST(barrierSolverReadAfterRead)
+{
+    BarrierSolver solver{};
+    const VkImage image = makeImage(1);
+    const VkBuffer buffer = (VkBuffer)uint64_t{ 2 };
+
+    const std::vector<BarrierSolver::Batch> batches = solvePasses(solver, {
+        { colorWrite(image) },
+        { fragmentRead(image) },
+        { fragmentRead(image) },
+    });
+    CHECK(!batches[1].empty());
+    // The write is already visible to the fragment shader
+    CHECK(batches[2].empty());
+
+    solver.useBuffer(buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    CHECK(solver.resolve().empty());
+    solver.useBuffer(buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    const BarrierSolver::Batch upload = solver.resolve();
+    CHECK(upload.srcStages == VK_PIPELINE_STAGE_TRANSFER_BIT);
+    CHECK(upload.buffers.size() == 1 && upload.buffers[0].srcAccessMask == VK_ACCESS_TRANSFER_WRITE_BIT);
+    solver.useBuffer(buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    CHECK(solver.resolve().empty());
+}
+
+TEST(barrierSolverConflictingLayouts)
+{
+    BarrierSolver solver{};
+    const VkImage image = makeImage(1);
+    solver.useImage(image, VK_IMAGE_ASPECT_COLOR_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    bool threw = false;
+    try
+    {
+        solver.useImage(image, VK_IMAGE_ASPECT_COLOR_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
@@ -0,0 +1,85 @@
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "descriptor_allocator.hpp"
+#include "tests.hpp"
+
+using gflow::DescriptorAllocator;
+
+static uint32_t countOf(const std::vector<VkDescriptorPoolSize>& sizes, const VkDescriptorType type)
+{
+    for (const VkDescriptorPoolSize& size : sizes)
+    {
+        if (size.type == type)
+            return size.descriptorCount;
+    }
+    return 0;
+}
+
+TEST(descriptorPoolSizingFirstPool)
+{
+    // Nothing handed out yet, the pool is sized as if every set looked like the one waiting on it
+    std::array<uint32_t, DescriptorAllocator::c_typeCount> requested{};
+    requested[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER] = 2;
+    requested[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER] = 1;
+
+    const std::vector<VkDescriptorPoolSize> sizes = DescriptorAllocator::getPoolSizes({}, 0, requested, 64);
+    CHECK(sizes.size() == 2);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) == 128);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) == 64);
+}
+
+TEST(descriptorPoolSizingFromHistory)
+{
+    // 10 sets took 30 uniform buffers and 5 samplers between them
+    std::array<uint64_t, DescriptorAllocator::c_typeCount> descriptors{};
+    descriptors[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER] = 30;
+    descriptors[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER] = 5;
+    std::array<uint32_t, DescriptorAllocator::c_typeCount> requested{};
+    requested[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER] = 4;
+
+    const std::vector<VkDescriptorPoolSize> sizes = DescriptorAllocator::getPoolSizes(descriptors, 10, requested, 64);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) == 192);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) == 32);
+    // A type never seen before still fits the set that asked for it
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) == 4);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE) == 0);
+
+    // Averages round up, 1 descriptor over 3 sets is still one per set
+    descriptors = {};
+    descriptors[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER] = 1;
+    CHECK(countOf(DescriptorAllocator::getPoolSizes(descriptors, 3, {}, 3), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) == 1);
+}
+
+TEST(descriptorPoolSizingEmptySets)
+{
+    const std::vector<VkDescriptorPoolSize> sizes = DescriptorAllocator::getPoolSizes({}, 0, {}, 64);
+    CHECK(sizes.size() == 1);
+    CHECK(countOf(sizes, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) == 1);
+}
+
+TEST(descriptorMergeStages)
+{
+    using Binding = DescriptorAllocator::Binding;
+    const std::vector<Binding> merged = DescriptorAllocator::mergeStages({
+        { { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT } },
+        { { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT }, { 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT } },
+    });
+    CHECK(merged.size() == 2);
+    CHECK(merged.size() == 2 && merged[0].stages == (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+
+    bool threw = false;
+    try
+    {
+        (void)DescriptorAllocator::mergeStages({
+            { { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT } },
+            { { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT } },
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
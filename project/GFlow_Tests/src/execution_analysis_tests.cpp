@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "resource_manager.hpp"
+#include "metaresources/execution.hpp"
+#include "metaresources/execution_analysis.hpp"
+#include "tests.hpp"
+
+// Execution graph built by hand, nodes are added under the given IDs and linked pin 0 to pin 0
+class TestGraph
+{
+public:
+    TestGraph() : m_graph(gflow::parser::ResourceManager::createResource<ExecutionResource>("")) {}
+
+    template <typename T>
+    T* add(const size_t id)
+    {
+        T* node = m_graph->addNode<T>();
+        node->setNodeID(id);
+        return node;
+    }
+
+    void addImage(const size_t id, const std::string& imageID)
+    {
+        add<ImageNodeResource>(id)->set("imageID", imageID);
+    }
+
+    void link(const size_t from, const size_t to)
+    {
+        m_graph->addConnection(from, 0, to, 0);
+        m_links.emplace_back(from, to);
+    }
+
+    [[nodiscard]] ExecutionAnalysis::Result analyze() const { return ExecutionAnalysis::analyze(*m_graph); }
+    [[nodiscard]] const std::vector<std::pair<size_t, size_t>>& getLinks() const { return m_links; }
+
+private:
+    ExecutionResource* m_graph;
+    std::vector<std::pair<size_t, size_t>> m_links{};
+};
+
+// Init, then three render passes. The first and last draw to the same image, the middle one to another
+static void buildThreePasses(TestGraph& graph)
+{
+    graph.add<InitNodeResource>(1);
+    graph.add<BeginExecutionNodeResource>(2);
+    graph.add<DrawCallNodeResource>(3);
+    graph.add<EndExecutionNodeResource>(4);
+    graph.add<BeginExecutionNodeResource>(5);
+    graph.add<EndExecutionNodeResource>(6);
+    graph.add<BeginExecutionNodeResource>(7);
+    graph.add<EndExecutionNodeResource>(8);
+    for (size_t id = 1; id < 8; ++id)
+        graph.link(id, id + 1);
+
+    graph.addImage(10, "albedo");
+    graph.addImage(11, "shadow");
+    graph.addImage(12, "albedo");
+    graph.link(10, 2);
+    graph.link(11, 5);
+    graph.link(12, 7);
+}
+
+template <typename T>
+static std::vector<T> sorted(std::vector<T> values)
+{
+    std::ranges::sort(values);
+    return values;
+}
+
+TEST(executionAnalysisOrderAndCycles)
+{
+    TestGraph graph{};
+    buildThreePasses(graph);
+    // Two nodes linked to each other, cut off from the execution, and a data node linked to nothing
+    graph.add<NextExecutionNodeResource>(20);
+    graph.add<NextExecutionNodeResource>(21);
+    graph.link(20, 21);
+    graph.link(21, 20);
+    graph.addImage(22, "unused");
+
+    const ExecutionAnalysis::Result result = graph.analyze();
+
+    CHECK(result.order.size() == 14);
+    std::unordered_map<size_t, size_t> position{};
+    for (size_t i = 0; i < result.order.size(); ++i)
+        position[result.order[i]] = i;
+    for (const auto& [from, to] : graph.getLinks())
+    {
+        if (from < 20)
+            CHECK(position[from] < position[to]);
+    }
+
+    CHECK(result.cycles.size() == 1);
+    CHECK(result.cycles.size() == 1 && sorted(result.cycles[0]) == std::vector<size_t>({ 20, 21 }));
+    CHECK(!result.chainLoops);
+}
+
+TEST(executionAnalysisReachability)
+{
+    TestGraph graph{};
+    buildThreePasses(graph);
+    graph.add<NextExecutionNodeResource>(20);
+    graph.add<NextExecutionNodeResource>(21);
+    graph.link(20, 21);
+    graph.addImage(22, "unused");
+    // Data feeding a node that is not in the chain is not reached either
+    graph.addImage(23, "albedo");
+    graph.link(23, 20);
+
+    const ExecutionAnalysis::Result result = graph.analyze();
+
+    CHECK(sorted(result.unreachable) == std::vector<size_t>({ 20, 21, 22, 23 }));
+    CHECK(result.renderpasses == std::vector<size_t>({ 2, 5, 7 }));
+    const auto diagnostics = result.diagnostics.find(22);
+    CHECK(diagnostics != result.diagnostics.end() && diagnostics->second.size() == 1 && diagnostics->second[0].severity == NodeDiagnostic::WARN);
+    CHECK(!result.diagnostics.contains(3));
+}
+
+TEST(executionAnalysisParallelGroups)
+{
+    TestGraph graph{};
+    buildThreePasses(graph);
+
+    const ExecutionAnalysis::Result result = graph.analyze();
+
+    // The shadow pass shares nothing with the first one, the last one has to wait for the first
+    CHECK(result.parallelGroups.size() == 2);
+    CHECK(result.parallelGroups.size() == 2 && result.parallelGroups[0] == std::vector<uint32_t>({ 0, 1 }));
+    CHECK(result.parallelGroups.size() == 2 && result.parallelGroups[1] == std::vector<uint32_t>({ 2 }));
+}
+
+TEST(executionAnalysisChainLoop)
+{
+    TestGraph graph{};
+    buildThreePasses(graph);
+    // The last End leads back into the first render pass
+    graph.link(8, 3);
+
+    const ExecutionAnalysis::Result result = graph.analyze();
+
+    CHECK(result.chainLoops);
+    CHECK(result.cycles.size() == 1);
+    CHECK(result.cycles.size() == 1 && sorted(result.cycles[0]) == std::vector<size_t>({ 3, 4, 5, 6, 7, 8 }));
+    CHECK(result.unreachable.empty());
+    const auto diagnostics = result.diagnostics.find(3);
+    CHECK(diagnostics != result.diagnostics.end() && std::ranges::any_of(diagnostics->second, [](const NodeDiagnostic& diagnostic) { return diagnostic.severity == NodeDiagnostic::ERR; }));
+}
@@ -0,0 +1,8 @@
+#include "tests.hpp"
+
+// Usage: GFlow_Tests [filter]
+// CPU only, nothing here needs a Vulkan device. Exits with the number of failed tests
+int main(const int argc, char* argv[])
+{
+    return static_cast<int>(Tests::run(argc > 1 ? argv[1] : ""));
+}
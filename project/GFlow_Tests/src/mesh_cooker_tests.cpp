@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mesh_cooker.hpp"
+#include "obj_parser.hpp"
+#include "tests.hpp"
+
+using gflow::parser::MeshCooker;
+using gflow::parser::ObjParser;
+
+// Square grid of quads in the XY plane, one unit per quad, every quad split into two counter clockwise triangles. The
+// height of each point comes from the callback
+template <typename Height>
+static MeshCooker::Geometry makeGrid(const uint32_t quads, const Height& height)
+{
+    MeshCooker::Geometry geometry{};
+    for (uint32_t y = 0; y <= quads; ++y)
+    {
+        for (uint32_t x = 0; x <= quads; ++x)
+        {
+            const float fx = static_cast<float>(x);
+            const float fy = static_cast<float>(y);
+            geometry.positions.insert(geometry.positions.end(), { fx, fy, height(fx, fy) });
+        }
+    }
+    const auto corner = [quads](const uint32_t x, const uint32_t y) { return MeshCooker::Geometry::Corner{ static_cast<int32_t>(y * (quads + 1) + x) }; };
+    for (uint32_t y = 0; y < quads; ++y)
+    {
+        for (uint32_t x = 0; x < quads; ++x)
+        {
+            geometry.corners.insert(geometry.corners.end(), { corner(x, y), corner(x + 1, y), corner(x + 1, y + 1) });
+            geometry.corners.insert(geometry.corners.end(), { corner(x, y), corner(x + 1, y + 1), corner(x, y + 1) });
+        }
+    }
+    return geometry;
+}
+
+static MeshCooker::Geometry makeFlatGrid(const uint32_t quads)
+{
+    return makeGrid(quads, [](float, float) { return 0.0f; });
+}
+
+// Average cache miss ratio, vertex shader invocations per triangle on a FIFO post transform cache
+static float getAcmr(const std::vector<uint32_t>& indices, const size_t cacheSize)
+{
+    std::deque<uint32_t> cache{};
+    size_t misses = 0;
+    for (const uint32_t index : indices)
+    {
+        if (std::ranges::find(cache, index) != cache.end()) continue;
+        misses++;
+        cache.push_back(index);
+        if (cache.size() > cacheSize)
+            cache.pop_front();
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+// Triangles rotated to start at their lowest index, so the same triangle compares equal in any order with the same
+// winding
+static std::multiset<std::array<uint32_t, 3>> getTriangles(const std::vector<uint32_t>& indices)
+{
+    std::multiset<std::array<uint32_t, 3>> triangles{};
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+        std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+        triangles.insert(triangle);
+    }
+    return triangles;
+}
+
+static double getArea(const MeshCooker::Mesh& mesh, const std::vector<uint32_t>& indices)
+{
+    const uint32_t floatsPerVertex = mesh.vertexStride / sizeof(float);
+    double area = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const float* p0 = &mesh.vertices[static_cast<size_t>(indices[i]) * floatsPerVertex];
+        const float* p1 = &mesh.vertices[static_cast<size_t>(indices[i + 1]) * floatsPerVertex];
+        const float* p2 = &mesh.vertices[static_cast<size_t>(indices[i + 2]) * floatsPerVertex];
+        const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        const double cross[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        area += 0.5 * std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+    }
+    return area;
+}
+
+TEST(meshCookerVertexCache)
+{
+    const MeshCooker::Mesh mesh = MeshCooker::build(makeFlatGrid(32), MeshCooker::POSITION);
+    std::vector<uint32_t> indices = mesh.indices;
+
+    // Triangles in random order, so the optimizer can't just keep a good order it was given
+    std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); ++t)
+        triangles[t] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+    std::ranges::shuffle(triangles, std::mt19937(7));
+    for (size_t t = 0; t < triangles.size(); ++t)
+        std::ranges::copy(triangles[t], indices.begin() + static_cast<ptrdiff_t>(t * 3));
+
+    const float shuffled = getAcmr(indices, 16);
+    MeshCooker::optimizeVertexCache(indices, mesh.getVertexCount());
+    const float optimized = getAcmr(indices, 16);
+
+    // Every vertex of a grid is shared by 6 triangles, so 0.5 is the floor without an infinite cache
+    CHECK(optimized < 1.0f);
+    CHECK(optimized < shuffled * 0.5f);
+    CHECK(getTriangles(indices) == getTriangles(mesh.indices));
+}
+
+TEST(meshCookerSimplifyFlatGrid)
+{
+    const MeshCooker::Mesh mesh = MeshCooker::build(makeFlatGrid(16), MeshCooker::POSITION);
+    const size_t target = mesh.indices.size() / 2;
+
+    float error = -1.0f;
+    const std::vector<uint32_t> simplified = MeshCooker::simplify(mesh, mesh.indices, target, 0.01f * mesh.sphereRadius, error);
+
+    // Interior vertices of a plane collapse for free, the borders never move so the square stays covered exactly once
+    CHECK(simplified.size() <= target);
+    CHECK(error >= 0.0f && error < 1e-4f);
+    CHECK(std::abs(getArea(mesh, simplified) - 16.0 * 16.0) < 1e-3);
+
+    std::set<uint32_t> used(simplified.begin(), simplified.end());
+    const uint32_t floatsPerVertex = mesh.vertexStride / sizeof(float);
+    uint32_t borderVertices = 0;
+    for (uint32_t v = 0; v < mesh.getVertexCount(); ++v)
+    {
+        const float* position = &mesh.vertices[static_cast<size_t>(v) * floatsPerVertex];
+        const bool border = position[0] == 0.0f || position[1] == 0.0f || position[0] == 16.0f || position[1] == 16.0f;
+        if (!border) continue;
+        borderVertices++;
+        CHECK(used.contains(v));
+    }
+    CHECK(borderVertices == 16 * 4);
+}
+
+TEST(meshCookerSimplifyErrorBudget)
+{
+    // Every interior vertex is off the plane of its neighbours, so no collapse is free
+    MeshCooker::Mesh mesh = MeshCooker::build(makeGrid(16, [](const float x, const float y) { return std::sin(x * 0.7f) * std::cos(y * 0.9f); }), MeshCooker::POSITION);
+    const size_t fullSize = mesh.indices.size();
+
+    float error = -1.0f;
+    const std::vector<uint32_t> untouched = MeshCooker::simplify(mesh, mesh.indices, fullSize / 2, 0.0f, error);
+    CHECK(untouched.size() == fullSize);
+    CHECK(error == 0.0f);
+
+    const float budget = 0.05f;
+    const std::vector<uint32_t> coarse = MeshCooker::simplify(mesh, mesh.indices, fullSize / 2, budget * mesh.sphereRadius, error);
+    CHECK(coarse.size() < fullSize);
+    CHECK(error > 0.0f && error <= budget * mesh.sphereRadius);
+
+    // A budget that allows nothing adds no level
+    MeshCooker::buildLods(mesh, { 0.0f });
+    CHECK(mesh.lods.size() == 1);
+}
+
+TEST(meshCookerLodChain)
+{
+    MeshCooker::Mesh mesh = MeshCooker::build(makeFlatGrid(16), MeshCooker::POSITION);
+    const uint32_t fullCount = mesh.lods.front().indexCount;
+    MeshCooker::buildLods(mesh, { 0.01f, 0.01f });
+
+    CHECK(mesh.lods.size() == 3);
+    for (size_t i = 1; i < mesh.lods.size(); ++i)
+    {
+        const MeshCooker::Lod& lod = mesh.lods[i];
+        const MeshCooker::Lod& previous = mesh.lods[i - 1];
+        // Levels follow each other in the index buffer and each one drops at least a tenth of the triangles
+        CHECK(lod.firstIndex == previous.firstIndex + previous.indexCount);
+        CHECK(lod.indexCount * 10 <= previous.indexCount * 9);
+        CHECK(lod.error >= previous.error);
+    }
+    CHECK(mesh.indices.size() == static_cast<size_t>(mesh.lods.back().firstIndex) + mesh.lods.back().indexCount);
+    CHECK(fullCount == 16 * 16 * 6);
+    CHECK(std::ranges::all_of(mesh.indices, [&mesh](const uint32_t index) { return index < mesh.getVertexCount(); }));
+}
+
+TEST(meshCookerCancel)
+{
+    // Two chunks, each one longer than the interval its progress is reported and checked at
+    std::string obj{};
+    while (obj.size() < (1 << 21))
+        obj += "v 0.5 0.25 1.0\nv 1.0 0.5 0.25\nv 0.25 1.0 0.5\nf -3 -2 -1\n";
+
+    MeshCooker::Progress progress{};
+    CHECK(ObjParser::parse(obj.data(), obj.size(), 4, &progress).corners.size() > 0);
+    CHECK(progress.processedBytes == obj.size());
+
+    progress.cancelled = true;
+    bool cancelled = false;
+    try
+    {
+        (void)ObjParser::parse(obj.data(), obj.size(), 4, &progress);
+    }
+    catch (const MeshCooker::Cancelled&)
+    {
+        cancelled = true;
+    }
+    CHECK(cancelled);
+    CHECK(progress.processedBytes < obj.size());
+}
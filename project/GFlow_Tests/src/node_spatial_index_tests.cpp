@@ -0,0 +1,45 @@
+#include <vector>
+
+#include "windows/node_spatial_index.hpp"
+#include "tests.hpp"
+
+static std::vector<size_t> query(const NodeSpatialIndex& index, const ImVec2& min, const ImVec2& max)
+{
+    std::vector<size_t> result;
+    index.query(min, max, result);
+    return result;
+}
+
+TEST(nodeSpatialIndexQuery)
+{
+    NodeSpatialIndex index;
+    index.update(1, { 0.0f, 0.0f }, { 100.0f, 50.0f });
+    index.update(2, { 2000.0f, 0.0f }, { 2100.0f, 50.0f });
+    // Spans four cells and must still come back once
+    index.update(3, { -100.0f, -100.0f }, { 100.0f, 100.0f });
+
+    CHECK(query(index, { -50.0f, -50.0f }, { 800.0f, 600.0f }) == std::vector<size_t>({ 1, 3 }));
+    CHECK(query(index, { 1900.0f, -10.0f }, { 2200.0f, 10.0f }) == std::vector<size_t>({ 2 }));
+    // Same cell as node 1 but no overlap
+    CHECK(query(index, { 200.0f, 200.0f }, { 300.0f, 300.0f }).empty());
+}
+
+TEST(nodeSpatialIndexMoveAndRemove)
+{
+    NodeSpatialIndex index;
+    index.update(1, { 0.0f, 0.0f }, { 100.0f, 50.0f });
+    index.update(2, { 10.0f, 10.0f }, { 60.0f, 60.0f });
+
+    // Out of its cells and back within one
+    index.update(1, { 3000.0f, 3000.0f }, { 3100.0f, 3050.0f });
+    CHECK(query(index, { 0.0f, 0.0f }, { 200.0f, 200.0f }) == std::vector<size_t>({ 2 }));
+    CHECK(query(index, { 2900.0f, 2900.0f }, { 3200.0f, 3200.0f }) == std::vector<size_t>({ 1 }));
+    index.update(1, { 3200.0f, 3000.0f }, { 3300.0f, 3050.0f });
+    CHECK(query(index, { 2900.0f, 2900.0f }, { 3100.0f, 3100.0f }).empty());
+
+    index.remove(2);
+    CHECK(!index.contains(2));
+    CHECK(query(index, { 0.0f, 0.0f }, { 200.0f, 200.0f }).empty());
+    index.clear();
+    CHECK(!index.contains(1));
+}
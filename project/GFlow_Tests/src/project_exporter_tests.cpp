@@ -0,0 +1,60 @@
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "context.hpp"
+#include "project_exporter.hpp"
+#include "resource_manager.hpp"
+#include "resources/pipeline.hpp"
+#include "resources/project.hpp"
+#include "resources/renderpass.hpp"
+#include "tests.hpp"
+
+using namespace gflow::parser;
+
+// Exports the project and loads it back the way the runtime does. Loading only parses the file, the environment is
+// never built
+static void roundTrip(Project* project, const std::function<void(const gflow::Project&)>& check)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "gflow_exporter_test.gflow").string();
+    ProjectExporter::exportProject(project, path);
+
+    gflow::Environment& environment = gflow::Context::getEnvironment(gflow::Context::createEnvironment());
+    check(environment.getProject(environment.loadProject(path)));
+    gflow::Context::destroyEnvironment(environment);
+    std::filesystem::remove(path);
+}
+
+TEST(projectExporterVertexCount)
+{
+    RenderPass* renderpass = ResourceManager::createResource<RenderPass>("");
+    renderpass->addSubpass();
+    Pipeline* pipeline = ResourceManager::createResource<Pipeline>("");
+
+    Project* project = ResourceManager::createResource<Project>("");
+    ProjectRenderpass* projectRenderpass = project->addRenderpass();
+    projectRenderpass->setRenderpass(renderpass);
+    ProjectRenderpassSubpass* subpass = projectRenderpass->addSubpass();
+    ProjectRenderpassDrawCall* triangle = subpass->addDrawCall();
+    triangle->setPipeline(pipeline);
+    triangle->setVertexCount(3);
+    // Draw calls without a pipeline are left out of the file
+    subpass->addDrawCall()->setVertexCount(6);
+    ProjectRenderpassDrawCall* cube = subpass->addDrawCall();
+    cube->setPipeline(pipeline);
+    cube->setVertexCount(36);
+
+    roundTrip(project, [](const gflow::Project& loaded)
+    {
+        CHECK(loaded.getPipelines().size() == 1);
+        CHECK(loaded.getRenderpasses().size() == 1);
+        if (loaded.getRenderpasses().size() != 1 || loaded.getRenderpasses()[0].subpasses.size() != 1) return;
+
+        const std::vector<gflow::Project::DrawCall>& drawCalls = loaded.getRenderpasses()[0].subpasses[0].drawCalls;
+        CHECK(drawCalls.size() == 2);
+        if (drawCalls.size() != 2) return;
+        CHECK(drawCalls[0].pipeline == 0 && drawCalls[0].vertexCount == 3);
+        CHECK(drawCalls[1].pipeline == 0 && drawCalls[1].vertexCount == 36);
+    });
+}
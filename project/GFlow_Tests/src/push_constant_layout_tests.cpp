@@ -0,0 +1,88 @@
+#include <cstring>
+#include <vector>
+
+#include "push_constant_layout.hpp"
+#include "tests.hpp"
+
+using gflow::parser::PushConstantLayout;
+using gflow::parser::PushConstantPacker;
+
+static const std::vector<PushConstantLayout::Element> c_elements = {
+    { "time", PushConstantLayout::FLOAT },
+    { "color", PushConstantLayout::VEC3 },
+    { "intensity", PushConstantLayout::FLOAT },
+    { "normalMatrix", PushConstantLayout::MAT3 },
+    { "offset", PushConstantLayout::VEC2 },
+};
+
+static bool hasMember(const PushConstantLayout& layout, const char* name, const uint32_t offset, const uint32_t size)
+{
+    const PushConstantLayout::Member* member = layout.findMember(name);
+    return member != nullptr && member->offset == offset && member->size == size;
+}
+
+TEST(pushConstantLayoutStd430)
+{
+    const PushConstantLayout layout = PushConstantLayout::compile(c_elements);
+
+    CHECK(hasMember(layout, "time", 0, 4));
+    // Three component vectors align to 16, a scalar fits in the 4 bytes left after one
+    CHECK(hasMember(layout, "color", 16, 12));
+    CHECK(hasMember(layout, "intensity", 28, 4));
+    // Columns of a mat3 are padded to 16 bytes
+    CHECK(hasMember(layout, "normalMatrix", 32, 48));
+    CHECK(layout.findMember("normalMatrix") != nullptr && layout.findMember("normalMatrix")->columnStride == 16);
+    CHECK(hasMember(layout, "offset", 80, 8));
+    CHECK(layout.getSize() == 88);
+    CHECK(layout.getPackedInputSize() == (1 + 3 + 1 + 9 + 2) * 4);
+    CHECK(layout.validate(PushConstantLayout::c_guaranteedMaxSize).isValid());
+}
+
+TEST(pushConstantLayoutScalar)
+{
+    const PushConstantLayout layout = PushConstantLayout::compile(c_elements, PushConstantLayout::Rules::SCALAR);
+
+    CHECK(hasMember(layout, "color", 4, 12));
+    CHECK(hasMember(layout, "intensity", 16, 4));
+    CHECK(hasMember(layout, "normalMatrix", 20, 36));
+    CHECK(hasMember(layout, "offset", 56, 8));
+    CHECK(layout.getSize() == 64);
+}
+
+TEST(pushConstantLayoutValidation)
+{
+    const PushConstantLayout layout = PushConstantLayout::compile(c_elements);
+
+    CHECK(!layout.validate(64).isValid());
+    // The shader reads intensity where scalar packing would put it, and never reads offset
+    const PushConstantLayout::Validation validation = layout.validate(128, {
+        { "time", 0, 4 }, { "color", 16, 12 }, { "intensity", 16, 4 }, { "normalMatrix", 32, 48 },
+    });
+    CHECK(validation.errors.size() == 1);
+    CHECK(validation.warnings.size() == 1);
+}
+
+TEST(pushConstantPackerPadding)
+{
+    const PushConstantLayout layout = PushConstantLayout::compile(c_elements);
+    PushConstantPacker packer(layout);
+    CHECK(packer.size() == layout.getSize());
+
+    std::vector<float> values(layout.getPackedInputSize() / sizeof(float));
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<float>(i + 1);
+    packer.pack(values.data());
+
+    const auto at = [&packer](const uint32_t offset)
+    {
+        float value;
+        std::memcpy(&value, packer.data() + offset, sizeof(float));
+        return value;
+    };
+    CHECK(at(0) == 1.0f);
+    CHECK(at(16) == 2.0f && at(24) == 4.0f);
+    CHECK(at(28) == 5.0f);
+    // Each column of the matrix starts on its own 16 bytes
+    CHECK(at(32) == 6.0f && at(48) == 9.0f && at(64) == 12.0f && at(72) == 14.0f);
+    CHECK(at(80) == 15.0f && at(84) == 16.0f);
+}
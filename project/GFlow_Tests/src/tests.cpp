@@ -0,0 +1,50 @@
+#include "tests.hpp"
+
+#include <cstdio>
+#include <exception>
+
+bool Tests::add(const char* name, const Function function)
+{
+    getTests().push_back({ name, function });
+    return true;
+}
+
+void Tests::check(const bool passed, const char* expression, const char* file, const int line)
+{
+    if (passed) return;
+    s_failedChecks++;
+    std::printf("    %s:%d: CHECK(%s) failed\n", file, line, expression);
+}
+
+uint32_t Tests::run(const std::string& filter)
+{
+    uint32_t ran = 0;
+    uint32_t failed = 0;
+    for (const Test& test : getTests())
+    {
+        if (std::string(test.name).find(filter) == std::string::npos) continue;
+
+        std::printf("%s\n", test.name);
+        const uint32_t checksBefore = s_failedChecks;
+        try
+        {
+            test.function();
+        }
+        catch (const std::exception& e)
+        {
+            s_failedChecks++;
+            std::printf("    threw: %s\n", e.what());
+        }
+        ran++;
+        if (s_failedChecks != checksBefore)
+            failed++;
+    }
+    std::printf("%u of %u tests passed\n", ran - failed, ran);
+    return failed;
+}
+
+std::vector<Tests::Test>& Tests::getTests()
+{
+    static std::vector<Test> tests{};
+    return tests;
+}
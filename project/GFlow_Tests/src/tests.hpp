@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Every TEST registers itself before main runs. A failed CHECK is reported and the test goes on, so a single run lists
+// every broken expectation
+class Tests
+{
+public:
+    using Function = void(*)();
+
+    static bool add(const char* name, Function function);
+    static void check(bool passed, const char* expression, const char* file, int line);
+
+    // Runs the tests whose name contains the filter, returns how many of them failed
+    static uint32_t run(const std::string& filter = "");
+
+private:
+    struct Test
+    {
+        const char* name = nullptr;
+        Function function = nullptr;
+    };
+
+    static std::vector<Test>& getTests();
+    static inline uint32_t s_failedChecks = 0;
+};
+
+#define TEST(name)                                                      \
+    static void name();                                                 \
+    static const bool name##Registered = Tests::add(#name, name);       \
+    static void name()
+
+#define CHECK(expression) Tests::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)